@@ -0,0 +1,71 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "event_bench/benchmark_results.h"
+
+#include <stdio.h>
+
+#include <thread>
+#include <utility>
+
+#include "cr_base/json/json_writer.h"
+#include "cr_base/time/time.h"
+
+namespace event_bench {
+
+BenchmarkResults::BenchmarkResults()
+    : benchmarks_(cr::Value::Type::LIST) {}
+
+BenchmarkResults::~BenchmarkResults() = default;
+
+void BenchmarkResults::Add(const std::string& name,
+                           std::initializer_list<Metric> metrics) {
+  cr::Value metric_values(cr::Value::Type::LIST);
+  std::string line = name + ":";
+  const char* separator = " ";
+  for (const Metric& metric : metrics) {
+    cr::Value metric_value(cr::Value::Type::DICTIONARY);
+    metric_value.SetStringKey("name", metric.name);
+    metric_value.SetDoubleKey("value", metric.value);
+    metric_value.SetStringKey("unit", metric.unit);
+    metric_values.Append(std::move(metric_value));
+
+    char formatted_value[32];
+    snprintf(formatted_value, sizeof(formatted_value), " %.1f ",
+             metric.value);
+    line.append(separator).append(metric.name).append(formatted_value);
+    line.append(metric.unit);
+    separator = ", ";
+  }
+  printf("%s\n", line.c_str());
+  fflush(stdout);
+
+  cr::Value benchmark(cr::Value::Type::DICTIONARY);
+  benchmark.SetStringKey("name", name);
+  benchmark.SetKey("metrics", std::move(metric_values));
+  benchmarks_.Append(std::move(benchmark));
+}
+
+std::string BenchmarkResults::ToJSON() const {
+  cr::Value context(cr::Value::Type::DICTIONARY);
+  context.SetDoubleKey("timestamp", cr::Time::Now().ToDoubleT());
+  context.SetIntKey("num_cpus",
+                    static_cast<int>(std::thread::hardware_concurrency()));
+#if defined(NDEBUG)
+  context.SetStringKey("build", "release");
+#else
+  context.SetStringKey("build", "debug");
+#endif
+
+  cr::Value root(cr::Value::Type::DICTIONARY);
+  root.SetKey("context", std::move(context));
+  root.SetKey("benchmarks", benchmarks_.Clone());
+
+  std::string json;
+  cr::JSONWriter::WriteWithOptions(root, cr::JSONWriter::OPTIONS_PRETTY_PRINT,
+                                   &json);
+  return json;
+}
+
+}  // namespace event_bench
@@ -0,0 +1,45 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MINI_CHROMIUM_APP_EVENT_BENCH_EVENT_BENCH_BENCHMARK_RESULTS_H_
+#define MINI_CHROMIUM_APP_EVENT_BENCH_EVENT_BENCH_BENCHMARK_RESULTS_H_
+
+#include <initializer_list>
+#include <string>
+
+#include "cr_base/values.h"
+
+namespace event_bench {
+
+struct Metric {
+  const char* name;
+  double value;
+  const char* unit;
+};
+
+// Collects the results of the benchmarks, printed as they're added, to write
+// them out as JSON at the end, so that runs can be compared between builds:
+//
+//   {"context": {"timestamp": 1.7e9, "num_cpus": 8, "build": "release"},
+//    "benchmarks": [{"name": "post_task/same_thread",
+//                    "metrics": [{"name": "post", "value": 35.2,
+//                                 "unit": "ns/task"}, ...]}, ...]}
+class BenchmarkResults {
+ public:
+  BenchmarkResults();
+  BenchmarkResults(const BenchmarkResults&) = delete;
+  BenchmarkResults& operator=(const BenchmarkResults&) = delete;
+  ~BenchmarkResults();
+
+  void Add(const std::string& name, std::initializer_list<Metric> metrics);
+
+  std::string ToJSON() const;
+
+ private:
+  cr::Value benchmarks_;
+};
+
+}  // namespace event_bench
+
+#endif  // MINI_CHROMIUM_APP_EVENT_BENCH_EVENT_BENCH_BENCHMARK_RESULTS_H_
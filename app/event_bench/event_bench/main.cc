@@ -0,0 +1,766 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <memory>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "cr_base/logging/logging.h"
+#include "cr_base/at_exit.h"
+#include "cr_base/command_line.h"
+#include "cr_base/files/file_path.h"
+#include "cr_base/files/file_util.h"
+#include "cr_base/functional/bind.h"
+#include "cr_base/functional/bind_state_pool.h"
+#include "cr_base/memory/weak_ptr.h"
+#include "cr_base/strings/stringprintf.h"
+#include "cr_base/synchronization/waitable_event.h"
+#include "cr_base/threading/platform_thread.h"
+#include "cr_base/time/time.h"
+
+#include "cr_event/task/sequence_manager/delayed_task_timing_wheel.h"
+#include "cr_event/task/sequence_manager/enqueue_order_generator.h"
+#include "cr_event/task/sequence_manager/task_tracer.h"
+#include "cr_event/task/sequence_manager/tasks.h"
+#include "cr_event/task/single_thread_task_executor.h"
+#include "cr_event/threading/simple_thread.h"
+#include "cr_event/timer/timer.h"
+#include "cr_event/run_loop.h"
+
+#include "event_bench/benchmark_results.h"
+
+namespace {
+
+using event_bench::BenchmarkResults;
+
+// Writes the results to the given file, as JSON.
+constexpr char kJsonSwitch[] = "json";
+
+// Only runs the benchmarks whose group name contains the given string.
+constexpr char kFilterSwitch[] = "filter";
+
+class ScopedInitLogging {
+ public:
+  ScopedInitLogging() {
+    auto& config = CR_DEFAULT_LOGGING_CONFIG;
+    config.logging_dest = cr::logging::LOG_TO_STDERR;
+    config.verbose_lowest_level = 0;
+
+    cr::logging::InitializeConfig(config);
+  }
+  ~ScopedInitLogging() {
+    cr::logging::UninitializeConfig(CR_DEFAULT_LOGGING_CONFIG);
+  }
+};
+
+double NanosecondsPer(cr::TimeDelta time, size_t count) {
+  return time.InNanoseconds() / static_cast<double>(count);
+}
+
+void NoopTask() {}
+
+// The target of the tasks of several benchmarks, which counts them.
+class CountingTarget {
+ public:
+  void Run() { ++num_tasks_run_; }
+
+  size_t num_tasks_run() const { return num_tasks_run_; }
+
+  cr::WeakPtr<CountingTarget> GetWeakPtr() {
+    return weak_factory_.GetWeakPtr();
+  }
+
+  // Cancels the tasks bound to the WeakPtrs handed out so far.
+  void CancelTasks() { weak_factory_.InvalidateWeakPtrs(); }
+
+ private:
+  size_t num_tasks_run_ = 0;
+  cr::WeakPtrFactory<CountingTarget> weak_factory_{this};
+};
+
+// -----------------------------------------------------------------------------
+// PostTask contention: several threads post no-op tasks to the same task
+// runner, one by one or in batches, which mostly exercises the immediate
+// incoming queue of its TaskQueue.
+
+constexpr size_t kNumPostingThreads[] = {1, 4, 16, 64};
+constexpr size_t kNumTasks = 1 << 20;
+
+// Number of tasks per PostTasks() call of the batched runs.
+constexpr size_t kBatchSize = 64;
+
+struct ContentionState {
+  size_t num_tasks_run = 0;
+  size_t num_tasks = 0;
+  cr::RepeatingClosure quit_closure;
+};
+
+void RunContentionTask(ContentionState* state) {
+  if (++state->num_tasks_run == state->num_tasks)
+    state->quit_closure.Run();
+}
+
+class PostingThread : public cr::SimpleThread {
+ public:
+  PostingThread(cr::RefPtr<cr::SingleThreadTaskRunner> task_runner,
+                cr::WaitableEvent* start_event,
+                size_t num_tasks,
+                size_t batch_size,
+                ContentionState* state)
+      : cr::SimpleThread("PostingThread"),
+        task_runner_(std::move(task_runner)),
+        start_event_(start_event),
+        num_tasks_(num_tasks),
+        batch_size_(batch_size),
+        state_(state) {}
+
+  cr::TimeDelta post_time() const { return post_time_; }
+
+  void Run() override {
+    start_event_->Wait();
+    const cr::TimeTicks begin = cr::TimeTicks::Now();
+    if (batch_size_ == 1) {
+      for (size_t i = 0; i < num_tasks_; ++i) {
+        task_runner_->PostTask(
+            CR_FROM_HERE,
+            cr::BindOnce(&RunContentionTask, cr::Unretained(state_)));
+      }
+    } else {
+      for (size_t i = 0; i < num_tasks_; i += batch_size_) {
+        std::vector<cr::OnceClosure> tasks;
+        tasks.reserve(batch_size_);
+        for (size_t j = i; j < num_tasks_ && j < i + batch_size_; ++j) {
+          tasks.push_back(
+              cr::BindOnce(&RunContentionTask, cr::Unretained(state_)));
+        }
+        task_runner_->PostTasks(CR_FROM_HERE, std::move(tasks));
+      }
+    }
+    post_time_ = cr::TimeTicks::Now() - begin;
+  }
+
+ private:
+  cr::RefPtr<cr::SingleThreadTaskRunner> task_runner_;
+  cr::WaitableEvent* start_event_;
+  const size_t num_tasks_;
+  const size_t batch_size_;
+  ContentionState* state_;
+  cr::TimeDelta post_time_;
+};
+
+void RunPostTaskContentionBenchmark(
+    cr::RefPtr<cr::SingleThreadTaskRunner> task_runner,
+    size_t num_threads,
+    size_t batch_size,
+    BenchmarkResults* results) {
+  const size_t num_tasks_per_thread = kNumTasks / num_threads;
+
+  ContentionState state;
+  state.num_tasks = num_tasks_per_thread * num_threads;
+
+  cr::RunLoop run_loop;
+  state.quit_closure = run_loop.QuitClosure();
+
+  cr::WaitableEvent start_event;
+  std::vector<std::unique_ptr<PostingThread>> threads;
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads.push_back(std::make_unique<PostingThread>(
+        task_runner, &start_event, num_tasks_per_thread, batch_size, &state));
+    threads.back()->Start();
+  }
+
+  const cr::TimeTicks begin = cr::TimeTicks::Now();
+  start_event.Signal();
+  run_loop.Run(CR_FROM_HERE);
+  const cr::TimeDelta total_time = cr::TimeTicks::Now() - begin;
+
+  cr::TimeDelta post_time;
+  for (auto& thread : threads) {
+    thread->Join();
+    post_time += thread->post_time();
+  }
+
+  // |post_time| adds up the time spent by each thread, hence is the average
+  // cost of a PostTask() call as seen by the posting threads.
+  results->Add(cr::StringPrintf("post_task_contention/%zu threads/batch %zu",
+                                num_threads, batch_size),
+               {{"post", NanosecondsPer(post_time, state.num_tasks),
+                 "ns/task"},
+                {"throughput", state.num_tasks / total_time.InSecondsF(),
+                 "tasks/s"}});
+}
+
+// -----------------------------------------------------------------------------
+// Delayed task stores: the heap and the timing wheel a TaskQueue can keep its
+// delayed tasks in, see TaskQueue::DelayedTaskStore, with a growing number of
+// outstanding timers.
+
+constexpr size_t kNumOutstandingTimers[] = {10000, 100000, 1000000, 10000000};
+constexpr size_t kNumSteadyStateTimers = 1 << 20;
+
+// Timeouts like those of network connections, with a short task now and then.
+constexpr int64_t kTimeoutMs = 30000;
+constexpr int64_t kTimeoutJitterMs = 1000;
+constexpr int64_t kShortDelayMs = 10;
+constexpr size_t kShortTaskPeriod = 16;
+
+using cr::sequence_manager::Task;
+using cr::sequence_manager::internal::DelayedTaskTimingWheel;
+using cr::sequence_manager::internal::EnqueueOrderGenerator;
+
+class DelayedTaskFactory {
+ public:
+  Task Create(cr::TimeTicks delayed_run_time) {
+    return Task(cr::sequence_manager::internal::PostedTask(
+                    nullptr, cr::BindOnce(&NoopTask), CR_FROM_HERE),
+                delayed_run_time, enqueue_order_generator_.GenerateNext());
+  }
+
+  cr::TimeDelta RandomDelay(int64_t max_ms) {
+    return cr::TimeDelta::FromMicroseconds(random_() % (max_ms * 1000));
+  }
+
+ private:
+  EnqueueOrderGenerator enqueue_order_generator_;
+  std::mt19937_64 random_;
+};
+
+// Measures, per task:
+// - pushing |num_timers| timers, due within the timeout, posted at once,
+// - popping them all,
+// - popping the earliest timer and posting a new one, with |num_timers|
+//   outstanding timers, as time goes by.
+template <typename DelayedTaskStore>
+void RunDelayedTaskStoreBenchmark(const char* name,
+                                  size_t num_timers,
+                                  BenchmarkResults* results) {
+  DelayedTaskFactory factory;
+  DelayedTaskStore store;
+  cr::TimeTicks now = cr::TimeTicks::Now();
+
+  std::vector<Task> tasks;
+  tasks.reserve(num_timers);
+  for (size_t i = 0; i < num_timers; ++i)
+    tasks.push_back(factory.Create(now + factory.RandomDelay(kTimeoutMs)));
+
+  cr::TimeTicks begin = cr::TimeTicks::Now();
+  for (Task& task : tasks)
+    store.push(std::move(task));
+  const cr::TimeDelta push_time = cr::TimeTicks::Now() - begin;
+  tasks.clear();
+
+  begin = cr::TimeTicks::Now();
+  while (!store.empty())
+    store.pop();
+  const cr::TimeDelta pop_time = cr::TimeTicks::Now() - begin;
+
+  // Spread the timers over the timeout, as if posted over time.
+  const cr::TimeDelta post_interval =
+      cr::TimeDelta::FromMilliseconds(kTimeoutMs) / num_timers;
+  const cr::TimeDelta timeout = cr::TimeDelta::FromMilliseconds(kTimeoutMs);
+  for (size_t i = 0; i < num_timers; ++i) {
+    now += post_interval;
+    store.push(
+        factory.Create(now + timeout + factory.RandomDelay(kTimeoutJitterMs)));
+  }
+
+  begin = cr::TimeTicks::Now();
+  for (size_t i = 0; i < kNumSteadyStateTimers; ++i) {
+    now = store.top().delayed_run_time;
+    store.pop();
+    const cr::TimeDelta delay =
+        i % kShortTaskPeriod ? timeout + factory.RandomDelay(kTimeoutJitterMs)
+                             : factory.RandomDelay(kShortDelayMs);
+    store.push(factory.Create(now + delay));
+  }
+  const cr::TimeDelta steady_state_time = cr::TimeTicks::Now() - begin;
+
+  results->Add(
+      cr::StringPrintf("delayed_task_store/%s/%zu timers", name, num_timers),
+      {{"push", NanosecondsPer(push_time, num_timers), "ns/task"},
+       {"pop", NanosecondsPer(pop_time, num_timers), "ns/task"},
+       {"steady_state_pop_push",
+        NanosecondsPer(steady_state_time, kNumSteadyStateTimers),
+        "ns/task"}});
+}
+
+// -----------------------------------------------------------------------------
+// Task tracing: the cost of TaskTracer for tasks which chain themselves, i.e.
+// post and run one task at a time.
+
+constexpr size_t kNumChainedTasks = 1 << 20;
+
+struct ChainState {
+  cr::RefPtr<cr::SingleThreadTaskRunner> task_runner;
+  size_t num_tasks_left = 0;
+  cr::OnceClosure quit_closure;
+};
+
+void RunChainedTask(ChainState* state) {
+  if (!--state->num_tasks_left) {
+    std::move(state->quit_closure).Run();
+    return;
+  }
+  state->task_runner->PostTask(
+      CR_FROM_HERE, cr::BindOnce(&RunChainedTask, cr::Unretained(state)));
+}
+
+cr::TimeDelta RunChainedTasks(
+    cr::RefPtr<cr::SingleThreadTaskRunner> task_runner) {
+  cr::RunLoop run_loop;
+  ChainState state;
+  state.task_runner = std::move(task_runner);
+  state.num_tasks_left = kNumChainedTasks;
+  state.quit_closure = run_loop.QuitClosure();
+
+  const cr::TimeTicks begin = cr::TimeTicks::Now();
+  state.task_runner->PostTask(
+      CR_FROM_HERE, cr::BindOnce(&RunChainedTask, cr::Unretained(&state)));
+  run_loop.Run(CR_FROM_HERE);
+  return cr::TimeTicks::Now() - begin;
+}
+
+void RunTaskTracingBenchmark(
+    cr::RefPtr<cr::SingleThreadTaskRunner> task_runner,
+    BenchmarkResults* results) {
+  using cr::sequence_manager::TaskTracer;
+
+  const cr::TimeDelta untraced_time = RunChainedTasks(task_runner);
+
+  TaskTracer::GetInstance()->Start();
+  const cr::TimeDelta traced_time = RunChainedTasks(task_runner);
+  TaskTracer::GetInstance()->Stop();
+
+  std::string json;
+  const cr::TimeTicks begin = cr::TimeTicks::Now();
+  TaskTracer::GetInstance()->WriteJSON(&json);
+  const cr::TimeDelta write_time = cr::TimeTicks::Now() - begin;
+
+  results->Add(
+      "task_tracing",
+      {{"untraced", NanosecondsPer(untraced_time, kNumChainedTasks),
+        "ns/task"},
+       {"traced", NanosecondsPer(traced_time, kNumChainedTasks), "ns/task"},
+       {"overhead", (traced_time / untraced_time - 1) * 100, "%"},
+       {"json_size", static_cast<double>(json.size()), "bytes"},
+       {"json_write", write_time.InMillisecondsF(), "ms"}});
+}
+
+
+// -----------------------------------------------------------------------------
+// Same-thread PostTask: posting tasks to the current thread, then running
+// them, and posting each task from the previous one.
+
+constexpr size_t kNumSameThreadTasks = 1 << 20;
+
+void RunSameThreadPostTaskBenchmark(
+    cr::RefPtr<cr::SingleThreadTaskRunner> task_runner,
+    BenchmarkResults* results) {
+  CountingTarget target;
+  const cr::TimeTicks begin = cr::TimeTicks::Now();
+  for (size_t i = 0; i < kNumSameThreadTasks; ++i) {
+    task_runner->PostTask(
+        CR_FROM_HERE,
+        cr::BindOnce(&CountingTarget::Run, cr::Unretained(&target)));
+  }
+  const cr::TimeTicks posted = cr::TimeTicks::Now();
+  cr::RunLoop().RunUntilIdle();
+  const cr::TimeTicks end = cr::TimeTicks::Now();
+  CR_CHECK(target.num_tasks_run() == kNumSameThreadTasks);
+
+  results->Add(
+      "post_task/same_thread",
+      {{"post", NanosecondsPer(posted - begin, kNumSameThreadTasks),
+        "ns/task"},
+       {"run", NanosecondsPer(end - posted, kNumSameThreadTasks), "ns/task"},
+       {"throughput", kNumSameThreadTasks / (end - begin).InSecondsF(),
+        "tasks/s"}});
+
+  const cr::TimeDelta chained_time = RunChainedTasks(task_runner);
+  results->Add("post_task/chained",
+               {{"post_and_run",
+                 NanosecondsPer(chained_time, kNumChainedTasks), "ns/task"}});
+}
+
+// -----------------------------------------------------------------------------
+// Cross-thread PostTask latency: from the PostTask() call on another thread to
+// the task starting on the main thread, which is otherwise idle.
+
+constexpr size_t kNumLatencySamples = 1 << 14;
+
+// Each producer posts at this interval times the number of producers, for the
+// main thread to get 20000 tasks/s whatever their number: the latency measured
+// is that of a post, not that of a backlog.
+constexpr int64_t kLatencyPostIntervalUs = 50;
+
+struct LatencyState {
+  std::vector<cr::TimeDelta> latencies;
+  size_t num_samples = 0;
+  cr::RepeatingClosure quit_closure;
+};
+
+void RecordLatency(LatencyState* state, cr::TimeTicks post_time) {
+  state->latencies.push_back(cr::TimeTicks::Now() - post_time);
+  if (state->latencies.size() == state->num_samples)
+    state->quit_closure.Run();
+}
+
+class LatencyProducerThread : public cr::SimpleThread {
+ public:
+  LatencyProducerThread(cr::RefPtr<cr::SingleThreadTaskRunner> task_runner,
+                        cr::WaitableEvent* start_event,
+                        size_t num_tasks,
+                        cr::TimeDelta post_interval,
+                        LatencyState* state)
+      : cr::SimpleThread("LatencyProducerThread"),
+        task_runner_(std::move(task_runner)),
+        start_event_(start_event),
+        num_tasks_(num_tasks),
+        post_interval_(post_interval),
+        state_(state) {}
+
+  void Run() override {
+    start_event_->Wait();
+    cr::TimeTicks next_post_time = cr::TimeTicks::Now();
+    for (size_t i = 0; i < num_tasks_; ++i) {
+      while (cr::TimeTicks::Now() < next_post_time)
+        cr::PlatformThread::YieldCurrentThread();
+      task_runner_->PostTask(CR_FROM_HERE,
+                             cr::BindOnce(&RecordLatency,
+                                          cr::Unretained(state_),
+                                          cr::TimeTicks::Now()));
+      next_post_time += post_interval_;
+    }
+  }
+
+ private:
+  cr::RefPtr<cr::SingleThreadTaskRunner> task_runner_;
+  cr::WaitableEvent* start_event_;
+  const size_t num_tasks_;
+  const cr::TimeDelta post_interval_;
+  LatencyState* state_;
+};
+
+// |latencies| must be sorted.
+double GetPercentileUs(const std::vector<cr::TimeDelta>& latencies,
+                       double fraction) {
+  const size_t index = std::min(
+      static_cast<size_t>(fraction * latencies.size()), latencies.size() - 1);
+  return latencies[index].InMicrosecondsF();
+}
+
+void RunPostLatencyBenchmark(
+    cr::RefPtr<cr::SingleThreadTaskRunner> task_runner,
+    size_t num_threads,
+    BenchmarkResults* results) {
+  const size_t num_tasks_per_thread = kNumLatencySamples / num_threads;
+
+  LatencyState state;
+  state.num_samples = num_tasks_per_thread * num_threads;
+  state.latencies.reserve(state.num_samples);
+
+  cr::RunLoop run_loop;
+  state.quit_closure = run_loop.QuitClosure();
+
+  cr::WaitableEvent start_event;
+  std::vector<std::unique_ptr<LatencyProducerThread>> threads;
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads.push_back(std::make_unique<LatencyProducerThread>(
+        task_runner, &start_event, num_tasks_per_thread,
+        cr::TimeDelta::FromMicroseconds(kLatencyPostIntervalUs) * num_threads,
+        &state));
+    threads.back()->Start();
+  }
+
+  start_event.Signal();
+  run_loop.Run(CR_FROM_HERE);
+  for (auto& thread : threads)
+    thread->Join();
+
+  std::sort(state.latencies.begin(), state.latencies.end());
+  results->Add(
+      cr::StringPrintf("post_latency/%zu producers", num_threads),
+      {{"p50", GetPercentileUs(state.latencies, 0.5), "us"},
+       {"p99", GetPercentileUs(state.latencies, 0.99), "us"},
+       {"max", state.latencies.back().InMicrosecondsF(), "us"}});
+}
+
+// -----------------------------------------------------------------------------
+// Delayed tasks: posting them, running them once due, and dropping them once
+// due if canceled, through the TaskQueue of the main thread.
+
+constexpr size_t kNumDelayedTasks = 1 << 18;
+constexpr int64_t kMaxDelayUs = 1000;
+
+cr::TimeDelta PostDelayedTasks(
+    const cr::RefPtr<cr::SingleThreadTaskRunner>& task_runner,
+    const std::vector<cr::TimeDelta>& delays,
+    CountingTarget* target) {
+  const cr::TimeTicks begin = cr::TimeTicks::Now();
+  for (cr::TimeDelta delay : delays) {
+    task_runner->PostDelayedTask(
+        CR_FROM_HERE,
+        cr::BindOnce(&CountingTarget::Run, target->GetWeakPtr()), delay);
+  }
+  return cr::TimeTicks::Now() - begin;
+}
+
+// Runs the delayed tasks posted, once all of them are due, so that only the
+// cost of running them is measured, not the wait.
+cr::TimeDelta RunDueDelayedTasks() {
+  cr::PlatformThread::Sleep(cr::TimeDelta::FromMicroseconds(kMaxDelayUs * 2));
+  const cr::TimeTicks begin = cr::TimeTicks::Now();
+  cr::RunLoop().RunUntilIdle();
+  return cr::TimeTicks::Now() - begin;
+}
+
+void RunDelayedTaskBenchmark(
+    cr::RefPtr<cr::SingleThreadTaskRunner> task_runner,
+    BenchmarkResults* results) {
+  std::mt19937_64 random;
+  std::vector<cr::TimeDelta> delays;
+  delays.reserve(kNumDelayedTasks);
+  for (size_t i = 0; i < kNumDelayedTasks; ++i) {
+    delays.push_back(
+        cr::TimeDelta::FromMicroseconds(1 + random() % kMaxDelayUs));
+  }
+
+  CountingTarget target;
+  const cr::TimeDelta post_time =
+      PostDelayedTasks(task_runner, delays, &target);
+  const cr::TimeDelta fire_time = RunDueDelayedTasks();
+  CR_CHECK(target.num_tasks_run() == kNumDelayedTasks);
+
+  CountingTarget canceled_target;
+  PostDelayedTasks(task_runner, delays, &canceled_target);
+  canceled_target.CancelTasks();
+  const cr::TimeDelta drop_time = RunDueDelayedTasks();
+  CR_CHECK(canceled_target.num_tasks_run() == 0);
+
+  results->Add(
+      "delayed_task",
+      {{"post", NanosecondsPer(post_time, kNumDelayedTasks), "ns/task"},
+       {"fire", NanosecondsPer(fire_time, kNumDelayedTasks), "ns/task"},
+       {"drop_canceled", NanosecondsPer(drop_time, kNumDelayedTasks),
+        "ns/task"}});
+}
+
+// -----------------------------------------------------------------------------
+// Timer churn: restarting timers over and over, as done with the timeouts of
+// connections each time they see traffic.
+
+constexpr size_t kNumChurnedTimers[] = {1, 1000, 100000};
+constexpr size_t kNumTimerRestarts = 1 << 20;
+
+// Short for the abandoned tasks to be due, hence dropped, right after.
+constexpr int64_t kTimerDelayUs = 1000;
+
+template <typename Timer, typename StartTimerFunction>
+void RunTimerChurn(const char* name,
+                   size_t num_timers,
+                   StartTimerFunction start_timer,
+                   BenchmarkResults* results) {
+  std::vector<std::unique_ptr<Timer>> timers;
+  for (size_t i = 0; i < num_timers; ++i) {
+    timers.push_back(std::make_unique<Timer>());
+    start_timer(timers.back().get());
+  }
+
+  // Reset() only moves the time the timer is due to later on, without
+  // posting a task, as long as the task posted is due earlier.
+  cr::TimeTicks begin = cr::TimeTicks::Now();
+  for (size_t i = 0; i < kNumTimerRestarts; ++i)
+    timers[i % num_timers]->Reset();
+  const cr::TimeDelta reset_time = cr::TimeTicks::Now() - begin;
+
+  // Stopping the timer and starting it again abandons its task and posts
+  // another one.
+  begin = cr::TimeTicks::Now();
+  for (size_t i = 0; i < kNumTimerRestarts; ++i) {
+    Timer* timer = timers[i % num_timers].get();
+    timer->Stop();
+    start_timer(timer);
+  }
+  const cr::TimeDelta stop_start_time = cr::TimeTicks::Now() - begin;
+
+  timers.clear();
+  const cr::TimeDelta drop_time = RunDueDelayedTasks();
+
+  results->Add(
+      cr::StringPrintf("timer/%s/%zu timers", name, num_timers),
+      {{"reset", NanosecondsPer(reset_time, kNumTimerRestarts), "ns/call"},
+       {"stop_start", NanosecondsPer(stop_start_time, kNumTimerRestarts),
+        "ns/call"},
+       {"drop_abandoned", NanosecondsPer(drop_time, kNumTimerRestarts),
+        "ns/call"}});
+}
+
+void StartOneShotTimer(cr::OneShotTimer* timer) {
+  timer->Start(CR_FROM_HERE, cr::TimeDelta::FromMicroseconds(kTimerDelayUs),
+               cr::BindOnce(&NoopTask));
+}
+
+void StartRepeatingTimer(cr::RepeatingTimer* timer) {
+  timer->Start(CR_FROM_HERE, cr::TimeDelta::FromMicroseconds(kTimerDelayUs),
+               cr::BindRepeating(&NoopTask));
+}
+
+void RunTimerChurnBenchmark(BenchmarkResults* results) {
+  for (size_t num_timers : kNumChurnedTimers) {
+    RunTimerChurn<cr::OneShotTimer>("one_shot", num_timers,
+                                    &StartOneShotTimer, results);
+    RunTimerChurn<cr::RepeatingTimer>("repeating", num_timers,
+                                      &StartRepeatingTimer, results);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// WeakPtr-bound tasks: running them, and dropping them once their WeakPtr is
+// invalidated.
+
+constexpr size_t kNumWeakPtrTasks = 1 << 20;
+
+cr::TimeDelta PostAndRunWeakPtrTasks(
+    const cr::RefPtr<cr::SingleThreadTaskRunner>& task_runner,
+    bool cancel) {
+  CountingTarget target;
+  for (size_t i = 0; i < kNumWeakPtrTasks; ++i) {
+    task_runner->PostTask(
+        CR_FROM_HERE,
+        cr::BindOnce(&CountingTarget::Run, target.GetWeakPtr()));
+  }
+  if (cancel)
+    target.CancelTasks();
+
+  const cr::TimeTicks begin = cr::TimeTicks::Now();
+  cr::RunLoop().RunUntilIdle();
+  const cr::TimeDelta run_time = cr::TimeTicks::Now() - begin;
+  CR_CHECK(target.num_tasks_run() == (cancel ? 0 : kNumWeakPtrTasks));
+  return run_time;
+}
+
+void RunWeakPtrTaskBenchmark(
+    cr::RefPtr<cr::SingleThreadTaskRunner> task_runner,
+    BenchmarkResults* results) {
+  const cr::TimeDelta run_time = PostAndRunWeakPtrTasks(task_runner, false);
+  const cr::TimeDelta drop_time = PostAndRunWeakPtrTasks(task_runner, true);
+  results->Add(
+      "weak_ptr_task",
+      {{"run", NanosecondsPer(run_time, kNumWeakPtrTasks), "ns/task"},
+       {"drop_canceled", NanosecondsPer(drop_time, kNumWeakPtrTasks),
+        "ns/task"}});
+}
+
+// -----------------------------------------------------------------------------
+// RunLoop::RunUntilIdle(): the fixed cost of a call, as paid by tests and by
+// code pumping the loop by hand.
+
+constexpr size_t kNumRunUntilIdleCalls = 1 << 18;
+
+void RunRunUntilIdleBenchmark(
+    cr::RefPtr<cr::SingleThreadTaskRunner> task_runner,
+    BenchmarkResults* results) {
+  cr::TimeTicks begin = cr::TimeTicks::Now();
+  for (size_t i = 0; i < kNumRunUntilIdleCalls; ++i)
+    cr::RunLoop().RunUntilIdle();
+  const cr::TimeDelta empty_time = cr::TimeTicks::Now() - begin;
+
+  begin = cr::TimeTicks::Now();
+  for (size_t i = 0; i < kNumRunUntilIdleCalls; ++i) {
+    task_runner->PostTask(CR_FROM_HERE, cr::BindOnce(&NoopTask));
+    cr::RunLoop().RunUntilIdle();
+  }
+  const cr::TimeDelta one_task_time = cr::TimeTicks::Now() - begin;
+
+  results->Add(
+      "run_until_idle",
+      {{"empty", NanosecondsPer(empty_time, kNumRunUntilIdleCalls),
+        "ns/call"},
+       {"one_task", NanosecondsPer(one_task_time, kNumRunUntilIdleCalls),
+        "ns/call"}});
+}
+
+}  // namespace
+
+// -----------------------------------------------------------------------------
+
+int main(int argc, char* argv[]) {
+  ScopedInitLogging logging;
+
+  cr::AtExitManager at_exit_manager;
+
+  cr::CommandLine::Init(argc, argv);
+  const cr::CommandLine* command_line = cr::CommandLine::ForCurrentProcess();
+  const std::string filter = command_line->GetSwitchValueASCII(kFilterSwitch);
+  auto should_run = [&filter](const char* group) {
+    return filter.empty() ||
+           std::string(group).find(filter) != std::string::npos;
+  };
+
+  cr::SingleThreadTaskExecutor task_executor(cr::MessagePumpType::DEFAULT);
+  BenchmarkResults results;
+
+  if (should_run("post_task"))
+    RunSameThreadPostTaskBenchmark(task_executor.task_runner(), &results);
+
+  if (should_run("post_task_contention")) {
+    for (size_t batch_size : {size_t(1), kBatchSize}) {
+      for (size_t num_threads : kNumPostingThreads) {
+        RunPostTaskContentionBenchmark(task_executor.task_runner(),
+                                       num_threads, batch_size, &results);
+      }
+    }
+  }
+
+  if (should_run("post_latency")) {
+    for (size_t num_threads : kNumPostingThreads) {
+      RunPostLatencyBenchmark(task_executor.task_runner(), num_threads,
+                              &results);
+    }
+  }
+
+  if (should_run("delayed_task_store")) {
+    for (size_t num_timers : kNumOutstandingTimers) {
+      RunDelayedTaskStoreBenchmark<std::priority_queue<Task>>(
+          "heap", num_timers, &results);
+      RunDelayedTaskStoreBenchmark<DelayedTaskTimingWheel>(
+          "timing_wheel", num_timers, &results);
+    }
+  }
+
+  if (should_run("delayed_task"))
+    RunDelayedTaskBenchmark(task_executor.task_runner(), &results);
+
+  if (should_run("timer"))
+    RunTimerChurnBenchmark(&results);
+
+  if (should_run("weak_ptr_task"))
+    RunWeakPtrTaskBenchmark(task_executor.task_runner(), &results);
+
+  if (should_run("run_until_idle"))
+    RunRunUntilIdleBenchmark(task_executor.task_runner(), &results);
+
+  if (should_run("task_tracing"))
+    RunTaskTracingBenchmark(task_executor.task_runner(), &results);
+
+  const cr::BindStatePoolStats stats = cr::GetBindStatePoolStats();
+  results.Add("bind_state_pool",
+              {{"hit_rate", stats.GetHitRate() * 100, "%"},
+               {"remote_frees", static_cast<double>(stats.remote_frees),
+                "frees"}});
+
+  const cr::FilePath json_path = command_line->GetSwitchValuePath(kJsonSwitch);
+  if (!json_path.empty() && !cr::WriteFile(json_path, results.ToJSON())) {
+    CR_LOG(Error) << "Failed to write " << json_path.AsUTF8Unsafe();
+    return 1;
+  }
+
+  return 0;
+}
@@ -20,6 +20,7 @@
 #include "cr_base/logging/logging.h"
 #include "cr_base/memory/weak_ptr.h"
 #include "cr_base/internal/template_util.h"
+#include "cr_base/functional/bind_state_pool.h"
 #include "cr_base/functional/callback_internal.h"
 
 // See cr_base/functional/callback.h for user documentation.
@@ -822,6 +823,38 @@ struct BindState final : BindStateBase {
                          std::forward<ForwardBoundArgs>(bound_args)...);
   }
 
+  // Creates the BindState in the inline storage of a OnceCallback, see
+  // OnceCallbackBase.
+  template <typename ForwardFunctor, typename... ForwardBoundArgs>
+  static void CreateInline(void* storage,
+                           BindStateBase::InvokeFuncStorage invoke_func,
+                           ForwardFunctor&& functor,
+                           ForwardBoundArgs&&... bound_args) {
+    BanUnconstructedRefCountedReceiver<ForwardFunctor>(bound_args...);
+
+    // The class-specific operator new hides the placement one.
+    BindState* bind_state = ::new (storage)
+        BindState(IsCancellable{}, invoke_func,
+                  std::forward<ForwardFunctor>(functor),
+                  std::forward<ForwardBoundArgs>(bound_args)...);
+    bind_state->destructor_ = &DestroyInline;
+  }
+
+  // See OnceCallbackBase::RelocateInlineFunc.
+  static void RelocateInline(BindStateBase* from, void* to) {
+    BindState* bind_state = static_cast<BindState*>(from);
+    if (to)
+      ::new (to) BindState(std::move(*bind_state));
+    // An inline BindState has a single reference, so it's destroyed in place
+    // without the atomic decrement of Release(), which DCHECK builds still go
+    // through for ~RefCountedThreadSafeBase() to find it released.
+#if CR_DCHECK_IS_ON()
+    bind_state->Release();
+#else
+    DestroyInline(bind_state);
+#endif
+  }
+
   Functor functor_;
   std::tuple<BoundArgs...> bound_args_;
 
@@ -829,6 +862,14 @@ struct BindState final : BindStateBase {
   static constexpr bool is_nested_callback =
       MakeFunctorTraits<Functor>::is_callback;
 
+  // Only used to relocate an inline BindState.
+  BindState(BindState&& other)
+      : BindStateBase(other.polymorphic_invoke_,
+                      &DestroyInline,
+                      other.query_cancellation_traits_),
+        functor_(std::move(other.functor_)),
+        bound_args_(std::move(other.bound_args_)) {}
+
   template <typename ForwardFunctor, typename... ForwardBoundArgs>
   explicit BindState(std::true_type,
                      BindStateBase::InvokeFuncStorage invoke_func,
@@ -868,11 +909,34 @@ struct BindState final : BindStateBase {
 
   ~BindState() = default;
 
+  // See bind_state_pool.h.
+  static void* operator new(size_t size) {
+    return BindStatePool::Allocate(size);
+  }
+  static void operator delete(void* ptr) { BindStatePool::Free(ptr); }
+
   static void Destroy(const BindStateBase* self) {
     delete static_cast<const BindState*>(self);
   }
+
+  static void DestroyInline(const BindStateBase* self) {
+    static_cast<const BindState*>(self)->~BindState();
+  }
 };
 
+// Whether a OnceCallback stores a BindStateType inline, see OnceCallbackBase.
+template <typename BindStateType>
+struct IsStoredInline;
+
+template <typename Functor, typename... BoundArgs>
+struct IsStoredInline<BindState<Functor, BoundArgs...>>
+    : bool_constant<
+          sizeof(BindState<Functor, BoundArgs...>) <=
+              OnceCallbackBase::kInlineStorageSize &&
+          alignof(BindState<Functor, BoundArgs...>) <= alignof(void*) &&
+          conjunction<std::is_move_constructible<Functor>,
+                      std::is_move_constructible<BoundArgs>...>::value> {};
+
 // Used to implement MakeBindStateType.
 template <bool is_method, typename Functor, typename... BoundArgs>
 struct MakeBindStateTypeImpl;
@@ -1126,6 +1190,20 @@ template <typename T>
 struct AssertBindArgIsNotBasePassed<PassedWrapper<T>> : public std::false_type {
 };
 
+// Used below in BindImpl to create the BindState of the callback, inline or
+// on the heap.
+template <typename CallbackType, typename BindState, typename... BindStateArgs>
+CallbackType CreateCallback(std::true_type, BindStateArgs&&... args) {
+  return CallbackType(InlineBindState<BindState>(),
+                      std::forward<BindStateArgs>(args)...);
+}
+
+template <typename CallbackType, typename BindState, typename... BindStateArgs>
+CallbackType CreateCallback(std::false_type, BindStateArgs&&... args) {
+  return CallbackType(
+      BindState::Create(std::forward<BindStateArgs>(args)...));
+}
+
 // Used below in BindImpl to determine whether to use Invoker::Run or
 // Invoker::RunOnce.
 // Note: Simply using `kIsOnce ? &Invoker::RunOnce : &Invoker::Run` does not
@@ -1175,10 +1253,15 @@ decltype(auto) BindImpl(Functor&& functor, Args&&... args) {
   PolymorphicInvoke invoke_func = 
       GetInvokeFunc<Invoker>(internal::bool_constant<kIsOnce>());
 
+  // A RepeatingCallback shares its BindState with its copies, hence always
+  // keeps it on the heap.
+  using StoreInline =
+      bool_constant<kIsOnce && IsStoredInline<BindState>::value>;
+
   using InvokeFuncStorage = BindStateBase::InvokeFuncStorage;
-  return CallbackType(BindState::Create(
-      reinterpret_cast<InvokeFuncStorage>(invoke_func),
-      std::forward<Functor>(functor), std::forward<Args>(args)...));
+  return CreateCallback<CallbackType, BindState>(
+      StoreInline(), reinterpret_cast<InvokeFuncStorage>(invoke_func),
+      std::forward<Functor>(functor), std::forward<Args>(args)...);
 }
 
 }  // namespace internal
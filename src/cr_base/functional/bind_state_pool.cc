@@ -0,0 +1,271 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cr_base/functional/bind_state_pool.h"
+
+#include <stddef.h>
+
+#include <atomic>
+#include <new>
+
+#include "cr_base/logging/logging.h"
+#include "cr_base/memory/no_destructor.h"
+#include "cr_base/synchronization/lock.h"
+#include "cr_base/threading/thread_local_storage.h"
+
+namespace cr {
+namespace internal {
+
+namespace {
+
+// Payload sizes of the size classes. BindStates are at least as big as
+// BindStateBase, i.e. four pointers.
+constexpr size_t kSizeClasses[] = {32, 48, 64, 80, 96, 128, 160, 192, 256};
+constexpr size_t kNumSizeClasses = sizeof(kSizeClasses) / sizeof(size_t);
+constexpr size_t kMaxPooledSize = kSizeClasses[kNumSizeClasses - 1];
+
+// Number of free blocks a pool keeps per size class, beyond which freed
+// blocks go back to the heap.
+constexpr size_t kMaxFreeBlocksPerSizeClass = 256;
+
+// Returns the smallest size class holding `size` bytes, which must not be
+// bigger than kMaxPooledSize.
+size_t GetSizeClass(size_t size) {
+  size_t size_class = 0;
+  while (kSizeClasses[size_class] < size)
+    ++size_class;
+  return size_class;
+}
+
+}  // namespace
+
+// The pool of a thread.
+struct BindStatePool::ThreadCache {
+  // Precedes the payload of every block.
+  struct Header {
+    // Null if the block isn't pooled.
+    ThreadCache* owner;
+    size_t size_class;
+  };
+
+  // Keeps payloads aligned like blocks from operator new.
+  static constexpr size_t kHeaderSize =
+      (sizeof(Header) + alignof(std::max_align_t) - 1) /
+      alignof(std::max_align_t) * alignof(std::max_align_t);
+
+  // A free block, overlaid on its payload.
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  static Header* GetHeader(void* payload) {
+    return reinterpret_cast<Header*>(static_cast<char*>(payload) -
+                                     kHeaderSize);
+  }
+
+  static void* GetPayload(Header* header) {
+    return reinterpret_cast<char*>(header) + kHeaderSize;
+  }
+
+  static void Increment(std::atomic<uint64_t>* counter) {
+    // Only the owning thread writes these.
+    counter->store(counter->load(std::memory_order_relaxed) + 1,
+                   std::memory_order_relaxed);
+  }
+
+  // Must be called on the owning thread.
+  void* Allocate(size_t size_class);
+  void Free(void* payload, size_t size_class);
+
+  // Can be called on any thread.
+  void FreeRemote(void* payload, size_t size_class);
+
+  // Accessed by the owning thread only.
+  FreeBlock* free_lists[kNumSizeClasses] = {};
+  size_t free_list_sizes[kNumSizeClasses] = {};
+
+  // Blocks freed by other threads.
+  std::atomic<FreeBlock*> remote_free_lists[kNumSizeClasses] = {};
+
+  std::atomic<uint64_t> pool_hits{0};
+  std::atomic<uint64_t> pool_misses{0};
+  std::atomic<uint64_t> remote_frees{0};
+
+  // Links all the pools ever created, guarded by the registry lock.
+  ThreadCache* next = nullptr;
+  bool orphaned = false;
+};
+
+// Pools are never deleted: blocks freed after their thread exited still go
+// back to them.
+struct BindStatePool::Registry {
+  Lock lock;
+  ThreadCache* all_pools = nullptr;
+  std::atomic<uint64_t> unpooled_allocations{0};
+};
+
+// static
+BindStatePool::Registry& BindStatePool::GetRegistry() {
+  static NoDestructor<Registry> registry;
+  return *registry;
+}
+
+void* BindStatePool::ThreadCache::Allocate(size_t size_class) {
+  FreeBlock* block = free_lists[size_class];
+  if (!block) {
+    // Reclaim the blocks freed by other threads, if any.
+    block = remote_free_lists[size_class].exchange(nullptr,
+                                                   std::memory_order_acquire);
+    size_t num_blocks = 0;
+    for (FreeBlock* iter = block; iter; iter = iter->next)
+      ++num_blocks;
+    free_list_sizes[size_class] = num_blocks;
+  }
+
+  if (block) {
+    free_lists[size_class] = block->next;
+    --free_list_sizes[size_class];
+    Increment(&pool_hits);
+    return block;
+  }
+
+  Increment(&pool_misses);
+  Header* header = static_cast<Header*>(
+      ::operator new(kHeaderSize + kSizeClasses[size_class]));
+  header->owner = this;
+  header->size_class = size_class;
+  return GetPayload(header);
+}
+
+void BindStatePool::ThreadCache::Free(void* payload, size_t size_class) {
+  if (free_list_sizes[size_class] >= kMaxFreeBlocksPerSizeClass) {
+    ::operator delete(GetHeader(payload));
+    return;
+  }
+
+  FreeBlock* block = static_cast<FreeBlock*>(payload);
+  block->next = free_lists[size_class];
+  free_lists[size_class] = block;
+  ++free_list_sizes[size_class];
+}
+
+void BindStatePool::ThreadCache::FreeRemote(void* payload,
+                                            size_t size_class) {
+  FreeBlock* block = static_cast<FreeBlock*>(payload);
+  std::atomic<FreeBlock*>& remote_free_list = remote_free_lists[size_class];
+  block->next = remote_free_list.load(std::memory_order_relaxed);
+  while (!remote_free_list.compare_exchange_weak(block->next, block,
+                                                 std::memory_order_release,
+                                                 std::memory_order_relaxed)) {
+  }
+  remote_frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+// static
+void* BindStatePool::Allocate(size_t size) {
+  ThreadCache* thread_cache =
+      size <= kMaxPooledSize ? GetCurrentThreadCache(true) : nullptr;
+  if (thread_cache)
+    return thread_cache->Allocate(GetSizeClass(size));
+
+  GetRegistry().unpooled_allocations.fetch_add(1, std::memory_order_relaxed);
+  ThreadCache::Header* header = static_cast<ThreadCache::Header*>(
+      ::operator new(ThreadCache::kHeaderSize + size));
+  header->owner = nullptr;
+  header->size_class = kNumSizeClasses;
+  return ThreadCache::GetPayload(header);
+}
+
+// static
+void BindStatePool::Free(void* ptr) {
+  if (!ptr)
+    return;
+
+  ThreadCache::Header* header = ThreadCache::GetHeader(ptr);
+  ThreadCache* owner = header->owner;
+  if (!owner) {
+    ::operator delete(header);
+    return;
+  }
+
+  CR_DCHECK(header->size_class < kNumSizeClasses);
+  if (owner == GetCurrentThreadCache(false))
+    owner->Free(ptr, header->size_class);
+  else
+    owner->FreeRemote(ptr, header->size_class);
+}
+
+// static
+BindStatePool::ThreadCache* BindStatePool::GetCurrentThreadCache(bool create) {
+  static NoDestructor<ThreadLocalStorage::Slot> thread_cache_slot(
+      &BindStatePool::OnThreadExit);
+
+  // BindStates may still be created or destroyed by the TLS destructors of
+  // an exiting thread.
+  if (ThreadLocalStorage::HasBeenDestroyed())
+    return nullptr;
+
+  ThreadCache* thread_cache =
+      static_cast<ThreadCache*>(thread_cache_slot->Get());
+  if (thread_cache || !create)
+    return thread_cache;
+
+  Registry& registry = GetRegistry();
+  {
+    AutoLock lock(registry.lock);
+    for (ThreadCache* pool = registry.all_pools; pool; pool = pool->next) {
+      if (pool->orphaned) {
+        pool->orphaned = false;
+        thread_cache = pool;
+        break;
+      }
+    }
+    if (!thread_cache) {
+      thread_cache = new ThreadCache();
+      thread_cache->next = registry.all_pools;
+      registry.all_pools = thread_cache;
+    }
+  }
+
+  thread_cache_slot->Set(thread_cache);
+  return thread_cache;
+}
+
+// static
+void BindStatePool::OnThreadExit(void* thread_cache) {
+  // Leave the pool, and the blocks it caches, to the next new thread.
+  Registry& registry = GetRegistry();
+  AutoLock lock(registry.lock);
+  static_cast<ThreadCache*>(thread_cache)->orphaned = true;
+}
+
+// static
+BindStatePoolStats BindStatePool::GetStats() {
+  Registry& registry = GetRegistry();
+
+  BindStatePoolStats stats;
+  stats.unpooled_allocations =
+      registry.unpooled_allocations.load(std::memory_order_relaxed);
+
+  AutoLock lock(registry.lock);
+  for (ThreadCache* pool = registry.all_pools; pool; pool = pool->next) {
+    stats.pool_hits += pool->pool_hits.load(std::memory_order_relaxed);
+    stats.pool_misses += pool->pool_misses.load(std::memory_order_relaxed);
+    stats.remote_frees += pool->remote_frees.load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+}  // namespace internal
+
+double BindStatePoolStats::GetHitRate() const {
+  const uint64_t allocations = pool_hits + pool_misses + unpooled_allocations;
+  return allocations ? static_cast<double>(pool_hits) / allocations : 0.0;
+}
+
+BindStatePoolStats GetBindStatePoolStats() {
+  return internal::BindStatePool::GetStats();
+}
+
+}  // namespace cr
@@ -0,0 +1,75 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MINI_CHROMIUM_SRC_CRBASE_FUNCTIONAL_BIND_STATE_POOL_H_
+#define MINI_CHROMIUM_SRC_CRBASE_FUNCTIONAL_BIND_STATE_POOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cr_base/base_export.h"
+
+namespace cr {
+
+// Counters of the BindState allocator, summed over all threads since the
+// process started.
+struct CRBASE_EXPORT BindStatePoolStats {
+  // Allocations served by the pool of the allocating thread.
+  uint64_t pool_hits = 0;
+
+  // Allocations small enough to be pooled which had to go to the heap.
+  uint64_t pool_misses = 0;
+
+  // Allocations too big to be pooled, or made while the allocating thread was
+  // exiting.
+  uint64_t unpooled_allocations = 0;
+
+  // Pooled BindStates freed on another thread than the one which allocated
+  // them, and given back to the allocating thread's pool.
+  uint64_t remote_frees = 0;
+
+  // Fraction of the allocations served by a pool, between 0 and 1.
+  double GetHitRate() const;
+};
+
+CRBASE_EXPORT BindStatePoolStats GetBindStatePoolStats();
+
+namespace internal {
+
+// Allocates the BindStates created by cr::BindOnce() and cr::BindRepeating().
+//
+// Each thread has a pool of free blocks per size class. A BindState is
+// usually created on one thread and destroyed on another, e.g. after being
+// posted as a task. So a block freed on another thread is pushed onto a
+// lock-free list of the allocating thread's pool, which that thread reclaims
+// once its own free list of the block's size class is empty. The pool of an
+// exiting thread is kept, with the blocks it caches, for the next new thread.
+//
+// Blocks are aligned like blocks from operator new. BindStates bigger than the
+// biggest size class are allocated with operator new.
+class CRBASE_EXPORT BindStatePool {
+ public:
+  BindStatePool() = delete;
+
+  static void* Allocate(size_t size);
+  static void Free(void* ptr);
+
+  static BindStatePoolStats GetStats();
+
+ private:
+  struct ThreadCache;
+  struct Registry;
+
+  static Registry& GetRegistry();
+
+  // Returns null if the current thread has no pool yet and `create` is false,
+  // or if thread-local storage is being destroyed.
+  static ThreadCache* GetCurrentThreadCache(bool create);
+  static void OnThreadExit(void* thread_cache);
+};
+
+}  // namespace internal
+}  // namespace cr
+
+#endif  // MINI_CHROMIUM_SRC_CRBASE_FUNCTIONAL_BIND_STATE_POOL_H_
@@ -57,18 +57,25 @@
 namespace cr {
 
 template <typename R, typename... Args>
-class OnceCallback<R(Args...)> : public internal::CallbackBase {
+class OnceCallback<R(Args...)> : public internal::OnceCallbackBase {
  public:
   using ResultType = R;
   using RunType = R(Args...);
   using PolymorphicInvoke = R (*)(internal::BindStateBase*,
                                   internal::PassingType<Args>...);
 
-  constexpr OnceCallback() = default;
+  OnceCallback() = default;
   OnceCallback(std::nullptr_t) = delete;
 
   explicit OnceCallback(internal::BindStateBase* bind_state)
-      : internal::CallbackBase(bind_state) {}
+      : internal::OnceCallbackBase(bind_state) {}
+
+  template <typename BindStateType, typename... BindStateArgs>
+  explicit OnceCallback(internal::InlineBindState<BindStateType>,
+                        BindStateArgs&&... args) {
+    this->template EmplaceInline<BindStateType>(
+        std::forward<BindStateArgs>(args)...);
+  }
 
   OnceCallback(const OnceCallback&) = delete;
   OnceCallback& operator=(const OnceCallback&) = delete;
@@ -77,10 +84,10 @@ class OnceCallback<R(Args...)> : public internal::CallbackBase {
   OnceCallback& operator=(OnceCallback&&) noexcept = default;
 
   OnceCallback(RepeatingCallback<RunType> other)
-      : internal::CallbackBase(std::move(other)) {}
+      : internal::OnceCallbackBase(std::move(other)) {}
 
   OnceCallback& operator=(RepeatingCallback<RunType> other) {
-    static_cast<internal::CallbackBase&>(*this) = std::move(other);
+    static_cast<internal::OnceCallbackBase&>(*this) = std::move(other);
     return *this;
   }
 
@@ -99,7 +106,7 @@ class OnceCallback<R(Args...)> : public internal::CallbackBase {
     OnceCallback cb = std::move(*this);
     PolymorphicInvoke f =
         reinterpret_cast<PolymorphicInvoke>(cb.polymorphic_invoke());
-    return f(cb.bind_state_.get(), std::forward<Args>(args)...);
+    return f(cb.bind_state(), std::forward<Args>(args)...);
   }
 
   // Then() returns a new OnceCallback that receives the same arguments as
@@ -98,5 +98,34 @@ CallbackBaseCopyable& CallbackBaseCopyable::operator=(
 CallbackBaseCopyable& CallbackBaseCopyable::operator=(
     CallbackBaseCopyable&& c) noexcept = default;
 
+OnceCallbackBase& OnceCallbackBase::operator=(
+    CallbackBaseCopyable&& c) noexcept {
+  // See operator=(OnceCallbackBase&&).
+  OnceCallbackBase old(std::move(*this));
+  CallbackBase::operator=(std::move(c));
+  return *this;
+}
+
+bool OnceCallbackBase::IsCancelled() const {
+  CR_DCHECK(!is_null());
+  return bind_state()->IsCancelled();
+}
+
+bool OnceCallbackBase::MaybeValid() const {
+  CR_DCHECK(!is_null());
+  return bind_state()->MaybeValid();
+}
+
+void OnceCallbackBase::Reset() {
+  // Destroying the BindState may delete |this|, see CallbackBase::Reset(), so
+  // move it out of the inline storage first.
+  OnceCallbackBase old(std::move(*this));
+}
+
+OnceCallbackBase::~OnceCallbackBase() {
+  if (relocate_inline_)
+    relocate_inline_(inline_bind_state(), nullptr);
+}
+
 }  // namespace internal
 }  // namespace cr
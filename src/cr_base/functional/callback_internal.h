@@ -9,6 +9,10 @@
 #ifndef MINI_CHROMIUM_SRC_CRBASE_FUNCTIONAL_CALLBACK_INTERNAL_H_
 #define MINI_CHROMIUM_SRC_CRBASE_FUNCTIONAL_CALLBACK_INTERNAL_H_
 
+#include <stddef.h>
+
+#include <utility>
+
 #include "cr_base/base_export.h"
 #include "cr_base/memory/ref_counted.h"
 #include "cr_base/functional/callback_forward.h"
@@ -31,6 +35,7 @@ struct BindState;
 
 class CallbackBase;
 class CallbackBaseCopyable;
+class OnceCallbackBase;
 
 struct BindStateBaseRefCountTraits {
   static void Destruct(const BindStateBase*);
@@ -79,6 +84,7 @@ class CRBASE_EXPORT BindStateBase
 
   friend class CallbackBase;
   friend class CallbackBaseCopyable;
+  friend class OnceCallbackBase;
 
   // Allowlist subclasses that access the destructor of BindStateBase.
   template <typename Functor, typename... BoundArgs>
@@ -189,6 +195,102 @@ class CRBASE_EXPORT CallbackBaseCopyable : public CallbackBase {
   ~CallbackBaseCopyable() = default;
 };
 
+// Tag selecting the OnceCallback constructor which creates a BindStateType in
+// the callback's inline storage.
+template <typename BindStateType>
+struct InlineBindState {};
+
+// OnceCallbackBase is a direct base class of OnceCallbacks. Unlike
+// RepeatingCallbacks, which are copyable hence share their BindState, a
+// OnceCallback owns its BindState: when it's small enough, the BindState lives
+// in |inline_storage_| instead of the heap, which saves an allocation and the
+// atomic reference counting. Such a BindState is relocated by
+// |relocate_inline_| when the callback is moved, and |bind_state_| is null.
+class CRBASE_EXPORT OnceCallbackBase : public CallbackBase {
+ public:
+  // Size of the biggest BindState stored inline: the BindStateBase header plus
+  // four pointers, e.g. a method bound to a WeakPtr, or a function and up to
+  // three pointer-sized arguments.
+  static constexpr size_t kInlineStorageSize =
+      sizeof(BindStateBase) + 4 * sizeof(void*);
+
+  inline OnceCallbackBase(OnceCallbackBase&& c) noexcept;
+  inline OnceCallbackBase& operator=(OnceCallbackBase&& c) noexcept;
+
+  explicit OnceCallbackBase(CallbackBaseCopyable&& c) noexcept
+      : CallbackBase(std::move(c)) {}
+  OnceCallbackBase& operator=(CallbackBaseCopyable&& c) noexcept;
+
+  bool is_null() const { return !bind_state_ && !relocate_inline_; }
+  explicit operator bool() const { return !is_null(); }
+
+  // See CallbackBase.
+  bool IsCancelled() const;
+  bool MaybeValid() const;
+  void Reset();
+
+ protected:
+  // Move-constructs the inline BindState |from| into |to| unless |to| is null,
+  // then destroys |from|.
+  using RelocateInlineFunc = void (*)(BindStateBase* from, void* to);
+
+  OnceCallbackBase() = default;
+  explicit OnceCallbackBase(BindStateBase* bind_state)
+      : CallbackBase(bind_state) {}
+
+  // Creates a BindStateType in the inline storage, see
+  // BindState::CreateInline().
+  template <typename BindStateType, typename... BindStateArgs>
+  void EmplaceInline(BindStateArgs&&... args) {
+    BindStateType::CreateInline(inline_storage_,
+                                std::forward<BindStateArgs>(args)...);
+    relocate_inline_ = &BindStateType::RelocateInline;
+  }
+
+  BindStateBase* bind_state() const {
+    return relocate_inline_ ? inline_bind_state() : bind_state_.get();
+  }
+
+  InvokeFuncStorage polymorphic_invoke() const {
+    return bind_state()->polymorphic_invoke_;
+  }
+
+  ~OnceCallbackBase();
+
+ private:
+  BindStateBase* inline_bind_state() const {
+    return reinterpret_cast<BindStateBase*>(
+        const_cast<char*>(inline_storage_));
+  }
+
+  // Takes the BindState of |c|, which must be reset.
+  void TakeBindState(OnceCallbackBase& c) {
+    bind_state_ = std::move(c.bind_state_);
+    relocate_inline_ = c.relocate_inline_;
+    if (relocate_inline_) {
+      relocate_inline_(c.inline_bind_state(), inline_storage_);
+      c.relocate_inline_ = nullptr;
+    }
+  }
+
+  RelocateInlineFunc relocate_inline_ = nullptr;
+  alignas(void*) char inline_storage_[kInlineStorageSize];
+};
+
+OnceCallbackBase::OnceCallbackBase(OnceCallbackBase&& c) noexcept {
+  TakeBindState(c);
+}
+
+OnceCallbackBase& OnceCallbackBase::operator=(OnceCallbackBase&& c) noexcept {
+  if (this != &c) {
+    // Our BindState may be holding the last ref to whatever object owns |c|,
+    // so destroy it last.
+    OnceCallbackBase old(std::move(*this));
+    TakeBindState(c);
+  }
+  return *this;
+}
+
 // Helpers for the `Then()` implementation.
 template <typename OriginalCallback, typename ThenCallback>
 struct ThenHelper;
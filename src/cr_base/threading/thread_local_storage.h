@@ -26,6 +26,8 @@ class ThreadCheckerImpl;
 
 namespace internal {
 
+class BindStatePool;
+
 // WARNING: You should *NOT* use this class directly.
 // PlatformThreadLocalStorage is a low-level abstraction of the OS's TLS
 // interface. Instead, you should use one of the following:
@@ -142,6 +144,7 @@ class CRBASE_EXPORT ThreadLocalStorage {
   // Slot::Get().
   friend class SequenceCheckerImpl;
   friend class ThreadCheckerImpl;
+  friend class internal::BindStatePool;
   static bool HasBeenDestroyed();
 };
 
@@ -10,19 +10,44 @@
 #include "cr_event/message_pump/message_pump_for_io.h"
 #include "cr_event/message_pump/message_pump_for_ui.h"
 
+#if defined(MINI_CHROMIUM_OS_LINUX)
+#include <sys/prctl.h>
+
+#include "cr_event/message_pump/posix/message_pump_io_uring.h"
+#endif
+
 namespace cr {
 
 namespace {
 
 MessagePump::MessagePumpFactory* message_pump_for_ui_factory_ = nullptr;
 
+#if defined(MINI_CHROMIUM_OS_LINUX)
+// Timer slack of the threads which ask for TIMER_SLACK_MAXIMUM. The kernel
+// lets a thread's timers expire that late, to expire them together with
+// other timers.
+constexpr unsigned long kMaximumTimerSlackNs = 8 * 1000 * 1000;
+#endif
+
 }  // namespace
 
 MessagePump::MessagePump() = default;
 
 MessagePump::~MessagePump() = default;
 
-void MessagePump::SetTimerSlack(TimerSlack) {
+void MessagePump::SetTimerSlack(TimerSlack timer_slack) {
+#if defined(MINI_CHROMIUM_OS_LINUX)
+  // The slack applies to the calling thread, which runs this pump. Zero
+  // restores the default slack of the thread.
+  const unsigned long slack_ns =
+      timer_slack == TIMER_SLACK_MAXIMUM ? kMaximumTimerSlackNs : 0;
+  if (prctl(PR_SET_TIMERSLACK, slack_ns, 0, 0, 0) != 0)
+    CR_DPLOG(Warning) << "prctl(PR_SET_TIMERSLACK)";
+#endif  // defined(MINI_CHROMIUM_OS_LINUX)
+}
+
+bool MessagePump::GetMetrics(MessagePumpMetrics*) const {
+  return false;
 }
 
 // static
@@ -47,6 +72,13 @@ std::unique_ptr<MessagePump> MessagePump::Create(MessagePumpType type) {
     case MessagePumpType::IO:
       return std::make_unique<MessagePumpForIO>();
 
+#if defined(MINI_CHROMIUM_OS_LINUX)
+    case MessagePumpType::IO_URING:
+      if (auto pump = MessagePumpIOUring::TryCreate())
+        return pump;
+      return std::make_unique<MessagePumpForIO>();
+#endif  // defined(MINI_CHROMIUM_OS_LINUX)
+
 #if defined(MINI_CHROMIUM_OS_WIN)
     case MessagePumpType::UI_WITH_WM_QUIT_SUPPORT: {
       auto pump = std::make_unique<MessagePumpForUI>();
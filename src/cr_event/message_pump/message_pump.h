@@ -16,6 +16,7 @@
 #include "cr_base/threading/sequence/sequence_checker.h"
 
 #include "cr_event/event_export.h"
+#include "cr_event/message_pump/message_pump_metrics.h"
 #include "cr_event/message_pump/message_pump_type.h"
 #include "cr_event/message_pump/timer_slack.h"
 
@@ -225,6 +226,11 @@ class CREVENT_EXPORT MessagePump {
 
   // Sets the timer slack to the specified value.
   virtual void SetTimerSlack(TimerSlack timer_slack);
+
+  // Fills |metrics| with what the pump's thread has been doing so far and
+  // returns true, or returns false if this pump doesn't keep track of it.
+  // Thread-safe.
+  virtual bool GetMetrics(MessagePumpMetrics* metrics) const;
 };
 
 }  // namespace cr
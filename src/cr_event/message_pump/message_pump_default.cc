@@ -5,25 +5,56 @@
 
 #include "cr_event/message_pump/message_pump_default.h"
 
+#include <algorithm>
+
 #include "cr_base/compiler_config.h"
 
 #include "cr_base/logging/logging.h"
 #include "cr_base/auto_reset.h"
 
+#if defined(MINI_CHROMIUM_OS_LINUX)
+#include <errno.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 namespace cr {
 
+#if defined(MINI_CHROMIUM_OS_LINUX)
+namespace {
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+              "std::atomic<uint32_t> must be usable as a futex word");
+
+uint32_t* AsFutex(std::atomic<uint32_t>* word) {
+  return reinterpret_cast<uint32_t*>(word);
+}
+
+}  // namespace
+#endif
+
+#if defined(MINI_CHROMIUM_OS_LINUX)
+MessagePumpDefault::MessagePumpDefault() : keep_running_(true) {}
+#else
 MessagePumpDefault::MessagePumpDefault()
     : keep_running_(true),
       event_(WaitableEvent::ResetPolicy::AUTOMATIC,
              WaitableEvent::InitialState::NOT_SIGNALED) {
 }
+#endif
 
 MessagePumpDefault::~MessagePumpDefault() = default;
 
+void MessagePumpDefault::SetSpinBudget(TimeDelta spin_budget) {
+  wake_state_.set_spin_budget(spin_budget);
+}
+
 void MessagePumpDefault::Run(Delegate* delegate) {
   AutoReset<bool> auto_reset_keep_running(&keep_running_, true);
 
   for (;;) {
+    wake_state_.OnWakeUp();
     Delegate::NextWorkInfo next_work_info = delegate->DoWork();
     bool has_more_immediate_work = next_work_info.is_immediate();
     if (!keep_running_)
@@ -39,24 +70,84 @@ void MessagePumpDefault::Run(Delegate* delegate) {
     if (has_more_immediate_work)
       continue;
 
-    if (next_work_info.delayed_run_time.is_max()) {
-      event_.Wait();
-    } else {
-      event_.TimedWait(next_work_info.remaining_delay());
+    if (wake_state_.Spin(next_work_info.delayed_run_time))
+      continue;
+
+    // Don't sleep if ScheduleWork() was called since DoWork() and skipped
+    // waking us up.
+    if (!wake_state_.BeforeSleep())
+      continue;
+
+    WaitForWork(next_work_info);
+  }
+}
+
+#if defined(MINI_CHROMIUM_OS_LINUX)
+
+void MessagePumpDefault::WaitForWork(
+    const Delegate::NextWorkInfo& next_work_info) {
+  // Without FUTEX_CLOCK_REALTIME, FUTEX_WAIT_BITSET takes an absolute
+  // CLOCK_MONOTONIC deadline, the clock TimeTicks is based on.
+  struct timespec deadline;
+  const struct timespec* deadline_ptr = nullptr;
+  if (!next_work_info.delayed_run_time.is_max()) {
+    deadline = (next_work_info.delayed_run_time - TimeTicks()).ToTimeSpec();
+    deadline_ptr = &deadline;
+  }
+
+  while (futex_word_.exchange(0, std::memory_order_acquire) == 0) {
+    // Returns right away with EAGAIN if WakeUp() set the word since.
+    const long rv =
+        syscall(SYS_futex, AsFutex(&futex_word_),
+                FUTEX_WAIT_BITSET | FUTEX_PRIVATE_FLAG, 0, deadline_ptr,
+                nullptr, FUTEX_BITSET_MATCH_ANY);
+    if (rv != 0) {
+      if (errno == ETIMEDOUT)
+        return;
+      CR_DPCHECK(errno == EAGAIN || errno == EINTR);
     }
-    // Since event_ is auto-reset, we don't need to do anything special here
-    // other than service each delegate method.
   }
 }
 
+void MessagePumpDefault::WakeUp() {
+  if (futex_word_.exchange(1, std::memory_order_release) != 0)
+    return;  // Already woken up.
+  syscall(SYS_futex, AsFutex(&futex_word_), FUTEX_WAKE | FUTEX_PRIVATE_FLAG, 1,
+          nullptr, nullptr, 0);
+}
+
+#else  // defined(MINI_CHROMIUM_OS_LINUX)
+
+void MessagePumpDefault::WaitForWork(
+    const Delegate::NextWorkInfo& next_work_info) {
+  if (next_work_info.delayed_run_time.is_max()) {
+    event_.Wait();
+  } else if (wake_state_.spin_budget().is_zero()) {
+    event_.TimedWait(next_work_info.remaining_delay());
+  } else {
+    // Spin() used up some of the delay.
+    event_.TimedWait(std::max(
+        next_work_info.delayed_run_time - TimeTicks::Now(), TimeDelta()));
+  }
+  // Since event_ is auto-reset, we don't need to do anything special here
+  // other than service each delegate method.
+}
+
+void MessagePumpDefault::WakeUp() {
+  event_.Signal();
+}
+
+#endif  // defined(MINI_CHROMIUM_OS_LINUX)
+
 void MessagePumpDefault::Quit() {
   keep_running_ = false;
 }
 
 void MessagePumpDefault::ScheduleWork() {
   // Since this can be called on any thread, we need to ensure that our Run
-  // loop wakes up.
-  event_.Signal();
+  // loop wakes up, unless it's awake and will notice the work anyway.
+  if (wake_state_.OnScheduleWork())
+    WakeUp();
 }
 
 void MessagePumpDefault::ScheduleDelayedWork(
@@ -68,4 +159,11 @@ void MessagePumpDefault::ScheduleDelayedWork(
   // this way (bit.ly/merge-message-pump-do-work).
 }
 
+bool MessagePumpDefault::GetMetrics(MessagePumpMetrics* metrics) const {
+  *metrics = MessagePumpMetrics();
+  metrics->sample_time = TimeTicks::Now();
+  metrics->avoided_wake_ups = wake_state_.avoided_wake_ups();
+  return true;
+}
+
 }  // namespace cr
@@ -8,14 +8,27 @@
 
 #include "cr_base/compiler_config.h"
 
+#if defined(MINI_CHROMIUM_OS_LINUX)
+#include <stdint.h>
+
+#include <atomic>
+#endif
+
 #include "cr_base/time/time.h"
 #include "cr_base/synchronization/waitable_event.h"
 
 #include "cr_event/event_export.h"
 #include "cr_event/message_pump/message_pump.h"
+#include "cr_event/message_pump/message_pump_wake_state.h"
 
 namespace cr {
 
+// The pump of threads which only run tasks. It sleeps on a WaitableEvent,
+// except on Linux where it parks on a single futex word instead: waking it up
+// is then one FUTEX_WAKE, without the mutex and condition variable handoff of
+// the POSIX WaitableEvent, and timed waits sleep until an absolute
+// CLOCK_MONOTONIC deadline (FUTEX_WAIT_BITSET), which doesn't need to be
+// recomputed when a wait is interrupted.
 class CREVENT_EXPORT MessagePumpDefault : public MessagePump {
  public:
   MessagePumpDefault(const MessagePumpDefault&) = delete;
@@ -24,18 +37,43 @@ class CREVENT_EXPORT MessagePumpDefault : public MessagePump {
   MessagePumpDefault();
   ~MessagePumpDefault() override;
 
+  // When out of work, busy-polls for up to `spin_budget` before sleeping, so
+  // that work scheduled from another thread meanwhile runs without waking the
+  // thread up. Zero (the default) disables spinning. Must be called on the
+  // pump's thread. See MessagePumpWakeState.
+  void SetSpinBudget(TimeDelta spin_budget);
+
   // MessagePump methods:
   void Run(Delegate* delegate) override;
   void Quit() override;
   void ScheduleWork() override;
   void ScheduleDelayedWork(const TimeTicks& delayed_work_time) override;
+  // Only reports the ScheduleWork() calls which didn't need to signal the
+  // pump's thread because it was awake; the other counters stay 0.
+  bool GetMetrics(MessagePumpMetrics* metrics) const override;
 
  private:
+  // Sleeps until WakeUp() is called or `next_work_info.delayed_run_time` is
+  // reached. Like an auto-reset event, a WakeUp() call which happened before
+  // the wait ends it right away.
+  void WaitForWork(const Delegate::NextWorkInfo& next_work_info);
+  void WakeUp();
+
   // This flag is set to false when Run should return.
   bool keep_running_;
 
+#if defined(MINI_CHROMIUM_OS_LINUX)
+  // 1 if WakeUp() was called since the last wait ended, 0 otherwise. The
+  // pump's thread sleeps on it while it is 0.
+  std::atomic<uint32_t> futex_word_{0};
+#else
   // Used to sleep until there is more work to do.
   WaitableEvent event_;
+#endif
+
+  // Tracks whether the thread sleeps in WaitForWork(), and spins for a while
+  // before it does.
+  MessagePumpWakeState wake_state_;
 };
 
 }  // namespace cr
@@ -0,0 +1,93 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cr_event/message_pump/message_pump_metrics.h"
+
+namespace cr {
+
+namespace {
+
+uint64_t ToMicroseconds(TimeDelta duration) {
+  if (duration <= TimeDelta())
+    return 0;
+  return static_cast<uint64_t>(duration.InMicroseconds());
+}
+
+TimeDelta FromMicroseconds(const std::atomic<uint64_t>& us) {
+  return TimeDelta::FromMicroseconds(
+      static_cast<int64_t>(us.load(std::memory_order_relaxed)));
+}
+
+}  // namespace
+
+double MessagePumpMetrics::NativeEventsPerWakeUpSince(
+    const MessagePumpMetrics& previous) const {
+  const uint64_t wake_ups_delta = wake_ups - previous.wake_ups;
+  if (wake_ups_delta == 0)
+    return 0.0;
+  return static_cast<double>(native_events - previous.native_events) /
+         static_cast<double>(wake_ups_delta);
+}
+
+double MessagePumpMetrics::WakeUpsPerSecondSince(
+    const MessagePumpMetrics& previous) const {
+  const double seconds = (sample_time - previous.sample_time).InSecondsF();
+  if (seconds <= 0.0)
+    return 0.0;
+  return static_cast<double>(wake_ups - previous.wake_ups) / seconds;
+}
+
+double MessagePumpMetrics::BlockedFractionSince(
+    const MessagePumpMetrics& previous) const {
+  const TimeDelta interval = sample_time - previous.sample_time;
+  if (interval <= TimeDelta())
+    return 0.0;
+  return (time_blocked - previous.time_blocked) / interval;
+}
+
+MessagePumpMetricsRecorder::MessagePumpMetricsRecorder() = default;
+
+MessagePumpMetricsRecorder::~MessagePumpMetricsRecorder() = default;
+
+void MessagePumpMetricsRecorder::RecordWakeUp(TimeDelta time_blocked,
+                                              bool spurious) {
+  Add(wake_ups_, 1);
+  if (spurious)
+    Add(spurious_wake_ups_, 1);
+  Add(blocked_us_, ToMicroseconds(time_blocked));
+}
+
+void MessagePumpMetricsRecorder::RecordNativeEvent(TimeDelta duration) {
+  Add(native_events_, 1);
+  Add(native_events_us_, ToMicroseconds(duration));
+}
+
+void MessagePumpMetricsRecorder::RecordTasks(TimeDelta duration) {
+  Add(tasks_us_, ToMicroseconds(duration));
+}
+
+void MessagePumpMetricsRecorder::SetWatchedFds(size_t watched_fds) {
+  watched_fds_.store(watched_fds, std::memory_order_relaxed);
+}
+
+TimeDelta MessagePumpMetricsRecorder::time_in_native_events() const {
+  return FromMicroseconds(native_events_us_);
+}
+
+MessagePumpMetrics MessagePumpMetricsRecorder::GetSnapshot(
+    uint64_t avoided_wake_ups) const {
+  MessagePumpMetrics metrics;
+  metrics.sample_time = TimeTicks::Now();
+  metrics.wake_ups = wake_ups_.load(std::memory_order_relaxed);
+  metrics.spurious_wake_ups = spurious_wake_ups_.load(std::memory_order_relaxed);
+  metrics.avoided_wake_ups = avoided_wake_ups;
+  metrics.native_events = native_events_.load(std::memory_order_relaxed);
+  metrics.time_blocked = FromMicroseconds(blocked_us_);
+  metrics.time_in_native_events = FromMicroseconds(native_events_us_);
+  metrics.time_in_tasks = FromMicroseconds(tasks_us_);
+  metrics.watched_fds = watched_fds_.load(std::memory_order_relaxed);
+  return metrics;
+}
+
+}  // namespace cr
@@ -0,0 +1,112 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MINI_CHROMIUM_SRC_CREVENT_MESSAGE_PUMP_MESSAGE_PUMP_METRICS_H_
+#define MINI_CHROMIUM_SRC_CREVENT_MESSAGE_PUMP_MESSAGE_PUMP_METRICS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+#include "cr_base/functional/callback.h"
+#include "cr_base/time/time.h"
+
+#include "cr_event/event_export.h"
+
+namespace cr {
+
+// A snapshot of what a MessagePump's thread has been doing since the pump was
+// created. Counters only grow, so rates over an interval are computed from two
+// snapshots, e.g.:
+//
+//   MessagePumpMetrics previous = ...;
+//   MessagePumpMetrics current = ...;
+//   double wakeups_per_second = current.WakeUpsPerSecondSince(previous);
+struct CREVENT_EXPORT MessagePumpMetrics {
+  // When the snapshot was taken.
+  TimeTicks sample_time;
+
+  // Number of returns from a blocking wait, whatever ended it.
+  uint64_t wake_ups = 0;
+
+  // Number of wake-ups which ended before their timeout without any watcher
+  // callback to run nor ScheduleWork() call to serve, e.g. EINTR or events
+  // for a descriptor no active watch is interested in.
+  uint64_t spurious_wake_ups = 0;
+
+  // Number of ScheduleWork() calls which didn't need to wake the thread up.
+  uint64_t avoided_wake_ups = 0;
+
+  // Number of watcher callbacks run, i.e. native events dispatched.
+  uint64_t native_events = 0;
+
+  // Time spent in blocking waits, in watcher callbacks and in
+  // Delegate::DoWork() respectively.
+  TimeDelta time_blocked;
+  TimeDelta time_in_native_events;
+  TimeDelta time_in_tasks;
+
+  // Number of descriptors currently watched.
+  size_t watched_fds = 0;
+
+  // Averages over the interval between `previous` and this snapshot. 0 if
+  // the interval is empty.
+  double NativeEventsPerWakeUpSince(const MessagePumpMetrics& previous) const;
+  double WakeUpsPerSecondSince(const MessagePumpMetrics& previous) const;
+  // Fraction of the interval spent blocked in the kernel.
+  double BlockedFractionSince(const MessagePumpMetrics& previous) const;
+};
+
+// Receives the MessagePumpMetrics sampled periodically, see
+// SequenceManager::SetMessagePumpMetricsCallback().
+using MessagePumpMetricsCallback =
+    RepeatingCallback<void(const MessagePumpMetrics& metrics)>;
+
+// Collects MessagePumpMetrics for a pump. The Record*() methods must all be
+// called on the pump's thread; they only use relaxed loads and stores, so
+// that keeping the counters up to date costs next to nothing. GetSnapshot()
+// can be called on any thread, and may see counters updated by a concurrent
+// Record*() call and not the others.
+class CREVENT_EXPORT MessagePumpMetricsRecorder {
+ public:
+  MessagePumpMetricsRecorder();
+  MessagePumpMetricsRecorder(const MessagePumpMetricsRecorder&) = delete;
+  MessagePumpMetricsRecorder& operator=(const MessagePumpMetricsRecorder&) =
+      delete;
+  ~MessagePumpMetricsRecorder();
+
+  void RecordWakeUp(TimeDelta time_blocked, bool spurious);
+  void RecordNativeEvent(TimeDelta duration);
+  void RecordTasks(TimeDelta duration);
+  void SetWatchedFds(size_t watched_fds);
+
+  // Totals so far, for the pump's thread to compute deltas.
+  uint64_t native_events() const {
+    return native_events_.load(std::memory_order_relaxed);
+  }
+  TimeDelta time_in_native_events() const;
+
+  // `avoided_wake_ups` is tracked by the pump's MessagePumpWakeState.
+  MessagePumpMetrics GetSnapshot(uint64_t avoided_wake_ups) const;
+
+ private:
+  // Single writer: a read-modify-write isn't needed to stay consistent.
+  static void Add(std::atomic<uint64_t>& counter, uint64_t value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value,
+                  std::memory_order_relaxed);
+  }
+
+  std::atomic<uint64_t> wake_ups_{0};
+  std::atomic<uint64_t> spurious_wake_ups_{0};
+  std::atomic<uint64_t> native_events_{0};
+  std::atomic<uint64_t> blocked_us_{0};
+  std::atomic<uint64_t> native_events_us_{0};
+  std::atomic<uint64_t> tasks_us_{0};
+  std::atomic<size_t> watched_fds_{0};
+};
+
+}  // namespace cr
+
+#endif  // MINI_CHROMIUM_SRC_CREVENT_MESSAGE_PUMP_MESSAGE_PUMP_METRICS_H_
@@ -27,6 +27,13 @@ enum class MessagePumpType {
   // This type of pump also supports asynchronous IO.
   IO,
 
+#if defined(MINI_CHROMIUM_OS_LINUX)
+  // This type of pump supports asynchronous IO like IO, but waits through
+  // io_uring rather than epoll. Falls back to an IO pump when the kernel
+  // doesn't support io_uring. A thread running this pump is an IO thread.
+  IO_URING,
+#endif  // defined(MINI_CHROMIUM_OS_LINUX)
+
 #if defined(MINI_CHROMIUM_OS_WIN)
   // This type of pump supports WM_QUIT messages in addition to other native
   // UI events. This is only for use on windows.
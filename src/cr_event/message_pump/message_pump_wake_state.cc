@@ -0,0 +1,93 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cr_event/message_pump/message_pump_wake_state.h"
+
+#include <algorithm>
+
+#include "cr_base/compiler_config.h"
+
+#if defined(MINI_CHROMIUM_COMPILER_MSVC)
+#include <intrin.h>
+#endif
+
+namespace cr {
+
+namespace {
+
+// Reading the clock costs much more than polling `state_`, so Spin() only
+// checks whether its budget is spent every so many polls.
+constexpr int kPollsPerClockRead = 64;
+
+// Tells the CPU that this is a spin-wait loop, which saves power and frees
+// execution resources for a sibling hyper-thread.
+inline void CpuRelax() {
+#if defined(MINI_CHROMIUM_ARCH_CPU_X86_FAMILY)
+#if defined(MINI_CHROMIUM_COMPILER_MSVC)
+  _mm_pause();
+#else
+  __builtin_ia32_pause();
+#endif
+#elif defined(MINI_CHROMIUM_ARCH_CPU_ARM_FAMILY)
+#if defined(MINI_CHROMIUM_COMPILER_MSVC)
+  __yield();
+#else
+  __asm__ __volatile__("yield");
+#endif
+#endif
+}
+
+}  // namespace
+
+MessagePumpWakeState::MessagePumpWakeState() = default;
+
+MessagePumpWakeState::~MessagePumpWakeState() = default;
+
+void MessagePumpWakeState::OnWakeUp() {
+  // Clear kSleepingFlag and kWorkScheduledFlag. The thread is about to look
+  // for work, which will find whatever was scheduled so far. The exchange is
+  // skipped in the common case where there's nothing to clear; a stale read
+  // just makes BeforeSleep() fail once.
+  if (state_.load(std::memory_order_relaxed) != 0)
+    state_.exchange(0, std::memory_order_acq_rel);
+}
+
+bool MessagePumpWakeState::Spin(TimeTicks deadline) {
+  if (spin_budget_.is_zero())
+    return false;
+  const TimeTicks now = TimeTicks::Now();
+  if (deadline <= now)
+    return false;
+  const TimeTicks spin_end = std::min(deadline, now + spin_budget_);
+
+  // The thread is still marked as awake, so OnScheduleWork() only sets
+  // kWorkScheduledFlag, which is what this polls for.
+  for (int polls = 1;; ++polls) {
+    if (state_.load(std::memory_order_acquire) & kWorkScheduledFlag)
+      return true;
+    if (polls % kPollsPerClockRead == 0 && TimeTicks::Now() >= spin_end)
+      return false;
+    CpuRelax();
+  }
+}
+
+bool MessagePumpWakeState::BeforeSleep() {
+  uint32_t expected = 0;
+  return state_.compare_exchange_strong(expected, kSleepingFlag,
+                                        std::memory_order_acq_rel);
+}
+
+bool MessagePumpWakeState::OnScheduleWork() {
+  // Either the thread is awake, and will see kWorkScheduledFlag in
+  // BeforeSleep() at the latest, or it is parked and this is the first call
+  // since it parked, which must wake it up.
+  const uint32_t previous_state =
+      state_.fetch_or(kWorkScheduledFlag, std::memory_order_acq_rel);
+  if (previous_state == kSleepingFlag)
+    return true;
+  avoided_wake_ups_.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+}  // namespace cr
@@ -0,0 +1,98 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MINI_CHROMIUM_SRC_CREVENT_MESSAGE_PUMP_MESSAGE_PUMP_WAKE_STATE_H_
+#define MINI_CHROMIUM_SRC_CREVENT_MESSAGE_PUMP_MESSAGE_PUMP_WAKE_STATE_H_
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include "cr_base/time/time.h"
+
+#include "cr_event/event_export.h"
+
+namespace cr {
+
+// Tracks whether a MessagePump's thread is parked in the kernel, so that
+// ScheduleWork() only pays for a wake-up syscall (eventfd write, event signal)
+// when it's actually needed. This is the pump-level counterpart of
+// sequence_manager::internal::WorkDeduplicator: the latter filters out
+// ScheduleWork() calls made while a DoWork() is pending or running, this
+// filters out the remaining ones made while the thread is awake anyway, e.g.
+// dispatching native events, in DoIdleWork() or in between.
+//
+// It also lets the pump busy-poll for a short while before parking when it
+// runs out of work, so that work scheduled from another thread within that
+// window is picked up without a wake-up and context switch. This trades CPU
+// time for latency, so it's disabled unless a spin budget is set.
+//
+// Usage, in the pump's Run() loop and ScheduleWork() respectively:
+//
+//   for (;;) {
+//     wake_state_.OnWakeUp();
+//     DoWork();
+//     ...
+//     if (wake_state_.Spin(delayed_run_time))
+//       continue;  // Work was scheduled while spinning.
+//     if (!wake_state_.BeforeSleep())
+//       continue;  // Work was scheduled since OnWakeUp().
+//     WaitForWork();
+//   }
+//
+//   if (wake_state_.OnScheduleWork())
+//     WakeUp();
+class CREVENT_EXPORT MessagePumpWakeState {
+ public:
+  MessagePumpWakeState();
+  MessagePumpWakeState(const MessagePumpWakeState&) = delete;
+  MessagePumpWakeState& operator=(const MessagePumpWakeState&) = delete;
+  ~MessagePumpWakeState();
+
+  // Sets the longest time Spin() busy-polls for. Zero disables spinning. Must
+  // be called on the pump's thread.
+  void set_spin_budget(TimeDelta spin_budget) { spin_budget_ = spin_budget; }
+  TimeDelta spin_budget() const { return spin_budget_; }
+
+  // Must be called by the pump's thread before it looks for work, and after
+  // returning from a wait.
+  void OnWakeUp();
+
+  // Busy-polls until OnScheduleWork() is called, the spin budget is spent or
+  // `deadline` is reached. Returns true in the first case. Must be called on
+  // the pump's thread.
+  bool Spin(TimeTicks deadline);
+
+  // Marks the pump's thread as parked. Returns false, and leaves the thread
+  // marked as awake, if OnScheduleWork() was called since OnWakeUp(), in which
+  // case the pump must look for work again rather than wait. Must be called on
+  // the pump's thread.
+  bool BeforeSleep();
+
+  // Returns true if the pump's thread is parked and must be woken up to notice
+  // new work, false if it will see it without help. Can be called on any
+  // thread.
+  bool OnScheduleWork();
+
+  // Number of OnScheduleWork() calls which returned false, i.e. wake-up
+  // syscalls saved. Can be called on any thread.
+  uint64_t avoided_wake_ups() const {
+    return avoided_wake_ups_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  enum : uint32_t {
+    kSleepingFlag = 1 << 0,
+    kWorkScheduledFlag = 1 << 1,
+  };
+
+  std::atomic<uint32_t> state_{0};
+  std::atomic<uint64_t> avoided_wake_ups_{0};
+
+  TimeDelta spin_budget_;
+};
+
+}  // namespace cr
+
+#endif  // MINI_CHROMIUM_SRC_CREVENT_MESSAGE_PUMP_MESSAGE_PUMP_WAKE_STATE_H_
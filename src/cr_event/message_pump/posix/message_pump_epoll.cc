@@ -5,9 +5,13 @@
 #include "cr_event/message_pump/posix/message_pump_epoll.h"
 
 #include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <sys/timerfd.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <optional>
 #include <utility>
 
@@ -35,7 +39,10 @@ namespace {
 
 // Caches the state of the "BatchNativeEventsInMessagePumpEpoll".
 std::atomic_bool g_use_batched_version(false);
-std::atomic_bool g_use_poll(false);
+
+// Set once epoll_pwait2() (Linux 5.11) has been found to be unavailable, after
+// which high resolution waits arm a timerfd instead.
+std::atomic_bool g_epoll_pwait2_unsupported(false);
 
 constexpr std::pair<uint32_t, short int> kEpollToPollEvents[] = {
     {EPOLLIN, POLLIN},   {EPOLLOUT, POLLOUT}, {EPOLLRDHUP, POLLRDHUP},
@@ -66,9 +73,18 @@ struct MessagePumpEpoll::InterestParams {
   // must be automatically deactivated every time it triggers an epoll event.
   bool one_shot;
 
+  // Indicates that the interest only wants to be notified of readiness
+  // transitions. See WATCH_EDGE_TRIGGERED.
+  bool edge_triggered;
+
+  // Indicates that the interest may share events with other epoll instances
+  // watching `fd`. See WATCH_EXCLUSIVE.
+  bool exclusive;
+
   bool IsEqual(const InterestParams& rhs) const {
-    return std::tie(fd, read, write, one_shot) ==
-           std::tie(rhs.fd, rhs.read, rhs.write, rhs.one_shot);
+    return std::tie(fd, read, write, one_shot, edge_triggered, exclusive) ==
+           std::tie(rhs.fd, rhs.read, rhs.write, rhs.one_shot,
+                    rhs.edge_triggered, rhs.exclusive);
   }
 };
 
@@ -147,6 +163,9 @@ MessagePumpEpoll::MessagePumpEpoll() {
   poll_entry.events = POLLIN;
   poll_entry.revents = 0;
   pollfds_.push_back(poll_entry);
+  poll_entries_.push_back(nullptr);
+
+  event_buffer_.resize(max_event_batch_size_);
 
   next_metrics_time_ = cr::TimeTicks::Now() + cr::TimeDelta::FromMinutes(1);
 }
@@ -158,16 +177,17 @@ void MessagePumpEpoll::InitializeFeatures() {
   ///g_use_batched_version.store(
   ///    base::FeatureList::IsEnabled(kBatchNativeEventsInMessagePumpEpoll),
   ///    std::memory_order_relaxed);
-  ///g_use_poll.store(base::FeatureList::IsEnabled(kUsePollForMessagePumpEpoll),
-  ///                 std::memory_order_relaxed);
 }
 
 bool MessagePumpEpoll::WatchFileDescriptor(int fd,
                                            bool persistent,
                                            int mode,
                                            FdWatchController* controller,
-                                           FdWatcher* watcher) {
+                                           FdWatcher* watcher,
+                                           int flags) {
   CR_DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  // The kernel rejects EPOLLEXCLUSIVE combined with EPOLLONESHOT.
+  CR_DCHECK(persistent || !(flags & WATCH_EXCLUSIVE));
   ///TRACE_EVENT("base", "MessagePumpEpoll::WatchFileDescriptor", "fd", fd,
   ///            "persistent", persistent, "watch_read", mode & WATCH_READ,
   ///            "watch_write", mode & WATCH_WRITE);
@@ -177,6 +197,8 @@ bool MessagePumpEpoll::WatchFileDescriptor(int fd,
       .read = (mode == WATCH_READ || mode == WATCH_READ_WRITE),
       .write = (mode == WATCH_WRITE || mode == WATCH_READ_WRITE),
       .one_shot = !persistent,
+      .edge_triggered = (flags & WATCH_EDGE_TRIGGERED) != 0,
+      .exclusive = (flags & WATCH_EXCLUSIVE) != 0,
   };
 
   auto pair = entries_.emplace(fd, fd);
@@ -216,8 +238,12 @@ void MessagePumpEpoll::Run(Delegate* delegate) {
   RunState run_state(delegate);
   AutoReset<RunState*> auto_reset_run_state(&run_state_, &run_state);
   for (;;) {
+    wake_state_.OnWakeUp();
+
     // Do some work and see if the next task is ready right away.
+    const TimeTicks work_start = TimeTicks::Now();
     Delegate::NextWorkInfo next_work_info = delegate->DoWork();
+    metrics_.RecordTasks(TimeTicks::Now() - work_start);
     const bool immediate_work_available = next_work_info.is_immediate();
     if (run_state.should_quit) {
       break;
@@ -232,19 +258,28 @@ void MessagePumpEpoll::Run(Delegate* delegate) {
 
     // Process any immediately ready IO event, but don't sleep yet.
     // Process epoll events until none is available without blocking or
-    // the maximum number of iterations is reached. The maximum number of
-    // iterations when `g_use_batched_version` is true was chosen so that
-    // all available events are dispatched 95% of the time in local tests.
-    // The maximum is not infinite because we want to yield to application
-    // tasks at some point.
+    // `native_work_budget_` events have been dispatched. The budget is not
+    // infinite because we want to yield to application tasks at some point;
+    // events left over are still ready on the next iteration. The budget when
+    // `g_use_batched_version` is true was chosen so that all available events
+    // are dispatched 95% of the time in local tests.
     bool did_native_work = false;
-    const int max_iterations =
-        g_use_batched_version.load(std::memory_order_relaxed) ? 16 : 1;
-    for (int i = 0; i < max_iterations; ++i) {
-      if (!WaitForEpollEvents(TimeDelta())) {
+    size_t native_work_budget =
+        g_use_batched_version.load(std::memory_order_relaxed)
+            ? native_work_budget_ * 16
+            : native_work_budget_;
+    while (native_work_budget > 0) {
+      const size_t max_events = std::min(
+          {native_work_budget, event_batch_size_, GetMaxEventsPerWait()});
+      const size_t num_events = WaitForEpollEvents(TimeDelta(), max_events);
+      if (num_events > 0) {
+        did_native_work = true;
+      }
+      if (num_events < max_events) {
+        // Nothing else is ready right now.
         break;
       }
-      did_native_work = true;
+      native_work_budget -= num_events;
     }
 
     bool attempt_more_work = immediate_work_available || did_native_work;
@@ -261,12 +296,20 @@ void MessagePumpEpoll::Run(Delegate* delegate) {
       break;
     }
 
-    TimeDelta next_metrics_delay =
-        next_metrics_time_ - next_work_info.recent_now;
+    if (wake_state_.Spin(next_work_info.delayed_run_time)) {
+      // Work was scheduled while spinning.
+      continue;
+    }
+    // Spin() may have used up some of the delay.
+    const TimeTicks now = wake_state_.spin_budget().is_zero()
+                              ? next_work_info.recent_now
+                              : TimeTicks::Now();
+
+    TimeDelta next_metrics_delay = next_metrics_time_ - now;
     TimeDelta timeout = TimeDelta::Max();
     CR_DCHECK(!next_work_info.delayed_run_time.is_null());
     if (!next_work_info.delayed_run_time.is_max()) {
-      timeout = next_work_info.remaining_delay();
+      timeout = std::max(next_work_info.delayed_run_time - now, TimeDelta());
     }
     if (timeout > next_metrics_delay) {
       timeout = next_metrics_delay;
@@ -277,18 +320,49 @@ void MessagePumpEpoll::Run(Delegate* delegate) {
         timeout = cr::TimeDelta::FromMilliseconds(0);
       }
     }
+    if (!wake_state_.BeforeSleep()) {
+      // ScheduleWork() was called since DoWork() and skipped waking us up.
+      continue;
+    }
     delegate->BeforeWait();
-    WaitForEpollEvents(timeout);
+    WaitForWork(timeout);
     if (run_state.should_quit) {
       break;
     }
   }
 }
 
+void MessagePumpEpoll::WaitForWork(TimeDelta timeout) {
+  metrics_.SetWatchedFds(entries_.size());
+  woken_up_ = false;
+  const uint64_t native_events_before = metrics_.native_events();
+  const TimeDelta time_in_native_events_before =
+      metrics_.time_in_native_events();
+  const TimeTicks wait_start = TimeTicks::Now();
+
+  WaitForEpollEvents(timeout, event_batch_size_);
+
+  // The events of this wait were dispatched before returning: leave the time
+  // spent in their callbacks out of the time blocked.
+  const TimeDelta wait_duration = TimeTicks::Now() - wait_start;
+  const TimeDelta time_blocked =
+      wait_duration -
+      (metrics_.time_in_native_events() - time_in_native_events_before);
+  const bool spurious = metrics_.native_events() == native_events_before &&
+                        !woken_up_ && wait_duration < timeout;
+  metrics_.RecordWakeUp(time_blocked, spurious);
+}
+
 void MessagePumpEpoll::RecordPeriodicMetrics() {
   ///UMA_HISTOGRAM_COUNTS_1000("MessagePumpEpoll.WatchedFileDescriptors",
   ///                          (int)entries_.size());
-  ///next_metrics_time_ += cr::Minutes(1);
+  metrics_.SetWatchedFds(entries_.size());
+  next_metrics_time_ += cr::TimeDelta::FromMinutes(1);
+}
+
+bool MessagePumpEpoll::GetMetrics(MessagePumpMetrics* metrics) const {
+  *metrics = metrics_.GetSnapshot(wake_state_.avoided_wake_ups());
+  return true;
 }
 
 void MessagePumpEpoll::Quit() {
@@ -298,6 +372,12 @@ void MessagePumpEpoll::Quit() {
 }
 
 void MessagePumpEpoll::ScheduleWork() {
+  if (!wake_state_.OnScheduleWork()) {
+    // The pump's thread isn't waiting for events and will notice the work by
+    // itself.
+    return;
+  }
+
   const uint64_t value = 1;
   ssize_t n = HANDLE_EINTR(write(wake_event_.get(), &value, sizeof(value)));
 
@@ -338,15 +418,8 @@ void MessagePumpEpoll::AddEpollEvent(EpollEventEntry& entry) {
 ///  }
 ///#endif
   CR_DPCHECK(rv == 0);
-  entry.registered_events = events;
-
-  CR_DCHECK(FindPollEntry(entry.fd) == pollfds_.end());
-  struct pollfd poll_entry;
-  poll_entry.fd = entry.fd;
-  poll_entry.revents = 0;
-  SetEventsForPoll(events, &poll_entry);
-
-  pollfds_.push_back(poll_entry);
+  AddPollEntry(entry);
+  SetRegisteredEvents(entry, events);
 }
 
 void MessagePumpEpoll::UpdateEpollEvent(EpollEventEntry& entry) {
@@ -365,9 +438,7 @@ void MessagePumpEpoll::UpdateEpollEvent(EpollEventEntry& entry) {
       } else {
         // No work needs to be done for epoll, but for poll we have to implement
         // the equivalent of oneshot ourselves by unregistering for all events.
-        auto poll_entry = FindPollEntry(entry.fd);
-        CR_CHECK(poll_entry != pollfds_.end());
-        poll_entry->events = 0;
+        GetPollEntry(entry).events = 0;
       }
       return;
     }
@@ -376,16 +447,21 @@ void MessagePumpEpoll::UpdateEpollEvent(EpollEventEntry& entry) {
       return;
     }
     epoll_event event{.events = events, .data = {.ptr = &entry}};
-    int rv = epoll_ctl(epoll_.get(), EPOLL_CTL_MOD, entry.fd, &event);
+    int rv;
+    if ((events | entry.registered_events) & EPOLLEXCLUSIVE) {
+      // EPOLL_CTL_MOD fails with EINVAL for exclusive entries, and can't make
+      // an entry exclusive either. Register the descriptor anew instead.
+      rv = epoll_ctl(epoll_.get(), EPOLL_CTL_DEL, entry.fd, nullptr);
+      CR_DPCHECK(rv == 0);
+      rv = epoll_ctl(epoll_.get(), EPOLL_CTL_ADD, entry.fd, &event);
+    } else {
+      rv = epoll_ctl(epoll_.get(), EPOLL_CTL_MOD, entry.fd, &event);
+    }
     CR_DPCHECK(rv == 0);
 ///#if DCHECK_IS_ON()
 ///    entry.PushEpollHistory(std::make_optional(event));
 ///#endif
-    entry.registered_events = events;
-
-    auto poll_entry = FindPollEntry(entry.fd);
-    CR_CHECK(poll_entry != pollfds_.end());
-    SetEventsForPoll(events, &(*poll_entry));
+    SetRegisteredEvents(entry, events);
   } else if (events != 0) {
     // An interest for the fd has been reactivated. Re-enable the fd.
     entry.stopped = false;
@@ -402,8 +478,8 @@ void MessagePumpEpoll::StopEpollEvent(EpollEventEntry& entry) {
 ///    entry.PushEpollHistory(std::nullopt);
 ///#endif
     entry.stopped = true;
-    entry.registered_events = 0;
-    RemovePollEntry(entry.fd);
+    SetRegisteredEvents(entry, 0);
+    RemovePollEntry(entry);
   }
 }
 
@@ -429,18 +505,68 @@ void MessagePumpEpoll::UnregisterInterest(
   }
 }
 
-bool MessagePumpEpoll::WaitForEpollEvents(TimeDelta timeout) {
+void MessagePumpEpoll::SetHighResolutionTimers(bool enabled) {
+  CR_DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  high_resolution_timers_ = enabled;
+}
+
+void MessagePumpEpoll::SetSpinBudget(TimeDelta spin_budget) {
+  CR_DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  wake_state_.set_spin_budget(spin_budget);
+}
+
+void MessagePumpEpoll::SetPollThreshold(size_t max_poll_fds) {
+  CR_DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  poll_threshold_ = max_poll_fds;
+}
+
+void MessagePumpEpoll::SetEventBatchLimits(size_t max_event_batch_size,
+                                           size_t native_work_budget) {
   CR_DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  CR_DCHECK(!event_buffer_in_use_);
+  CR_DCHECK(max_event_batch_size > 0);
+  CR_DCHECK(native_work_budget > 0);
+  max_event_batch_size_ = max_event_batch_size;
+  event_batch_size_ = std::min(kMinEventBatchSize, max_event_batch_size_);
+  event_buffer_.resize(max_event_batch_size_);
+  native_work_budget_ = native_work_budget;
+}
+
+size_t MessagePumpEpoll::GetMaxEventsPerWait() const {
+  // Waits are only bounded by `max_events`, which Run() keeps within
+  // `event_buffer_`.
+  return std::numeric_limits<size_t>::max();
+}
+
+size_t MessagePumpEpoll::WaitForEpollEvents(TimeDelta timeout,
+                                            size_t max_events) {
+  CR_DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  CR_DCHECK(max_events > 0);
 
   // `timeout` has microsecond resolution, but timeouts accepted by epoll_wait()
-  // are integral milliseconds. Round up to the next millisecond.
-  // TODO(crbug.com/40245876): Consider higher-resolution timeouts.
+  // are integral milliseconds. Round up to the next millisecond, unless high
+  // resolution timers are enabled, in which case the wait is given the exact
+  // timeout through epoll_pwait2(), a timerfd or ppoll().
   const int epoll_timeout =
       timeout.is_max() ? -1
-                       : saturated_cast<int>(timeout.InMillisecondsRoundedUp());
+                       : SaturatedCast<int>(timeout.InMillisecondsRoundedUp());
+  const bool high_resolution =
+      high_resolution_timers_ && !timeout.is_zero() && !timeout.is_max();
+
+  // Don't let a timer armed for an earlier wait end an unbounded one.
+  if (timeout.is_max() && timer_armed_) {
+    DisarmTimer();
+  }
 
-  // Used in the "epoll" code path.
-  epoll_event epoll_events[16];
+  // Used in the "epoll" code path. `event_buffer_` can't be shared with a wait
+  // of an outer run loop which is still dispatching its events; nested waits
+  // use a smaller buffer on the stack instead.
+  epoll_event nested_epoll_events[kMinEventBatchSize];
+  Span<epoll_event> epoll_events =
+      event_buffer_in_use_ ? Span<epoll_event>(nested_epoll_events)
+                           : Span<epoll_event>(event_buffer_);
+  epoll_events = epoll_events.first(std::min(max_events, epoll_events.size()));
+  AutoReset<bool> event_buffer_in_use(&event_buffer_in_use_, true);
   // Used in the "poll" code path.
   std::vector<epoll_event> poll_events;
   // Will refer to `events` or `events_vector` depending on which
@@ -448,32 +574,60 @@ bool MessagePumpEpoll::WaitForEpollEvents(TimeDelta timeout) {
   Span<epoll_event> ready_events;
 
   // When there are many FDs, epoll() can be significantly faster as poll needs
-  // to iterate through the list of watched fds. This value is pretty arbitrary,
-  // the internet suggests that under 1000 fds that epoll isn't noticeably
-  // faster than poll but this isn't easy to empirically measure.
-  bool use_poll =
-      g_use_poll.load(std::memory_order_relaxed) && entries_.size() < 500;
+  // to iterate through the list of watched fds. Threads watching a handful of
+  // fds get the lower wake-up latency of poll() instead (see the top of the
+  // header). Edge-triggered and exclusive registrations need epoll.
+  const bool use_poll = pollfds_.size() <= poll_threshold_ &&
+                        num_epoll_only_entries_ == 0;
 
   if (use_poll) {
-    if (!GetEventsPoll(epoll_timeout, &poll_events)) {
-      return false;
+    if (!GetEventsPoll(epoll_timeout, high_resolution ? &timeout : nullptr,
+                       max_events, &poll_events)) {
+      return 0;
     }
     ready_events = MakeSpan(poll_events).first(poll_events.size());
   } else {
-    const int epoll_result = epoll_wait(epoll_.get(), epoll_events,
-                                        cr::size(epoll_events), epoll_timeout);
+    const int epoll_result =
+        high_resolution
+            ? EpollWaitHighResolution(epoll_events.data(),
+                                      CheckedCast<int>(epoll_events.size()),
+                                      timeout)
+            : epoll_wait(epoll_.get(), epoll_events.data(),
+                         CheckedCast<int>(epoll_events.size()), epoll_timeout);
     if (epoll_result < 0) {
       CR_DPCHECK(errno == EINTR);
-      return false;
+      return 0;
     }
     if (epoll_result == 0) {
-      return false;
+      return 0;
     }
 
-    ready_events =
-        MakeSpan(epoll_events).first(cr::checked_cast<size_t>(epoll_result));
+    ready_events = epoll_events.first(CheckedCast<size_t>(epoll_result));
+    AdaptEventBatchSize(epoll_events.size(), ready_events.size());
   }
 
+  DispatchEpollEvents(ready_events);
+  return ready_events.size();
+}
+
+void MessagePumpEpoll::AdaptEventBatchSize(size_t requested, size_t received) {
+  // Only waits which asked for a full batch say anything about its size.
+  if (requested != event_batch_size_) {
+    return;
+  }
+  if (received == requested) {
+    // More events may be ready than a batch holds: drain them in fewer calls.
+    event_batch_size_ = std::min(event_batch_size_ * 2, max_event_batch_size_);
+  } else if (received < requested / 4) {
+    event_batch_size_ = std::max(event_batch_size_ / 2,
+                                 std::min(kMinEventBatchSize,
+                                          max_event_batch_size_));
+  }
+}
+
+void MessagePumpEpoll::DispatchEpollEvents(Span<epoll_event> ready_events) {
+  CR_DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+
   for (epoll_event& e : ready_events) {
     if (e.data.ptr == &wake_event_) {
       // Wake-up events are always safe to handle immediately. Unlike other
@@ -483,6 +637,12 @@ bool MessagePumpEpoll::WaitForEpollEvents(TimeDelta timeout) {
       e.data.ptr = nullptr;
       continue;
     }
+    if (e.data.ptr == &timer_fd_) {
+      // The timer only ends the wait; whatever was due is run by DoWork().
+      HandleTimerExpiry();
+      e.data.ptr = nullptr;
+      continue;
+    }
 
     // To guard against one of the ready events unregistering and thus
     // invalidating one of the others here, first link each entry to the
@@ -501,24 +661,107 @@ bool MessagePumpEpoll::WaitForEpollEvents(TimeDelta timeout) {
       OnEpollEvent(entry, e.events);
     }
   }
+}
 
-  return true;
+void MessagePumpEpoll::SetRegisteredEvents(EpollEventEntry& entry,
+                                           uint32_t events) {
+  constexpr uint32_t kEpollOnlyEvents = EPOLLET | EPOLLEXCLUSIVE;
+  const bool was_epoll_only = (entry.registered_events & kEpollOnlyEvents) != 0;
+  const bool is_epoll_only = (events & kEpollOnlyEvents) != 0;
+  if (is_epoll_only && !was_epoll_only) {
+    ++num_epoll_only_entries_;
+  } else if (was_epoll_only && !is_epoll_only) {
+    CR_DCHECK(num_epoll_only_entries_ > 0);
+    --num_epoll_only_entries_;
+  }
+  entry.registered_events = events;
+  SetEventsForPoll(events, &GetPollEntry(entry));
+}
+
+void MessagePumpEpoll::AddPollEntry(EpollEventEntry& entry) {
+  struct pollfd poll_entry;
+  poll_entry.fd = entry.fd;
+  poll_entry.events = 0;
+  poll_entry.revents = 0;
+  entry.poll_index = pollfds_.size();
+  pollfds_.push_back(poll_entry);
+  poll_entries_.push_back(&entry);
+}
+
+struct pollfd& MessagePumpEpoll::GetPollEntry(const EpollEventEntry& entry) {
+  CR_DCHECK(entry.poll_index < pollfds_.size());
+  CR_DCHECK(poll_entries_[entry.poll_index] == &entry);
+  return pollfds_[entry.poll_index];
 }
 
-std::vector<struct pollfd>::iterator MessagePumpEpoll::FindPollEntry(int fd) {
-  return std::find_if(
-      pollfds_.begin(), pollfds_.end(),
-      [fd](const struct pollfd poll_entry) { return poll_entry.fd == fd; });
+void MessagePumpEpoll::RemovePollEntry(EpollEventEntry& entry) {
+  CR_DCHECK(poll_entries_[entry.poll_index] == &entry);
+  // `wake_event_` stays at index 0. The order of the others doesn't matter,
+  // so fill the hole with the last element rather than shifting all the
+  // following ones.
+  const size_t index = entry.poll_index;
+  const size_t last = pollfds_.size() - 1;
+  if (index != last) {
+    pollfds_[index] = pollfds_[last];
+    poll_entries_[index] = poll_entries_[last];
+    poll_entries_[index]->poll_index = index;
+  }
+  pollfds_.pop_back();
+  poll_entries_.pop_back();
 }
 
-void MessagePumpEpoll::RemovePollEntry(int fd) {
-  pollfds_.erase(FindPollEntry(fd));
+int MessagePumpEpoll::EpollWaitHighResolution(epoll_event* events,
+                                              int max_events,
+                                              TimeDelta timeout) {
+  const struct timespec ts = timeout.ToTimeSpec();
+#if defined(__NR_epoll_pwait2)
+  if (!g_epoll_pwait2_unsupported.load(std::memory_order_relaxed)) {
+    int rv = static_cast<int>(syscall(__NR_epoll_pwait2, epoll_.get(), events,
+                                      max_events, &ts, nullptr, 0));
+    if (rv >= 0 || errno != ENOSYS) {
+      return rv;
+    }
+    g_epoll_pwait2_unsupported.store(true, std::memory_order_relaxed);
+  }
+#endif  // defined(__NR_epoll_pwait2)
+
+  // Let a timerfd end the wait instead. It is registered with `epoll_` like
+  // any other descriptor and shows up as a ready event once it expires.
+  if (!timer_fd_.is_valid()) {
+    timer_fd_.reset(timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK));
+    CR_PCHECK(timer_fd_.is_valid());
+    epoll_event timer{.events = EPOLLIN, .data = {.ptr = &timer_fd_}};
+    int rv = epoll_ctl(epoll_.get(), EPOLL_CTL_ADD, timer_fd_.get(), &timer);
+    CR_PCHECK(rv == 0);
+  }
+  struct itimerspec spec = {};
+  spec.it_value = ts;
+  int rv = timerfd_settime(timer_fd_.get(), /*flags=*/0, &spec, nullptr);
+  CR_DPCHECK(rv == 0);
+  timer_armed_ = true;
+  return epoll_wait(epoll_.get(), events, max_events, /*timeout=*/-1);
+}
+
+void MessagePumpEpoll::DisarmTimer() {
+  const struct itimerspec spec = {};
+  int rv = timerfd_settime(timer_fd_.get(), /*flags=*/0, &spec, nullptr);
+  CR_DPCHECK(rv == 0);
+  timer_armed_ = false;
 }
 
 bool MessagePumpEpoll::GetEventsPoll(int epoll_timeout,
+                                     const TimeDelta* high_resolution_timeout,
+                                     size_t max_events,
                                      std::vector<epoll_event>* epoll_events) {
-  int retval = poll(&pollfds_[0], cr::checked_cast<nfds_t>(pollfds_.size()),
-                    epoll_timeout);
+  int retval;
+  if (high_resolution_timeout) {
+    const struct timespec ts = high_resolution_timeout->ToTimeSpec();
+    retval = ppoll(&pollfds_[0], CheckedCast<nfds_t>(pollfds_.size()), &ts,
+                   nullptr);
+  } else {
+    retval = poll(&pollfds_[0], CheckedCast<nfds_t>(pollfds_.size()),
+                  epoll_timeout);
+  }
   if (retval < 0) {
     CR_DPCHECK(errno == EINTR);
     return false;
@@ -528,20 +771,24 @@ bool MessagePumpEpoll::GetEventsPoll(int epoll_timeout,
     return false;
   }
 
-  for (struct pollfd& pollfd_entry : pollfds_) {
+  for (size_t i = 0; i < pollfds_.size(); ++i) {
+    struct pollfd& pollfd_entry = pollfds_[i];
     if (pollfd_entry.revents == 0) {
       continue;
     }
+    if (epoll_events->size() == max_events) {
+      // The rest is reported again by the next poll().
+      break;
+    }
 
     epoll_event event;
     memset(&event, 0, sizeof(event));
 
-    if (pollfd_entry.fd == wake_event_.get()) {
-      event.data.ptr = &wake_event_;
+    if (poll_entries_[i]) {
+      event.data.ptr = poll_entries_[i];
     } else {
-      auto entry = entries_.find(pollfd_entry.fd);
-      CR_CHECK(entry != entries_.end());
-      event.data.ptr = &(entry->second);
+      CR_DCHECK(pollfd_entry.fd == wake_event_.get());
+      event.data.ptr = &wake_event_;
     }
 
     for (const auto& epoll_poll : kEpollToPollEvents) {
@@ -634,6 +881,7 @@ void MessagePumpEpoll::HandleEvent(int fd,
   if (run_state_) {
     scoped_do_native_work = run_state_->delegate->BeginNativeWork();
   }
+  const TimeTicks start = TimeTicks::Now();
 
   // Trace events must begin after the above BeginWorkItem() so that the
   // ensuing "ThreadController active" outscopes all the events under it.
@@ -662,6 +910,7 @@ void MessagePumpEpoll::HandleEvent(int fd,
   } else if (can_read) {
     controller->OnFdReadable();
   }
+  metrics_.RecordNativeEvent(TimeTicks::Now() - start);
 }
 
 void MessagePumpEpoll::HandleWakeUp() {
@@ -670,6 +919,17 @@ void MessagePumpEpoll::HandleWakeUp() {
   uint64_t value;
   ssize_t n = HANDLE_EINTR(read(wake_event_.get(), &value, sizeof(value)));
   CR_DPCHECK(n == sizeof(value));
+  woken_up_ = true;
+}
+
+void MessagePumpEpoll::HandleTimerExpiry() {
+  CR_DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  uint64_t expirations;
+  ssize_t n =
+      HANDLE_EINTR(read(timer_fd_.get(), &expirations, sizeof(expirations)));
+  // EAGAIN if the timer was re-armed after it expired but before this read.
+  CR_DPCHECK(n == sizeof(expirations) || errno == EAGAIN);
+  timer_armed_ = false;
 }
 
 ///void MessagePumpEpoll::BeginNativeWorkBatch() {
@@ -695,6 +955,8 @@ MessagePumpEpoll::EpollEventEntry::~EpollEventEntry() {
 uint32_t MessagePumpEpoll::EpollEventEntry::ComputeActiveEvents() const {
   uint32_t events = 0;
   bool one_shot = true;
+  bool edge_triggered = true;
+  bool exclusive = true;
   for (const auto& interest : interests) {
     if (!interest->active()) {
       continue;
@@ -702,9 +964,19 @@ uint32_t MessagePumpEpoll::EpollEventEntry::ComputeActiveEvents() const {
     const InterestParams& params = interest->params();
     events |= (params.read ? EPOLLIN : 0) | (params.write ? EPOLLOUT : 0);
     one_shot &= params.one_shot;
+    edge_triggered &= params.edge_triggered;
+    exclusive &= params.exclusive;
+  }
+  if (events == 0) {
+    return 0;
+  }
+  if (one_shot) {
+    events |= EPOLLONESHOT;
+  } else if (exclusive) {
+    events |= EPOLLEXCLUSIVE;
   }
-  if (events != 0 && one_shot) {
-    return events | EPOLLONESHOT;
+  if (edge_triggered) {
+    events |= EPOLLET;
   }
   return events;
 }
@@ -22,6 +22,8 @@
 #include "cr_base/time/time.h"
 
 #include "cr_event/message_pump/message_pump.h"
+#include "cr_event/message_pump/message_pump_metrics.h"
+#include "cr_event/message_pump/message_pump_wake_state.h"
 #include "cr_event/message_pump/posix/watchable_io_message_pump_posix.h"
 #include "cr_event/threading/thread_checker.h"
 
@@ -48,7 +50,10 @@ namespace cr {
 // this behavior.
 //
 // Caveat: Since both we and the kernel need to walk the list of all fds at
-// every call, don't do it when we have too many FDs.
+// every call, don't do it when we have too many FDs. The pump therefore uses
+// poll() while it watches at most a threshold of FDs (see SetPollThreshold())
+// and epoll_wait() past it. Both interest lists are kept up to date at all
+// times, so switching between them costs nothing.
 ///BASE_FEATURE(kUsePollForMessagePumpEpoll,
 ///             "UsePollForMessagePumpEpoll",
 ///             base::FEATURE_DISABLED_BY_DEFAULT);
@@ -111,6 +116,30 @@ class CRBASE_EXPORT MessagePumpEpoll : public MessagePump,
   // Initializes features for this class. See `base::features::Init()`.
   static void InitializeFeatures();
 
+  // Options for WatchFileDescriptor() which may be OR-ed together in `flags`.
+  enum WatchFlags {
+    // The default: `watcher` is notified as long as the descriptor is ready.
+    WATCH_LEVEL_TRIGGERED = 0,
+
+    // `watcher` is only notified when the descriptor becomes ready (EPOLLET),
+    // so it must read or write until EAGAIN before waiting for the next
+    // notification. A persistent edge-triggered watch never needs to be
+    // re-armed, and writers aren't notified again while the socket buffer
+    // stays writable. Watchers may still see spurious notifications, e.g. when
+    // another watch on the same descriptor is level-triggered or on
+    // MessagePumpIOUring. The pump doesn't use poll() while such a watch is
+    // registered.
+    WATCH_EDGE_TRIGGERED = 1 << 0,
+
+    // When several epoll instances (i.e. several IO threads) watch the same
+    // descriptor with this flag, an event wakes only one of them up
+    // (EPOLLEXCLUSIVE), which avoids the thundering herd on shared listening
+    // sockets. Only valid with persistent watches. On kernels older than 4.5
+    // the flag is ignored. The pump doesn't use poll() while such a watch is
+    // registered.
+    WATCH_EXCLUSIVE = 1 << 1,
+  };
+
   // Starts watching `fd` for events as prescribed by `mode` (see
   // WatchableIOMessagePumpPosix). When an event occurs, `watcher` is notified.
   //
@@ -119,6 +148,8 @@ class CRBASE_EXPORT MessagePumpEpoll : public MessagePump,
   // remains active until explicitly cancelled and `watcher` may see multiple
   // events over time.
   //
+  // `flags` is a combination of WatchFlags.
+  //
   // The watch can be cancelled at any time by destroying the `controller` or
   // explicitly calling StopWatchingFileDescriptor() on it.
   //
@@ -129,15 +160,52 @@ class CRBASE_EXPORT MessagePumpEpoll : public MessagePump,
                            bool persistent,
                            int mode,
                            FdWatchController* controller,
-                           FdWatcher* watcher);
+                           FdWatcher* watcher,
+                           int flags = WATCH_LEVEL_TRIGGERED);
+
+  // By default a wait for delayed work is rounded up to whole milliseconds,
+  // which is what epoll_wait() accepts, so delayed tasks may run up to 1ms
+  // late. With high resolution timers enabled, waits end within the precision
+  // of the kernel's timers instead (at the cost of a timerfd_settime() per
+  // wait on kernels older than 5.11). Waits of MessagePumpIOUring always have
+  // high resolution. Must be called on the pump's thread.
+  void SetHighResolutionTimers(bool enabled);
+
+  // The number of events collected by one epoll_wait() adapts to the load: it
+  // starts at kMinEventBatchSize, doubles whenever a wait fills it and halves
+  // whenever a wait fills less than a quarter of it, within
+  // [kMinEventBatchSize, `max_event_batch_size`]. Independently, Run() stops
+  // dispatching ready events to yield to Delegate::DoWork() once
+  // `native_work_budget` events have been dispatched in a row, so that busy
+  // descriptors can't starve application tasks (and the other way around,
+  // since DoWork() runs a bounded batch of tasks). The defaults match one
+  // batch of kMinEventBatchSize per DoWork(). Must be called on the pump's
+  // thread, outside of WaitForEpollEvents().
+  static constexpr size_t kMinEventBatchSize = 16;
+  void SetEventBatchLimits(size_t max_event_batch_size,
+                           size_t native_work_budget);
+
+  // Waits use poll() while at most `max_poll_fds` descriptors (including the
+  // pump's internal wake-up descriptor) are watched, and epoll_wait() beyond
+  // that. 0 always uses epoll_wait(). Must be called on the pump's thread.
+  static constexpr size_t kDefaultPollThreshold = 32;
+  void SetPollThreshold(size_t max_poll_fds);
+
+  // When out of work, busy-polls for up to `spin_budget` before waiting for
+  // events, so that work scheduled from another thread meanwhile runs without
+  // an eventfd write and wake-up. Descriptors which become ready while
+  // spinning are only dispatched after it. Zero (the default) disables
+  // spinning. Must be called on the pump's thread. See MessagePumpWakeState.
+  void SetSpinBudget(TimeDelta spin_budget);
 
   // MessagePump methods:
   void Run(Delegate* delegate) override;
   void Quit() override;
   void ScheduleWork() override;
   void ScheduleDelayedWork(const TimeTicks& delayed_work_time) override;
+  bool GetMetrics(MessagePumpMetrics* metrics) const override;
 
- private:
+ protected:
   friend class MessagePumpEpollTest;
 
   // The WatchFileDescriptor API supports multiple FdWatchControllers watching
@@ -164,6 +232,10 @@ class CRBASE_EXPORT MessagePumpEpoll : public MessagePump,
     //   - EPOLLIN is set if any active Interest wants to `read`.
     //   - EPOLLOUT is set if any active Interest wants to `write`.
     //   - EPOLLONESHOT is set if all active Interests are one-shot.
+    //   - EPOLLET is set if all active Interests are edge-triggered, since a
+    //     level-triggered Interest could otherwise miss events.
+    //   - EPOLLEXCLUSIVE is set if all active Interests are exclusive and
+    //     EPOLLONESHOT isn't set, which the kernel doesn't allow with it.
     uint32_t ComputeActiveEvents() const;
 
     // The file descriptor to which this entry pertains.
@@ -191,6 +263,14 @@ class CRBASE_EXPORT MessagePumpEpoll : public MessagePump,
     // return, and prevent any future update on this `EpollEventEntry`.
     bool stopped = false;
 
+    // Sequence number of the poll request currently in flight for `fd` on a
+    // completion-based backend (see MessagePumpIOUring), or 0 if none is. The
+    // epoll backend doesn't use this.
+    uint32_t armed_sequence = 0;
+
+    // Index of the element of `pollfds_` for `fd`, if any.
+    size_t poll_index = 0;
+
 ///#if DCHECK_IS_ON()
 ///    struct EpollHistory {
 ///      base::debug::StackTrace stack_trace;
@@ -222,24 +302,83 @@ class CRBASE_EXPORT MessagePumpEpoll : public MessagePump,
     bool should_quit = false;
   };
 
-  void AddEpollEvent(EpollEventEntry& entry);
-  void UpdateEpollEvent(EpollEventEntry& entry);
-  void StopEpollEvent(EpollEventEntry& entry);
+  // These make up the kernel interface of the pump: registering, updating and
+  // removing the aggregate interest of an entry, and waiting for readiness.
+  // They're virtual so that a different kernel backend can reuse the interest
+  // bookkeeping and dispatch logic above them.
+  virtual void AddEpollEvent(EpollEventEntry& entry);
+  virtual void UpdateEpollEvent(EpollEventEntry& entry);
+  virtual void StopEpollEvent(EpollEventEntry& entry);
+  //
+  // WaitForEpollEvents() dispatches at most `max_events` events and returns
+  // how many it dispatched, including wake-ups.
+  virtual size_t WaitForEpollEvents(TimeDelta timeout, size_t max_events);
+
+  // Returns the most events WaitForEpollEvents() dispatches per call, however
+  // large `max_events` is. Run() keeps waiting without blocking as long as a
+  // wait is full, so it must not ask for more than this.
+  virtual size_t GetMaxEventsPerWait() const;
+
+  // Dispatches `ready_events`, each of which must either be the wake-up event
+  // or refer to an EpollEventEntry through `data.ptr`.
+  void DispatchEpollEvents(Span<epoll_event> ready_events);
+  void HandleWakeUp();
+  void HandleTimerExpiry();
+
+  // WatchFileDescriptor() must be called from this thread, and so must
+  // FdWatchController::StopWatchingFileDescriptor().
+  CR_THREAD_CHECKER(thread_checker_);
+
+  // Mapping of all file descriptors currently watched by this message pump.
+  // std::map was chosen because (1) the number of elements can vary widely,
+  // (2) we don't do frequent lookups, and (3) values need stable addresses
+  // across insertion or removal of other elements.
+  std::map<int, EpollEventEntry> entries_;
+
+  // An eventfd object used to wake the pump's thread when scheduling new work.
+  ScopedFD wake_event_;
+
+  // Tracks whether the thread waits for events, and spins for a while before
+  // it does.
+  MessagePumpWakeState wake_state_;
+
+  // See GetMetrics(). `woken_up_` is set when the wake-up eventfd is read, so
+  // that wake-ups for ScheduleWork() aren't counted as spurious.
+  MessagePumpMetricsRecorder metrics_;
+  bool woken_up_ = false;
+
+ private:
   void UnregisterInterest(const RefPtr<Interest>& interest);
-  bool WaitForEpollEvents(TimeDelta timeout);
-  bool GetEventsPoll(int epoll_timeout, std::vector<epoll_event>* epoll_events);
+  // Same as epoll_wait(), with a timeout which isn't rounded to milliseconds.
+  int EpollWaitHighResolution(epoll_event* events,
+                              int max_events,
+                              TimeDelta timeout);
+  void DisarmTimer();
+  void AdaptEventBatchSize(size_t requested, size_t received);
+  bool GetEventsPoll(int epoll_timeout,
+                     const TimeDelta* high_resolution_timeout,
+                     size_t max_events,
+                     std::vector<epoll_event>* epoll_events);
   void OnEpollEvent(EpollEventEntry& entry, uint32_t events);
   void HandleEvent(int fd,
                    bool can_read,
                    bool can_write,
                    FdWatchController* controller);
-  void HandleWakeUp();
+
+  // Blocks in WaitForEpollEvents() for at most `timeout`, and records the
+  // wake-up in `metrics_`.
+  void WaitForWork(TimeDelta timeout);
 
   ///void BeginNativeWorkBatch();
   void RecordPeriodicMetrics();
 
-  std::vector<struct pollfd>::iterator FindPollEntry(int fd);
-  void RemovePollEntry(int fd);
+  // Sets the epoll event bits registered for `entry` on the epoll instance,
+  // and updates `entry`'s poll entry to match.
+  void SetRegisteredEvents(EpollEventEntry& entry, uint32_t events);
+
+  void AddPollEntry(EpollEventEntry& entry);
+  struct pollfd& GetPollEntry(const EpollEventEntry& entry);
+  void RemovePollEntry(EpollEventEntry& entry);
 
   // Null if Run() is not currently executing. Otherwise it's a pointer into the
   // stack of the innermost nested Run() invocation.
@@ -249,28 +388,42 @@ class CRBASE_EXPORT MessagePumpEpoll : public MessagePump,
   // `DoWork()` call. See crbug.com/1500295.
   bool native_work_started_ = false;
 
-  // Mapping of all file descriptors currently watched by this message pump.
-  // std::map was chosen because (1) the number of elements can vary widely,
-  // (2) we don't do frequent lookups, and (3) values need stable addresses
-  // across insertion or removal of other elements.
-  std::map<int, EpollEventEntry> entries_;
-
-  // pollfd array passed to poll() when not using epoll.
+  // pollfd array passed to poll() when not using epoll. `poll_entries_[i]` is
+  // the entry `pollfds_[i]` belongs to, or null for `wake_event_`. Removal
+  // moves the last element into the hole, so each entry records its index.
   std::vector<struct pollfd> pollfds_;
+  std::vector<EpollEventEntry*> poll_entries_;
+
+  // See SetPollThreshold().
+  size_t poll_threshold_ = kDefaultPollThreshold;
+
+  // Number of entries registered with EPOLLET or EPOLLEXCLUSIVE, which poll()
+  // can't honor.
+  size_t num_epoll_only_entries_ = 0;
 
   // The epoll instance used by this message pump to monitor file descriptors.
   ScopedFD epoll_;
 
-  // An eventfd object used to wake the pump's thread when scheduling new work.
-  ScopedFD wake_event_;
+  // See SetHighResolutionTimers().
+  bool high_resolution_timers_ = false;
+
+  // See SetEventBatchLimits(). `event_batch_size_` is the current adaptive
+  // size, and `event_buffer_` holds `max_event_batch_size_` events for the
+  // outermost wait. `event_buffer_in_use_` is true while a wait uses it.
+  size_t max_event_batch_size_ = kMinEventBatchSize;
+  size_t event_batch_size_ = kMinEventBatchSize;
+  size_t native_work_budget_ = kMinEventBatchSize;
+  std::vector<epoll_event> event_buffer_;
+  bool event_buffer_in_use_ = false;
+
+  // Created on the first high resolution wait if epoll_pwait2() isn't
+  // available; `timer_armed_` is true while it may still expire.
+  ScopedFD timer_fd_;
+  bool timer_armed_ = false;
 
   // Tracks when we should next record periodic metrics.
   cr::TimeTicks next_metrics_time_;
 
-  // WatchFileDescriptor() must be called from this thread, and so must
-  // FdWatchController::StopWatchingFileDescriptor().
-  CR_THREAD_CHECKER(thread_checker_);
-
   WeakPtrFactory<MessagePumpEpoll> weak_ptr_factory_{this};
 };
 
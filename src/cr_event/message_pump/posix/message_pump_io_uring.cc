@@ -0,0 +1,468 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cr_event/message_pump/posix/message_pump_io_uring.h"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "cr_base/compiler_config.h"
+
+#include "cr_base/logging/logging.h"
+#include "cr_base/memory/ptr_util.h"
+
+namespace cr {
+
+namespace {
+
+// Size of the submission ring. The completion ring is four times larger, and
+// completions which still don't fit are held back by the kernel (see
+// IORING_FEAT_NODROP) until the ring is drained.
+constexpr unsigned kSubmissionRingEntries = 256;
+constexpr unsigned kCompletionRingEntries = kSubmissionRingEntries * 4;
+
+// Completions are reaped from shared memory, so there's no syscall to save by
+// reaping more of them per wait.
+constexpr size_t kMaxEventsPerWait = MessagePumpEpoll::kMinEventBatchSize;
+
+// A timeout in flight is kept for a wait whose deadline is this close to its
+// own, the resolution of the waits of MessagePumpEpoll. Deadlines are derived
+// from relative timeouts, so those of waits for the same delayed task differ
+// by a few microseconds.
+constexpr TimeDelta kTimeoutSlack = TimeDelta::FromMilliseconds(1);
+
+// The low bits of a request's `user_data` say what the request is. Poll and
+// timeout requests also carry a sequence number in the high 32 bits, and poll
+// requests carry their file descriptor in between.
+enum : uint64_t {
+  // Completions of POLL_REMOVE and TIMEOUT_REMOVE requests, which are ignored.
+  kCancelTag = 0,
+  kPollTag = 1,
+  kWakeUpTag = 2,
+  kTimeoutTag = 3,
+  kTagMask = 3,
+};
+
+uint64_t MakeToken(uint64_t tag, int fd, uint32_t sequence) {
+  CR_DCHECK(fd >= 0 && fd < (1 << 30));
+  return (static_cast<uint64_t>(sequence) << 32) |
+         (static_cast<uint64_t>(fd) << 2) | tag;
+}
+
+int TokenFd(uint64_t token) {
+  return static_cast<int>((token & 0xffffffffu) >> 2);
+}
+
+uint32_t TokenSequence(uint64_t token) {
+  return static_cast<uint32_t>(token >> 32);
+}
+
+int IOUringSetup(unsigned entries, io_uring_params* params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int IOUringEnter(int ring_fd,
+                 unsigned to_submit,
+                 unsigned min_complete,
+                 unsigned flags) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit,
+                                  min_complete, flags, nullptr, 0));
+}
+
+int IOUringRegister(int ring_fd, unsigned opcode, void* arg, unsigned nr_args) {
+  return static_cast<int>(
+      syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args));
+}
+
+// The ring indices are shared with the kernel, which reads what we publish
+// and publishes what we read.
+unsigned LoadAcquire(const unsigned* index) {
+  return __atomic_load_n(index, __ATOMIC_ACQUIRE);
+}
+
+void StoreRelease(unsigned* index, unsigned value) {
+  __atomic_store_n(index, value, __ATOMIC_RELEASE);
+}
+
+template <typename T>
+T* RingPointer(void* ring, uint32_t offset) {
+  return reinterpret_cast<T*>(static_cast<char*>(ring) + offset);
+}
+
+// Returns true if `ring_fd` supports every operation issued by the pump.
+bool SupportsRequiredOps(int ring_fd) {
+  constexpr uint8_t kRequiredOps[] = {
+      IORING_OP_POLL_ADD,
+      IORING_OP_POLL_REMOVE,
+      IORING_OP_TIMEOUT,
+      IORING_OP_TIMEOUT_REMOVE,
+  };
+  constexpr unsigned kMaxOps = 256;
+
+  std::unique_ptr<char[]> buffer(
+      new char[sizeof(io_uring_probe) + kMaxOps * sizeof(io_uring_probe_op)]());
+  auto* probe = reinterpret_cast<io_uring_probe*>(buffer.get());
+  if (IOUringRegister(ring_fd, IORING_REGISTER_PROBE, probe, kMaxOps) < 0)
+    return false;
+
+  for (uint8_t op : kRequiredOps) {
+    if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED))
+      return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+MessagePumpIOUring::MessagePumpIOUring() = default;
+
+MessagePumpIOUring::~MessagePumpIOUring() {
+  // Closing `ring_` cancels whatever is still in flight.
+  if (sqes_)
+    munmap(sqes_, sqes_size_);
+  if (sq_ring_)
+    munmap(sq_ring_, sq_ring_size_);
+}
+
+// static
+std::unique_ptr<MessagePumpIOUring> MessagePumpIOUring::TryCreate() {
+  std::unique_ptr<MessagePumpIOUring> pump =
+      WrapUnique(new MessagePumpIOUring());
+  if (!pump->Initialize())
+    return nullptr;
+  return pump;
+}
+
+bool MessagePumpIOUring::Initialize() {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  params.flags = IORING_SETUP_CQSIZE;
+  params.cq_entries = kCompletionRingEntries;
+  const int ring_fd = IOUringSetup(kSubmissionRingEntries, &params);
+  if (ring_fd < 0) {
+    CR_DPLOG(Warning) << "io_uring_setup";
+    return false;
+  }
+  ring_.reset(ring_fd);
+
+  // Both rings live in one mapping since 5.4 and completions are never dropped
+  // since 5.5; older kernels don't have the probe interface anyway.
+  if (!(params.features & IORING_FEAT_SINGLE_MMAP) ||
+      !(params.features & IORING_FEAT_NODROP) ||
+      !SupportsRequiredOps(ring_fd)) {
+    return false;
+  }
+
+  sq_ring_size_ = std::max<size_t>(
+      params.sq_off.array + params.sq_entries * sizeof(unsigned),
+      params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+  void* sq_ring = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+  if (sq_ring == MAP_FAILED) {
+    CR_DPLOG(Warning) << "mmap";
+    return false;
+  }
+  sq_ring_ = sq_ring;
+
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  void* sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    CR_DPLOG(Warning) << "mmap";
+    return false;
+  }
+  sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+  sq_head_ = RingPointer<unsigned>(sq_ring_, params.sq_off.head);
+  sq_tail_ = RingPointer<unsigned>(sq_ring_, params.sq_off.tail);
+  sq_mask_ = *RingPointer<unsigned>(sq_ring_, params.sq_off.ring_mask);
+  sq_entries_ = params.sq_entries;
+  sqe_tail_ = *sq_tail_;
+
+  // Slot i of the submission ring always refers to sqes_[i].
+  unsigned* sq_array = RingPointer<unsigned>(sq_ring_, params.sq_off.array);
+  for (unsigned i = 0; i < sq_entries_; ++i)
+    sq_array[i] = i;
+
+  cq_head_ = RingPointer<unsigned>(sq_ring_, params.cq_off.head);
+  cq_tail_ = RingPointer<unsigned>(sq_ring_, params.cq_off.tail);
+  cq_mask_ = *RingPointer<unsigned>(sq_ring_, params.cq_off.ring_mask);
+  cqes_ = RingPointer<io_uring_cqe>(sq_ring_, params.cq_off.cqes);
+
+  ArmWakeUp();
+  return true;
+}
+
+void MessagePumpIOUring::AddEpollEvent(EpollEventEntry& entry) {
+  CR_DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  CR_DCHECK(!entry.stopped);
+  CR_DCHECK(!entry.armed_sequence);
+  const uint32_t events = PollEvents(entry);
+  if (events != 0)
+    ArmPoll(entry, events);
+}
+
+void MessagePumpIOUring::UpdateEpollEvent(EpollEventEntry& entry) {
+  CR_DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  const uint32_t events = PollEvents(entry);
+  if (entry.stopped) {
+    if (events != 0) {
+      // An interest for the fd has been reactivated. Re-enable the fd.
+      entry.stopped = false;
+      ArmPoll(entry, events);
+    }
+    return;
+  }
+
+  if (entry.armed_sequence) {
+    if (events == entry.registered_events)
+      return;
+    CancelPoll(entry);
+  }
+  if (events != 0)
+    ArmPoll(entry, events);
+}
+
+void MessagePumpIOUring::StopEpollEvent(EpollEventEntry& entry) {
+  CR_DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  if (entry.stopped)
+    return;
+  if (entry.armed_sequence)
+    CancelPoll(entry);
+  entry.stopped = true;
+}
+
+size_t MessagePumpIOUring::GetMaxEventsPerWait() const {
+  return kMaxEventsPerWait;
+}
+
+size_t MessagePumpIOUring::WaitForEpollEvents(TimeDelta timeout,
+                                              size_t max_events) {
+  CR_DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  CR_DCHECK(max_events > 0);
+
+  // Don't block if completions are already waiting to be reaped.
+  const bool wait =
+      !timeout.is_zero() && LoadAcquire(cq_tail_) == *cq_head_;
+  if (wait) {
+    if (timeout.is_max()) {
+      CancelTimeout();
+    } else {
+      // The timeout of the previous wait is still in flight unless it ended
+      // that wait: keep it if the deadline is the same.
+      const TimeTicks deadline = TimeTicks::Now() + timeout;
+      if (!timeout_sequence_ ||
+          (deadline - timeout_deadline_).magnitude() > kTimeoutSlack) {
+        ArmTimeout(deadline);
+      }
+    }
+  }
+
+  epoll_event ready_events[kMaxEventsPerWait];
+  // The fd of each element of `ready_events`, or -1 for the wake-up event.
+  int ready_fds[kMaxEventsPerWait];
+  const size_t max_ready = std::min(max_events, kMaxEventsPerWait);
+  size_t num_ready = 0;
+  bool timed_out = false;
+
+  // Completions of removals, of the requests they removed, and of poll
+  // requests which were re-armed since don't end a wait: block again until
+  // one which does arrives.
+  do {
+    if (!Enter(wait))
+      return 0;
+
+    unsigned head = *cq_head_;
+    const unsigned tail = LoadAcquire(cq_tail_);
+    for (; head != tail && num_ready < max_ready; ++head) {
+      const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+      const uint64_t token = cqe.user_data;
+      switch (token & kTagMask) {
+        case kPollTag: {
+          // The entry may have been unregistered, or re-armed for a different
+          // set of events, since this request was submitted.
+          auto it = entries_.find(TokenFd(token));
+          if (it == entries_.end() ||
+              it->second.armed_sequence != TokenSequence(token)) {
+            break;
+          }
+          EpollEventEntry& entry = it->second;
+          entry.armed_sequence = 0;
+          entry.registered_events = 0;
+
+          epoll_event& event = ready_events[num_ready];
+          event.events = cqe.res >= 0 ? static_cast<uint32_t>(cqe.res)
+                                      : static_cast<uint32_t>(EPOLLERR);
+          event.data.ptr = &entry;
+          ready_fds[num_ready++] = entry.fd;
+          break;
+        }
+        case kWakeUpTag: {
+          wake_up_armed_ = false;
+          epoll_event& event = ready_events[num_ready];
+          event.events = EPOLLIN;
+          event.data.ptr = &wake_event_;
+          ready_fds[num_ready++] = -1;
+          break;
+        }
+        case kTimeoutTag:
+          if (TokenSequence(token) == timeout_sequence_) {
+            timeout_sequence_ = 0;
+            timed_out = true;
+          }
+          break;
+        default:
+          break;
+      }
+    }
+    StoreRelease(cq_head_, head);
+  } while (wait && num_ready == 0 && !timed_out);
+
+  DispatchEpollEvents(MakeSpan(ready_events, num_ready));
+
+  // Re-arm the entries which were just dispatched and still have active
+  // interests, unless a handler already did so. The requests are submitted
+  // along with everything else on the next wait.
+  for (size_t i = 0; i < num_ready; ++i) {
+    if (ready_fds[i] < 0)
+      continue;
+    auto it = entries_.find(ready_fds[i]);
+    if (it == entries_.end())
+      continue;
+    EpollEventEntry& entry = it->second;
+    if (entry.stopped || entry.armed_sequence)
+      continue;
+    const uint32_t events = PollEvents(entry);
+    if (events != 0)
+      ArmPoll(entry, events);
+  }
+  if (!wake_up_armed_)
+    ArmWakeUp();
+
+  return num_ready;
+}
+
+io_uring_sqe* MessagePumpIOUring::GetSqe() {
+  if (sqe_tail_ - LoadAcquire(sq_head_) >= sq_entries_) {
+    // The submission ring is full. Hand it over to the kernel now rather than
+    // on the next wait.
+    Enter(/*wait=*/false);
+    CR_CHECK(sqe_tail_ - LoadAcquire(sq_head_) < sq_entries_);
+  }
+  io_uring_sqe* sqe = &sqes_[sqe_tail_ & sq_mask_];
+  ++sqe_tail_;
+  memset(sqe, 0, sizeof(*sqe));
+  return sqe;
+}
+
+bool MessagePumpIOUring::Enter(bool wait) {
+  // Submissions left over by an interrupted io_uring_enter() are still
+  // between the kernel's head and our tail, so count from the head.
+  const unsigned to_submit = sqe_tail_ - LoadAcquire(sq_head_);
+  if (to_submit == 0 && !wait)
+    return true;
+
+  StoreRelease(sq_tail_, sqe_tail_);
+  const int rv = IOUringEnter(ring_.get(), to_submit, wait ? 1 : 0,
+                              wait ? IORING_ENTER_GETEVENTS : 0);
+  if (rv < 0) {
+    // EBUSY and EAGAIN mean that completions must be reaped, or resources
+    // freed, before more requests can be accepted; the requests stay queued.
+    CR_DPCHECK(errno == EINTR || errno == EBUSY || errno == EAGAIN);
+    return false;
+  }
+  return true;
+}
+
+// static
+uint32_t MessagePumpIOUring::PollEvents(const EpollEventEntry& entry) {
+  return entry.ComputeActiveEvents() & (EPOLLIN | EPOLLOUT);
+}
+
+void MessagePumpIOUring::ArmPoll(EpollEventEntry& entry, uint32_t events) {
+  CR_DCHECK(!entry.armed_sequence);
+  const uint32_t sequence = NextSequence();
+  entry.armed_sequence = sequence;
+  entry.registered_events = events;
+
+  io_uring_sqe* sqe = GetSqe();
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = entry.fd;
+#if defined(MINI_CHROMIUM_ARCH_CPU_BIG_ENDIAN)
+  // The kernel reads the mask as two 16-bit halves.
+  events = (events << 16) | (events >> 16);
+#endif
+  sqe->poll32_events = events;
+  sqe->user_data = MakeToken(kPollTag, entry.fd, sequence);
+}
+
+void MessagePumpIOUring::CancelPoll(EpollEventEntry& entry) {
+  CR_DCHECK(entry.armed_sequence);
+  io_uring_sqe* sqe = GetSqe();
+  sqe->opcode = IORING_OP_POLL_REMOVE;
+  sqe->fd = -1;
+  sqe->addr = MakeToken(kPollTag, entry.fd, entry.armed_sequence);
+  sqe->user_data = kCancelTag;
+
+  // Should the poll request complete before it is removed, its completion
+  // won't match any entry and will be dropped.
+  entry.armed_sequence = 0;
+  entry.registered_events = 0;
+}
+
+void MessagePumpIOUring::ArmWakeUp() {
+  CR_DCHECK(!wake_up_armed_);
+  io_uring_sqe* sqe = GetSqe();
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = wake_event_.get();
+  sqe->poll32_events = POLLIN;
+  sqe->user_data = kWakeUpTag;
+  wake_up_armed_ = true;
+}
+
+void MessagePumpIOUring::ArmTimeout(TimeTicks deadline) {
+  CancelTimeout();
+
+  // TimeTicks is based on CLOCK_MONOTONIC, the clock of IORING_TIMEOUT_ABS.
+  const struct timespec ts = (deadline - TimeTicks()).ToTimeSpec();
+  timeout_spec_.tv_sec = ts.tv_sec;
+  timeout_spec_.tv_nsec = ts.tv_nsec;
+
+  const uint32_t sequence = NextSequence();
+  io_uring_sqe* sqe = GetSqe();
+  sqe->opcode = IORING_OP_TIMEOUT;
+  sqe->fd = -1;
+  sqe->addr = reinterpret_cast<uint64_t>(&timeout_spec_);
+  sqe->len = 1;
+  // A completion count of zero makes this a pure timer.
+  sqe->off = 0;
+  sqe->timeout_flags = IORING_TIMEOUT_ABS;
+  sqe->user_data = MakeToken(kTimeoutTag, 0, sequence);
+  timeout_sequence_ = sequence;
+  timeout_deadline_ = deadline;
+}
+
+void MessagePumpIOUring::CancelTimeout() {
+  if (!timeout_sequence_)
+    return;
+  io_uring_sqe* sqe = GetSqe();
+  sqe->opcode = IORING_OP_TIMEOUT_REMOVE;
+  sqe->fd = -1;
+  sqe->addr = MakeToken(kTimeoutTag, 0, timeout_sequence_);
+  sqe->user_data = kCancelTag;
+  timeout_sequence_ = 0;
+}
+
+uint32_t MessagePumpIOUring::NextSequence() {
+  // 0 means "nothing in flight".
+  if (++sequence_ == 0)
+    ++sequence_;
+  return sequence_;
+}
+
+}  // namespace cr
@@ -0,0 +1,127 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MINI_CHROMIUM_SRC_CREVENT_MESSAGE_PUMP_MESSAGE_PUMP_IO_URING_H_
+#define MINI_CHROMIUM_SRC_CREVENT_MESSAGE_PUMP_MESSAGE_PUMP_IO_URING_H_
+
+#include <linux/io_uring.h>
+
+#include <cstdint>
+#include <memory>
+
+#include "cr_base/files/scoped_file.h"
+#include "cr_base/time/time.h"
+
+#include "cr_event/event_export.h"
+#include "cr_event/message_pump/posix/message_pump_epoll.h"
+
+namespace cr {
+
+// A MessagePumpEpoll whose kernel interface is an io_uring instance instead of
+// an epoll instance.
+//
+// Watches are armed as one-shot IORING_OP_POLL_ADD requests and re-armed after
+// dispatch, cancelled with IORING_OP_POLL_REMOVE, the wake-up eventfd is
+// watched the same way, and finite waits arm an IORING_OP_TIMEOUT with an
+// absolute deadline, which stays armed across waits for as long as the
+// deadline doesn't change. None of these cost a syscall on their own: they
+// are queued on the submission ring and handed to the kernel together by the
+// io_uring_enter() issued per wait. Non-blocking waits with nothing to submit
+// only read the completion ring and don't enter the kernel at all.
+//
+// The FdWatchController contract is the one of MessagePumpEpoll, so this pump
+// can be used anywhere a MessagePumpForIO is expected. Use TryCreate() (or
+// MessagePumpType::IO_URING) to fall back to plain epoll when the running
+// kernel doesn't support io_uring.
+class CREVENT_EXPORT MessagePumpIOUring : public MessagePumpEpoll {
+ public:
+  MessagePumpIOUring(const MessagePumpIOUring&) = delete;
+  MessagePumpIOUring& operator=(const MessagePumpIOUring&) = delete;
+  ~MessagePumpIOUring() override;
+
+  // Returns a new pump, or nullptr if io_uring is unavailable (kernel too old,
+  // disabled by sysctl or blocked by a seccomp policy) or lacks one of the
+  // operations this pump depends on.
+  static std::unique_ptr<MessagePumpIOUring> TryCreate();
+
+ protected:
+  // MessagePumpEpoll:
+  void AddEpollEvent(EpollEventEntry& entry) override;
+  void UpdateEpollEvent(EpollEventEntry& entry) override;
+  void StopEpollEvent(EpollEventEntry& entry) override;
+  size_t WaitForEpollEvents(TimeDelta timeout, size_t max_events) override;
+  size_t GetMaxEventsPerWait() const override;
+
+ private:
+  MessagePumpIOUring();
+
+  // Sets up the rings. Returns false if io_uring can't be used.
+  bool Initialize();
+
+  // Returns a zeroed submission queue entry, flushing the submission ring to
+  // the kernel first if it is full.
+  io_uring_sqe* GetSqe();
+
+  // Hands all queued submissions to the kernel and, if `wait` is true, blocks
+  // until at least one completion is available. Returns false on EINTR.
+  bool Enter(bool wait);
+
+  // Returns the mask to poll `entry`'s descriptor for. Every poll request is
+  // one-shot and persistent interests are re-armed after each dispatch, so
+  // EPOLLONESHOT carries no information here. Neither do EPOLLET and
+  // EPOLLEXCLUSIVE: re-arming reports a descriptor which is still ready again,
+  // so edge-triggered watches see level-triggered notifications (which they
+  // must tolerate anyway), and each ring polls on its own like a non-exclusive
+  // epoll instance.
+  static uint32_t PollEvents(const EpollEventEntry& entry);
+
+  void ArmPoll(EpollEventEntry& entry, uint32_t events);
+  void CancelPoll(EpollEventEntry& entry);
+  void ArmWakeUp();
+  void ArmTimeout(TimeTicks deadline);
+  void CancelTimeout();
+
+  uint32_t NextSequence();
+
+  ScopedFD ring_;
+
+  // Submission ring.
+  void* sq_ring_ = nullptr;
+  size_t sq_ring_size_ = 0;
+  unsigned* sq_head_ = nullptr;
+  unsigned* sq_tail_ = nullptr;
+  unsigned sq_mask_ = 0;
+  unsigned sq_entries_ = 0;
+  io_uring_sqe* sqes_ = nullptr;
+  size_t sqes_size_ = 0;
+
+  // Local copy of the submission tail; published to `sq_tail_` on Enter().
+  unsigned sqe_tail_ = 0;
+
+  // Completion ring. Shares the mapping of the submission ring.
+  unsigned* cq_head_ = nullptr;
+  unsigned* cq_tail_ = nullptr;
+  unsigned cq_mask_ = 0;
+  io_uring_cqe* cqes_ = nullptr;
+
+  // Source of the sequence numbers tagging poll and timeout requests, used to
+  // discard completions of requests which have since been cancelled.
+  uint32_t sequence_ = 0;
+
+  // Whether a poll request for `wake_event_` is in flight.
+  bool wake_up_armed_ = false;
+
+  // Sequence number of the timeout request in flight, or 0 if none is, and
+  // its deadline.
+  uint32_t timeout_sequence_ = 0;
+  TimeTicks timeout_deadline_;
+
+  // Storage for the absolute CLOCK_MONOTONIC deadline of the last
+  // IORING_OP_TIMEOUT. Read by the kernel when the request is submitted.
+  __kernel_timespec timeout_spec_ = {};
+};
+
+}  // namespace cr
+
+#endif  // MINI_CHROMIUM_SRC_CREVENT_MESSAGE_PUMP_MESSAGE_PUMP_IO_URING_H_
@@ -11,12 +11,18 @@
 namespace cr {
 
 // Amount of timer slack to use for delayed timers.  Increasing timer slack
-// allows the OS to coalesce timers more effectively.
+// allows the OS to coalesce timers more effectively.  On Linux it's the
+// PR_SET_TIMERSLACK of the thread running the MessagePump.
+//
+// Timer slack lets the OS delay a single wake-up. To share wake-ups between
+// delayed tasks, post them with a leeway, see DelayPolicy.
 enum TimerSlack {
-  // Lowest value for timer slack allowed by OS.
+  // Lowest value for timer slack allowed by OS.  On Linux, the default slack
+  // of the thread.
   TIMER_SLACK_NONE,
 
-  // Maximal value for timer slack allowed by OS.
+  // Maximal value for timer slack allowed by OS.  On Linux, a few
+  // milliseconds.
   TIMER_SLACK_MAXIMUM
 };
 
@@ -207,10 +207,12 @@ bool CurrentIOThread::WatchFileDescriptor(
     bool persistent,
     MessagePumpForIO::Mode mode,
     MessagePumpForIO::FdWatchController* controller,
-    MessagePumpForIO::FdWatcher* delegate) {
+    MessagePumpForIO::FdWatcher* delegate,
+    int flags) {
   CR_DCHECK(current_->IsBoundToCurrentThread());
   return GetMessagePumpForIO()->WatchFileDescriptor(fd, persistent, mode,
-                                                    controller, delegate);
+                                                    controller, delegate,
+                                                    flags);
 }
 #endif  // defined(MINI_CHROMIUM_OS_WIN)
 
@@ -248,11 +248,13 @@ class CREVENT_EXPORT CurrentIOThread : public CurrentThread {
 #elif defined(MINI_CHROMIUM_OS_POSIX)
   // Please see WatchableIOMessagePumpPosix for definition.
   // Prefer base::FileDescriptorWatcher for non-critical IO.
-  bool WatchFileDescriptor(int fd,
-                           bool persistent,
-                           MessagePumpForIO::Mode mode,
-                           MessagePumpForIO::FdWatchController* controller,
-                           MessagePumpForIO::FdWatcher* delegate);
+  bool WatchFileDescriptor(
+      int fd,
+      bool persistent,
+      MessagePumpForIO::Mode mode,
+      MessagePumpForIO::FdWatchController* controller,
+      MessagePumpForIO::FdWatcher* delegate,
+      int flags = MessagePumpForIO::WATCH_LEVEL_TRIGGERED);
 #endif  // defined(MINI_CHROMIUM_OS_WIN)
 
  private:
@@ -0,0 +1,29 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MINI_CHROMIUM_SRC_CREVENT_TASK_DELAY_POLICY_H_
+#define MINI_CHROMIUM_SRC_CREVENT_TASK_DELAY_POLICY_H_
+
+namespace cr {
+
+// How precisely a delayed task must run at its delay, given a leeway. See
+// TaskRunner::PostDelayedTaskWithLeeway().
+enum class DelayPolicy {
+  // The task runs no sooner than its delay, and preferably no later than its
+  // delay plus its leeway. Its wake-up may be shared with the tasks due
+  // within that window.
+  kFlexibleNoSooner,
+
+  // The task may run up to its leeway before its delay. For tasks which would
+  // rather run early than cause a wake-up of their own, e.g. periodic
+  // housekeeping.
+  kFlexiblePreferEarly,
+
+  // The task runs at its delay, whatever its leeway.
+  kPrecise,
+};
+
+}  // namespace cr
+
+#endif  // MINI_CHROMIUM_SRC_CREVENT_TASK_DELAY_POLICY_H_
@@ -0,0 +1,211 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cr_event/task/internal/job_task_source.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "cr_base/functional/bind.h"
+#include "cr_base/logging/logging.h"
+#include "cr_base/numerics/bits.h"
+
+#include "cr_event/task/post_job.h"
+#include "cr_event/task/task_executor.h"
+
+namespace cr {
+namespace internal {
+
+constexpr size_t JobTaskSource::kMaxConcurrency;
+
+JobTaskSource::JobTaskSource(
+    const Location& from_here,
+    const TaskTraits& traits,
+    RepeatingCallback<void(JobDelegate*)> worker_task,
+    RepeatingCallback<size_t(size_t)> max_concurrency_callback,
+    TaskExecutor* executor)
+    : from_here_(from_here),
+      traits_(traits),
+      worker_task_(std::move(worker_task)),
+      max_concurrency_callback_(std::move(max_concurrency_callback)),
+      executor_(executor),
+      join_cv_(&lock_) {
+  CR_DCHECK(worker_task_);
+  CR_DCHECK(max_concurrency_callback_);
+  CR_DCHECK(executor_);
+}
+
+JobTaskSource::~JobTaskSource() {
+  CR_DCHECK(num_running_.load() == 0);
+}
+
+bool JobTaskSource::Start() {
+  return MaybePostWorkers();
+}
+
+bool JobTaskSource::IsActive() const {
+  if (is_canceled_.load(std::memory_order_relaxed))
+    return false;
+  const size_t num_running = num_running_.load();
+  return num_running > 0 || GetMaxConcurrency(num_running) > 0;
+}
+
+void JobTaskSource::NotifyConcurrencyIncrease() {
+  {
+    AutoLock auto_lock(lock_);
+    join_wake_up_ = true;
+    join_cv_.Broadcast();
+  }
+  MaybePostWorkers();
+}
+
+void JobTaskSource::Join() {
+  while (true) {
+    RunWorker(/*is_joining_thread=*/true);
+    {
+      AutoLock auto_lock(lock_);
+      while (num_running_.load() > 0 && !join_wake_up_)
+        join_cv_.Wait();
+      join_wake_up_ = false;
+    }
+    if (num_running_.load() == 0 &&
+        (is_canceled_.load(std::memory_order_relaxed) ||
+         GetMaxConcurrency(0) == 0)) {
+      break;
+    }
+  }
+
+  // Workers still posted may start any time, and the callbacks may be gone
+  // once this returns: those which start from now on return right away, and
+  // those which already started are waited for.
+  AutoLock auto_lock(lock_);
+  is_joined_ = true;
+  while (num_started_ > 0)
+    join_cv_.Wait();
+}
+
+void JobTaskSource::Cancel() {
+  is_canceled_.store(true, std::memory_order_relaxed);
+}
+
+bool JobTaskSource::ShouldYield(bool is_joining_thread) const {
+  if (is_canceled_.load(std::memory_order_relaxed))
+    return true;
+  return !is_joining_thread && executor_->ShouldYield(traits_.priority());
+}
+
+uint8_t JobTaskSource::AcquireTaskId() {
+  uint64_t assigned_task_ids =
+      assigned_task_ids_.load(std::memory_order_relaxed);
+  unsigned task_id;
+  do {
+    // There are never more than kMaxConcurrency workers running.
+    CR_DCHECK(~assigned_task_ids);
+    task_id = bits::CountTrailingZeroBits(~assigned_task_ids);
+  } while (!assigned_task_ids_.compare_exchange_weak(
+      assigned_task_ids, assigned_task_ids | (uint64_t(1) << task_id),
+      std::memory_order_acquire, std::memory_order_relaxed));
+  return static_cast<uint8_t>(task_id);
+}
+
+void JobTaskSource::ReleaseTaskId(uint8_t task_id) {
+  CR_DCHECK(task_id < kMaxConcurrency);
+  assigned_task_ids_.fetch_and(~(uint64_t(1) << task_id),
+                               std::memory_order_release);
+}
+
+size_t JobTaskSource::GetMaxConcurrency(size_t num_running) const {
+  return std::min(max_concurrency_callback_.Run(num_running),
+                  kMaxConcurrency);
+}
+
+bool JobTaskSource::MaybePostWorkers() {
+  if (is_canceled_.load(std::memory_order_relaxed))
+    return true;
+  // Not called with |lock_| held: the callback may take locks of its own,
+  // which the worker task may hold while calling NotifyConcurrencyIncrease().
+  const size_t max_concurrency = GetMaxConcurrency(num_running_.load());
+
+  size_t num_to_post = 0;
+  {
+    AutoLock auto_lock(lock_);
+    if (is_joined_)
+      return true;
+    const size_t num_workers = num_running_.load() + num_posted_;
+    if (max_concurrency > num_workers)
+      num_to_post = max_concurrency - num_workers;
+    num_posted_ += num_to_post;
+  }
+
+  size_t num_failed = 0;
+  for (size_t i = 0; i < num_to_post; ++i) {
+    if (!executor_->PostDelayedTask(
+            from_here_, traits_,
+            BindOnce(&JobTaskSource::RunPostedWorker,
+                     RefPtr<JobTaskSource>(this)),
+            TimeDelta())) {
+      // Shutdown started: posting the others would fail as well.
+      num_failed = num_to_post - i;
+      break;
+    }
+  }
+  if (!num_failed)
+    return true;
+  AutoLock auto_lock(lock_);
+  num_posted_ -= num_failed;
+  return false;
+}
+
+void JobTaskSource::RunPostedWorker() {
+  {
+    AutoLock auto_lock(lock_);
+    CR_DCHECK(num_posted_ > 0);
+    --num_posted_;
+    if (is_joined_)
+      return;
+    ++num_started_;
+  }
+  // Hand the thread over to the work of higher priority, and resume after it.
+  if (RunWorker(/*is_joining_thread=*/false))
+    MaybePostWorkers();
+
+  AutoLock auto_lock(lock_);
+  if (--num_started_ == 0)
+    join_cv_.Broadcast();
+}
+
+bool JobTaskSource::RunWorker(bool is_joining_thread) {
+  while (TryStartWorker()) {
+    {
+      JobDelegate delegate(this, is_joining_thread);
+      worker_task_.Run(&delegate);
+    }
+    DidRunWorker();
+    if (ShouldYield(is_joining_thread))
+      return true;
+  }
+  return false;
+}
+
+bool JobTaskSource::TryStartWorker() {
+  size_t num_running = num_running_.load();
+  while (true) {
+    if (is_canceled_.load(std::memory_order_relaxed))
+      return false;
+    if (num_running >= GetMaxConcurrency(num_running))
+      return false;
+    if (num_running_.compare_exchange_weak(num_running, num_running + 1))
+      return true;
+  }
+}
+
+void JobTaskSource::DidRunWorker() {
+  if (num_running_.fetch_sub(1) != 1)
+    return;
+  AutoLock auto_lock(lock_);
+  join_cv_.Broadcast();
+}
+
+}  // namespace internal
+}  // namespace cr
@@ -0,0 +1,123 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MINI_CHROMIUM_SRC_CREVENT_TASK_INTERNAL_JOB_TASK_SOURCE_H_
+#define MINI_CHROMIUM_SRC_CREVENT_TASK_INTERNAL_JOB_TASK_SOURCE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+#include "cr_base/functional/callback.h"
+#include "cr_base/location.h"
+#include "cr_base/memory/ref_counted.h"
+#include "cr_base/synchronization/condition_variable.h"
+#include "cr_base/synchronization/lock.h"
+
+#include "cr_event/event_export.h"
+#include "cr_event/task/task_traits.h"
+
+namespace cr {
+
+class JobDelegate;
+class TaskExecutor;
+
+namespace internal {
+
+// The state of a job posted with PostJob(), shared by its JobHandle and its
+// workers.
+//
+// A worker is a task posted to |executor|, which runs the worker task over and
+// over while the job has work for one more worker, then returns. It posts
+// itself again when it yields to work of a higher priority, so that it
+// resumes after that work.
+class CREVENT_EXPORT JobTaskSource
+    : public RefCountedThreadSafe<JobTaskSource> {
+ public:
+  // Bounded by the bits of |assigned_task_ids_|.
+  static constexpr size_t kMaxConcurrency = 64;
+
+  JobTaskSource(const Location& from_here,
+                const TaskTraits& traits,
+                RepeatingCallback<void(JobDelegate*)> worker_task,
+                RepeatingCallback<size_t(size_t)> max_concurrency_callback,
+                TaskExecutor* executor);
+  JobTaskSource(const JobTaskSource&) = delete;
+  JobTaskSource& operator=(const JobTaskSource&) = delete;
+
+  // Posts workers for the work the job has. Returns false if none could be
+  // posted because of shutdown.
+  bool Start();
+
+  // See JobHandle.
+  bool IsActive() const;
+  void NotifyConcurrencyIncrease();
+  void Join();
+  void Cancel();
+
+  // See JobDelegate.
+  bool ShouldYield(bool is_joining_thread) const;
+  uint8_t AcquireTaskId();
+  void ReleaseTaskId(uint8_t task_id);
+
+ private:
+  friend class RefCountedThreadSafe<JobTaskSource>;
+
+  ~JobTaskSource();
+
+  // Returns the number of workers the job has work for, given |num_running|.
+  size_t GetMaxConcurrency(size_t num_running) const;
+
+  // Posts as many workers as the job has work for, on top of those running or
+  // posted. Returns false if one couldn't be posted because of shutdown.
+  bool MaybePostWorkers();
+
+  // The task of a posted worker.
+  void RunPostedWorker();
+
+  // Runs the worker task while the job has work for one more worker. Returns
+  // true if the worker task yielded.
+  bool RunWorker(bool is_joining_thread);
+
+  // Counts one more running worker if the job has work for it.
+  bool TryStartWorker();
+  void DidRunWorker();
+
+  const Location from_here_;
+  const TaskTraits traits_;
+  const RepeatingCallback<void(JobDelegate*)> worker_task_;
+  const RepeatingCallback<size_t(size_t)> max_concurrency_callback_;
+  TaskExecutor* const executor_;
+
+  std::atomic<bool> is_canceled_{false};
+
+  // Workers running the worker task, including the joining thread.
+  std::atomic<size_t> num_running_{0};
+
+  // Bit |n| is set while a worker has the task id |n|.
+  std::atomic<uint64_t> assigned_task_ids_{0};
+
+  // Protects the members below it.
+  mutable Lock lock_;
+
+  // Join() waits on this for the workers to be done, or for more work.
+  ConditionVariable join_cv_;
+  bool join_wake_up_ = false;
+
+  // Workers posted which haven't started yet.
+  size_t num_posted_ = 0;
+
+  // Posted workers which started and haven't returned yet, i.e. which may
+  // still call the callbacks.
+  size_t num_started_ = 0;
+
+  // Set by Join(), after which posted workers no longer call the callbacks.
+  bool is_joined_ = false;
+};
+
+}  // namespace internal
+}  // namespace cr
+
+#endif  // MINI_CHROMIUM_SRC_CREVENT_TASK_INTERNAL_JOB_TASK_SOURCE_H_
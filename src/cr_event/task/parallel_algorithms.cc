@@ -0,0 +1,105 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cr_event/task/parallel_algorithms.h"
+
+#include <algorithm>
+
+#include "cr_base/functional/bind.h"
+
+#include "cr_event/task/internal/job_task_source.h"
+#include "cr_event/task/post_job.h"
+#include "cr_event/task/task_executor.h"
+
+namespace cr {
+namespace internal {
+
+namespace {
+
+// A claim takes this fraction of the elements left, per worker, so that the
+// last chunks are small enough for all workers to finish close together.
+constexpr size_t kChunksPerWorker = 4;
+
+size_t ComputeMaxNumWorkers(const TaskTraits& traits,
+                            TaskExecutor* executor,
+                            size_t size,
+                            size_t grain_size) {
+  if (!executor)
+    return 1;
+  const size_t num_workers = executor->GetMaxConcurrentNonBlockedTasks(traits);
+  const size_t num_chunks = (size + grain_size - 1) / grain_size;
+  return std::max<size_t>(
+      std::min({num_workers, num_chunks, JobTaskSource::kMaxConcurrency}), 1);
+}
+
+}  // namespace
+
+ParallelLoop::ParallelLoop(const TaskTraits& traits,
+                           size_t size,
+                           size_t grain_size,
+                           ProcessChunkFunction process_chunk,
+                           void* context)
+    : traits_(traits),
+      executor_(GetRegisteredTaskExecutorForTraits(traits)),
+      size_(size),
+      grain_size_(std::max<size_t>(grain_size, 1)),
+      process_chunk_(process_chunk),
+      context_(context),
+      max_num_workers_(
+          ComputeMaxNumWorkers(traits_, executor_, size_, grain_size_)) {}
+
+ParallelLoop::~ParallelLoop() = default;
+
+void ParallelLoop::Run() {
+  if (size_ <= grain_size_ || !executor_) {
+    if (size_)
+      process_chunk_(context_, 0, size_, 0);
+    return;
+  }
+
+  // Unretained() is safe: once Join() returns, the job no longer calls its
+  // callbacks, not even from workers which were posted but start later.
+  JobHandle handle = PostJob(
+      CR_FROM_HERE, traits_,
+      BindRepeating(&ParallelLoop::RunWorker, Unretained(this)),
+      BindRepeating(&ParallelLoop::GetMaxConcurrency, Unretained(this)));
+  handle.Join();
+}
+
+void ParallelLoop::RunWorker(JobDelegate* delegate) {
+  const uint8_t worker_id = delegate->GetTaskId();
+  CR_DCHECK(worker_id < max_num_workers_);
+  size_t begin;
+  size_t end;
+  while (!delegate->ShouldYield() && ClaimChunk(&begin, &end))
+    process_chunk_(context_, begin, end, worker_id);
+}
+
+size_t ParallelLoop::GetMaxConcurrency(size_t worker_count) const {
+  const size_t next = std::min(next_.load(std::memory_order_relaxed), size_);
+  // Overestimated, since chunks are larger than the grain size until the end.
+  const size_t num_chunks_left = (size_ - next + grain_size_ - 1) / grain_size_;
+  return std::min(worker_count + num_chunks_left, max_num_workers_);
+}
+
+bool ParallelLoop::ClaimChunk(size_t* begin, size_t* end) {
+  size_t next = next_.load(std::memory_order_relaxed);
+  size_t chunk_size;
+  do {
+    if (next >= size_)
+      return false;
+    const size_t num_left = size_ - next;
+    chunk_size = std::min(
+        std::max(num_left / (max_num_workers_ * kChunksPerWorker),
+                 grain_size_),
+        num_left);
+  } while (!next_.compare_exchange_weak(next, next + chunk_size,
+                                        std::memory_order_relaxed));
+  *begin = next;
+  *end = next + chunk_size;
+  return true;
+}
+
+}  // namespace internal
+}  // namespace cr
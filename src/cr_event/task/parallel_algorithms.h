@@ -0,0 +1,209 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MINI_CHROMIUM_SRC_CREVENT_TASK_PARALLEL_ALGORITHMS_H_
+#define MINI_CHROMIUM_SRC_CREVENT_TASK_PARALLEL_ALGORITHMS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include "cr_base/containers/span.h"
+#include "cr_base/logging/logging.h"
+
+#include "cr_event/event_export.h"
+#include "cr_event/task/task_traits.h"
+
+namespace cr {
+
+class JobDelegate;
+class TaskExecutor;
+
+namespace internal {
+
+// Runs a loop over [0, size) on the workers of a job, and on the calling
+// thread, handing out chunks of the range as the workers ask for them: large
+// ones first, then smaller ones down to |grain_size|, so that workers which
+// start late, or get preempted, still find work to balance the load with.
+class CREVENT_EXPORT ParallelLoop {
+ public:
+  // Processes [begin, end). |worker_id| is below GetMaxNumWorkers(), and no
+  // other chunk is processed concurrently with the same one.
+  using ProcessChunkFunction = void (*)(void* context,
+                                        size_t begin,
+                                        size_t end,
+                                        uint8_t worker_id);
+
+  // The workers are posted with |traits|, and there are no more of them than
+  // the executor which handles |traits| runs tasks concurrently.
+  ParallelLoop(const TaskTraits& traits,
+               size_t size,
+               size_t grain_size,
+               ProcessChunkFunction process_chunk,
+               void* context);
+  ParallelLoop(const ParallelLoop&) = delete;
+  ParallelLoop& operator=(const ParallelLoop&) = delete;
+  ~ParallelLoop();
+
+  size_t GetMaxNumWorkers() const { return max_num_workers_; }
+
+  // Returns once the whole range is processed. Runs it on the calling thread
+  // alone if it's a single chunk, or if no executor handles the traits.
+  void Run();
+
+ private:
+  void RunWorker(JobDelegate* delegate);
+  size_t GetMaxConcurrency(size_t worker_count) const;
+  bool ClaimChunk(size_t* begin, size_t* end);
+
+  const TaskTraits traits_;
+  TaskExecutor* const executor_;
+  const size_t size_;
+  const size_t grain_size_;
+  const ProcessChunkFunction process_chunk_;
+  void* const context_;
+  const size_t max_num_workers_;
+
+  std::atomic<size_t> next_{0};
+};
+
+template <typename T, typename Function>
+struct ParallelForContext {
+  static void ProcessChunk(void* context,
+                           size_t begin,
+                           size_t end,
+                           uint8_t worker_id) {
+    auto* self = static_cast<ParallelForContext*>(context);
+    for (size_t i = begin; i < end; ++i)
+      self->function(self->span[i]);
+  }
+
+  Span<T> span;
+  Function& function;
+};
+
+template <typename T, typename U, typename Function>
+struct ParallelTransformContext {
+  static void ProcessChunk(void* context,
+                           size_t begin,
+                           size_t end,
+                           uint8_t worker_id) {
+    auto* self = static_cast<ParallelTransformContext*>(context);
+    for (size_t i = begin; i < end; ++i)
+      self->output[i] = self->function(self->input[i]);
+  }
+
+  Span<T> input;
+  Span<U> output;
+  Function& function;
+};
+
+template <typename T, typename R, typename ReduceFunction,
+          typename CombineFunction>
+struct ParallelReduceContext {
+  static void ProcessChunk(void* context,
+                           size_t begin,
+                           size_t end,
+                           uint8_t worker_id) {
+    auto* self = static_cast<ParallelReduceContext*>(context);
+    // Reduced apart from the partial result, which only this worker touches
+    // but which shares cache lines with those of the others.
+    R result = self->identity;
+    for (size_t i = begin; i < end; ++i)
+      result = self->reduce(std::move(result), self->span[i]);
+    R& partial_result = self->partial_results[worker_id];
+    partial_result =
+        self->combine(std::move(partial_result), std::move(result));
+  }
+
+  Span<T> span;
+  const R& identity;
+  ReduceFunction& reduce;
+  CombineFunction& combine;
+  std::vector<R> partial_results;
+};
+
+}  // namespace internal
+
+// Parallel algorithms over a Span, run by a job (see PostJob()) with |traits|
+// on the ThreadPool, to which the calling thread lends a hand rather than
+// just blocking until it's done. |grain_size| is the smallest number of
+// elements worth handing to a worker: large enough for processing them to
+// dwarf the cost of an atomic operation, a few microseconds' worth.
+//
+// The functions passed are called concurrently from several threads, so must
+// be thread-safe, and are called for the elements in no particular order.
+
+// Calls |function|(element) for each element of |span|.
+//
+//   ParallelFor({TaskPriority::USER_BLOCKING}, MakeSpan(records), 1024,
+//               [](Record& record) { record.Normalize(); });
+template <typename T, typename Function>
+void ParallelFor(const TaskTraits& traits,
+                 Span<T> span,
+                 size_t grain_size,
+                 Function function) {
+  using Context = internal::ParallelForContext<T, Function>;
+  Context context{span, function};
+  internal::ParallelLoop(traits, span.size(), grain_size,
+                         &Context::ProcessChunk, &context)
+      .Run();
+}
+
+// Sets |output|[i] to |function|(|input|[i]) for each element of |input|.
+// |output| must be as large as |input|.
+template <typename T, typename U, typename Function>
+void ParallelTransform(const TaskTraits& traits,
+                       Span<T> input,
+                       Span<U> output,
+                       size_t grain_size,
+                       Function function) {
+  CR_DCHECK(output.size() >= input.size());
+  using Context = internal::ParallelTransformContext<T, U, Function>;
+  Context context{input, output, function};
+  internal::ParallelLoop(traits, input.size(), grain_size,
+                         &Context::ProcessChunk, &context)
+      .Run();
+}
+
+// Returns the reduction of the elements of |span|: chunks of them are folded
+// into |identity| with |reduce|(result, element), and the results of the
+// chunks are then merged with |combine|(result, result). Since chunks are
+// neither processed nor merged in order, |combine| must be associative and
+// commutative, e.g. a sum or an XOR of checksums.
+//
+//   uint64_t total_size = ParallelReduce(
+//       {TaskPriority::USER_VISIBLE}, MakeSpan(files), 4096, uint64_t(0),
+//       [](uint64_t size, const File& file) { return size + file.size(); },
+//       [](uint64_t a, uint64_t b) { return a + b; });
+template <typename T,
+          typename R,
+          typename ReduceFunction,
+          typename CombineFunction>
+R ParallelReduce(const TaskTraits& traits,
+                 Span<T> span,
+                 size_t grain_size,
+                 R identity,
+                 ReduceFunction reduce,
+                 CombineFunction combine) {
+  using Context = internal::ParallelReduceContext<T, R, ReduceFunction,
+                                                  CombineFunction>;
+  Context context{span, identity, reduce, combine, {}};
+  internal::ParallelLoop loop(traits, span.size(), grain_size,
+                              &Context::ProcessChunk, &context);
+  context.partial_results.assign(loop.GetMaxNumWorkers(), identity);
+  loop.Run();
+
+  R result = std::move(identity);
+  for (R& partial_result : context.partial_results)
+    result = combine(std::move(result), std::move(partial_result));
+  return result;
+}
+
+}  // namespace cr
+
+#endif  // MINI_CHROMIUM_SRC_CREVENT_TASK_PARALLEL_ALGORITHMS_H_
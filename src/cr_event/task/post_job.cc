@@ -0,0 +1,105 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cr_event/task/post_job.h"
+
+#include <utility>
+
+#include "cr_base/logging/logging.h"
+
+#include "cr_event/task/internal/job_task_source.h"
+#include "cr_event/task/task_executor.h"
+
+namespace cr {
+
+JobDelegate::JobDelegate(internal::JobTaskSource* task_source,
+                         bool is_joining_thread)
+    : task_source_(task_source), is_joining_thread_(is_joining_thread) {}
+
+JobDelegate::~JobDelegate() {
+  if (has_task_id_)
+    task_source_->ReleaseTaskId(task_id_);
+}
+
+bool JobDelegate::ShouldYield() {
+  if (!should_yield_)
+    should_yield_ = task_source_->ShouldYield(is_joining_thread_);
+  return should_yield_;
+}
+
+void JobDelegate::NotifyConcurrencyIncrease() {
+  task_source_->NotifyConcurrencyIncrease();
+}
+
+uint8_t JobDelegate::GetTaskId() {
+  if (!has_task_id_) {
+    task_id_ = task_source_->AcquireTaskId();
+    has_task_id_ = true;
+  }
+  return task_id_;
+}
+
+JobHandle::JobHandle() = default;
+
+JobHandle::JobHandle(RefPtr<internal::JobTaskSource> task_source)
+    : task_source_(std::move(task_source)) {}
+
+JobHandle::JobHandle(JobHandle&& other) = default;
+
+JobHandle& JobHandle::operator=(JobHandle&& other) {
+  CR_DCHECK(!task_source_)
+      << "The job must be joined, canceled or detached first.";
+  task_source_ = std::move(other.task_source_);
+  return *this;
+}
+
+JobHandle::~JobHandle() {
+  CR_DCHECK(!task_source_)
+      << "The job must be joined, canceled or detached first.";
+}
+
+bool JobHandle::IsActive() const {
+  return task_source_->IsActive();
+}
+
+void JobHandle::NotifyConcurrencyIncrease() {
+  task_source_->NotifyConcurrencyIncrease();
+}
+
+void JobHandle::Join() {
+  task_source_->Join();
+  task_source_ = nullptr;
+}
+
+void JobHandle::Cancel() {
+  task_source_->Cancel();
+  Join();
+}
+
+void JobHandle::CancelAndDetach() {
+  task_source_->Cancel();
+  Detach();
+}
+
+void JobHandle::Detach() {
+  CR_DCHECK(task_source_);
+  task_source_ = nullptr;
+}
+
+JobHandle PostJob(const Location& from_here,
+                  const TaskTraits& traits,
+                  RepeatingCallback<void(JobDelegate*)> worker_task,
+                  RepeatingCallback<size_t(size_t)> max_concurrency_callback) {
+  TaskExecutor* executor = GetRegisteredTaskExecutorForTraits(traits);
+  CR_DCHECK(executor) << "No TaskExecutor for the traits of the job.";
+  auto task_source = MakeRefCounted<internal::JobTaskSource>(
+      from_here, traits, std::move(worker_task),
+      std::move(max_concurrency_callback), executor);
+  // Should no worker be posted because of shutdown, Join() still runs the
+  // job on the calling thread.
+  task_source->Start();
+  return JobHandle(std::move(task_source));
+}
+
+}  // namespace cr
@@ -0,0 +1,144 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MINI_CHROMIUM_SRC_CREVENT_TASK_POST_JOB_H_
+#define MINI_CHROMIUM_SRC_CREVENT_TASK_POST_JOB_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cr_base/functional/callback.h"
+#include "cr_base/location.h"
+#include "cr_base/memory/ref_counted.h"
+
+#include "cr_event/event_export.h"
+#include "cr_event/task/task_traits.h"
+
+namespace cr {
+
+namespace internal {
+class JobTaskSource;
+}  // namespace internal
+
+// Passed to the worker task of a job, for it to find out whether it should
+// return early.
+class CREVENT_EXPORT JobDelegate {
+ public:
+  JobDelegate(internal::JobTaskSource* task_source, bool is_joining_thread);
+  JobDelegate(const JobDelegate&) = delete;
+  JobDelegate& operator=(const JobDelegate&) = delete;
+  ~JobDelegate();
+
+  // Returns true if the worker task should return as soon as possible: the
+  // job was canceled, or work of a higher priority is waiting for the thread.
+  // The worker task is run again later if the job still has work then. Keeps
+  // returning true once it did.
+  bool ShouldYield();
+
+  // Notifies the job that its maximum concurrency increased, e.g. because the
+  // worker task produced more work, for it to start more workers.
+  void NotifyConcurrencyIncrease();
+
+  // Returns an id, below the maximum concurrency, which no other worker of
+  // the job running concurrently has. E.g. to index per-worker state.
+  uint8_t GetTaskId();
+
+  // Returns true if the worker task runs on the thread which called
+  // JobHandle::Join().
+  bool IsJoiningThread() const { return is_joining_thread_; }
+
+ private:
+  internal::JobTaskSource* const task_source_;
+  const bool is_joining_thread_;
+  bool should_yield_ = false;
+  uint8_t task_id_;
+  bool has_task_id_ = false;
+};
+
+// Controls a job posted with PostJob(). The job must have been joined,
+// canceled or detached before the handle is destroyed.
+class CREVENT_EXPORT JobHandle {
+ public:
+  JobHandle();
+  // Used by PostJob().
+  explicit JobHandle(RefPtr<internal::JobTaskSource> task_source);
+  JobHandle(JobHandle&& other);
+  JobHandle& operator=(JobHandle&& other);
+  ~JobHandle();
+
+  explicit operator bool() const { return task_source_ != nullptr; }
+
+  // Returns true if the job may still run its worker task, i.e. it wasn't
+  // canceled and either has work or has workers running.
+  bool IsActive() const;
+
+  // Same as JobDelegate::NotifyConcurrencyIncrease(), from outside the job.
+  void NotifyConcurrencyIncrease();
+
+  // Runs the worker task on the calling thread too, for as long as the job
+  // has work, then waits for the workers still running. Unlike the workers,
+  // the calling thread doesn't yield to work of higher priority, since it's
+  // blocked on the job anyway. Once it returns, the callbacks of the job are
+  // no longer called, so what they're bound to may be destroyed.
+  void Join();
+
+  // Cancels the job and waits for the workers still running, as Join() does.
+  // Their JobDelegate::ShouldYield() returns true from now on.
+  void Cancel();
+
+  // Cancels the job without waiting for the workers still running. The
+  // callbacks must stay valid until they return, e.g. by owning their state.
+  void CancelAndDetach();
+
+  // Lets the job run to completion on its own, with the same requirement.
+  void Detach();
+
+ private:
+  RefPtr<internal::JobTaskSource> task_source_;
+};
+
+// Posts a job, which runs |worker_task| on as many threads of the executor
+// handling |traits|, typically the ThreadPool, as it has work for. Fanning a
+// loop out with a job rather than with a task per item costs a task per
+// worker, and doesn't oversubscribe the pool when it's busy: a worker runs
+// |worker_task| over and over until there's no work left for it, yielding
+// its thread to work of a higher priority than |traits|.
+//
+// |max_concurrency_callback| returns the number of workers the job has work
+// for, given the number of workers currently running |worker_task|; it's
+// called on any thread, so must be thread-safe. The job is done once it
+// returns 0. A job runs on at most internal::JobTaskSource::kMaxConcurrency
+// workers.
+//
+// |worker_task| processes work items until it runs out of them, or until
+// JobDelegate::ShouldYield() returns true:
+//
+//   JobHandle handle = PostJob(
+//       CR_FROM_HERE, {TaskPriority::USER_VISIBLE},
+//       BindRepeating(&WorkQueue::ProcessItems, Unretained(&work_queue)),
+//       BindRepeating(&WorkQueue::GetMaxConcurrency,
+//                     Unretained(&work_queue)));
+//   handle.Join();
+//
+//   void WorkQueue::ProcessItems(JobDelegate* delegate) {
+//     while (!delegate->ShouldYield()) {
+//       Optional<Item> item = TakeItem();
+//       if (!item)
+//         return;
+//       Process(*item);
+//     }
+//   }
+//
+//   size_t WorkQueue::GetMaxConcurrency(size_t worker_count) const {
+//     return num_items_left_.load(std::memory_order_relaxed);
+//   }
+CREVENT_EXPORT JobHandle
+PostJob(const Location& from_here,
+        const TaskTraits& traits,
+        RepeatingCallback<void(JobDelegate*)> worker_task,
+        RepeatingCallback<size_t(size_t)> max_concurrency_callback);
+
+}  // namespace cr
+
+#endif  // MINI_CHROMIUM_SRC_CREVENT_TASK_POST_JOB_H_
@@ -0,0 +1,171 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cr_event/task/sequence_manager/cpu_time_budget_pool.h"
+
+#include <inttypes.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "cr_base/functional/bind.h"
+#include "cr_base/logging/logging.h"
+#include "cr_base/strings/stringprintf.h"
+
+#include "cr_event/task/sequence_manager/task_queue_impl.h"
+
+namespace cr {
+namespace sequence_manager {
+
+std::string CPUTimeBudgetPool::State::ToString() const {
+  return StringPrintf(
+      "%s: %" PRId64 "us of %" PRId64 "us per %" PRId64 "us left%s, "
+      "%" PRId64 "us used, throttled %" PRIu64 " times for %" PRId64 "us",
+      name, current_budget.InMicroseconds(), budget.InMicroseconds(),
+      window.InMicroseconds(), is_throttled ? " (throttled)" : "",
+      cpu_time_used.InMicroseconds(), throttle_count,
+      throttled_duration.InMicroseconds());
+}
+
+CPUTimeBudgetPool::CPUTimeBudgetPool(
+    const char* name,
+    TimeDelta budget,
+    TimeDelta window,
+    RefPtr<SingleThreadTaskRunner> control_task_runner,
+    const TickClock* tick_clock)
+    : name_(name),
+      budget_(budget),
+      window_(window),
+      control_task_runner_(std::move(control_task_runner)),
+      tick_clock_(tick_clock),
+      current_budget_(budget),
+      last_update_time_(tick_clock_->NowTicks()) {
+  CR_DCHECK(budget_ > TimeDelta());
+  CR_DCHECK(window_ >= budget_);
+  CR_DCHECK(control_task_runner_);
+}
+
+CPUTimeBudgetPool::~CPUTimeBudgetPool() {
+  CR_DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  while (!queues_.empty())
+    RemoveQueue(queues_.begin()->first);
+}
+
+void CPUTimeBudgetPool::AddQueue(TaskQueue* queue) {
+  CR_DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  internal::TaskQueueImpl* queue_impl = queue->GetTaskQueueImpl();
+  if (!queue_impl)
+    return;
+  CR_DCHECK(!queue_impl->budget_pool());
+  queue_impl->SetBudgetPool(this);
+
+  std::unique_ptr<TaskQueue::QueueEnabledVoter> voter =
+      queue->CreateQueueEnabledVoter();
+  if (is_throttled_)
+    voter->SetVoteToEnable(false);
+  queues_.emplace(queue, std::move(voter));
+}
+
+void CPUTimeBudgetPool::RemoveQueue(TaskQueue* queue) {
+  CR_DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  auto it = queues_.find(queue);
+  if (it == queues_.end())
+    return;
+  internal::TaskQueueImpl* queue_impl = queue->GetTaskQueueImpl();
+  if (queue_impl) {
+    CR_DCHECK(queue_impl->budget_pool() == this);
+    queue_impl->SetBudgetPool(nullptr);
+  }
+  // Destroying the voter withdraws its vote to disable the queue.
+  queues_.erase(it);
+}
+
+CPUTimeBudgetPool::State CPUTimeBudgetPool::GetState() const {
+  CR_DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  const TimeTicks now = tick_clock_->NowTicks();
+
+  State state;
+  state.name = name_;
+  state.budget = budget_;
+  state.window = window_;
+  state.current_budget = GetBudgetAt(now);
+  state.is_throttled = is_throttled_;
+  if (is_throttled_)
+    state.unthrottle_time = unthrottle_time_;
+  state.cpu_time_used = cpu_time_used_;
+  state.throttle_count = throttle_count_;
+  state.throttled_duration = throttled_duration_;
+  if (is_throttled_)
+    state.throttled_duration += now - throttle_start_time_;
+  return state;
+}
+
+void CPUTimeBudgetPool::RecordTaskRunTime(TimeDelta cpu_time, TimeTicks now) {
+  CR_DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  UpdateBudget(now);
+  current_budget_ -= cpu_time;
+  cpu_time_used_ += cpu_time;
+  if (!is_throttled_ && current_budget_ < TimeDelta())
+    Throttle(now);
+}
+
+TimeDelta CPUTimeBudgetPool::GetBudgetAt(TimeTicks now) const {
+  if (now <= last_update_time_)
+    return current_budget_;
+  const TimeDelta recovered_budget = TimeDelta::FromMicrosecondsD(
+      (now - last_update_time_).InMicrosecondsF() * (budget_ / window_));
+  return std::min(budget_, current_budget_ + recovered_budget);
+}
+
+void CPUTimeBudgetPool::UpdateBudget(TimeTicks now) {
+  current_budget_ = GetBudgetAt(now);
+  last_update_time_ = std::max(last_update_time_, now);
+}
+
+void CPUTimeBudgetPool::Throttle(TimeTicks now) {
+  is_throttled_ = true;
+  throttle_start_time_ = now;
+  ++throttle_count_;
+  SetQueuesEnabled(false);
+  ScheduleUnthrottle(now);
+}
+
+void CPUTimeBudgetPool::ScheduleUnthrottle(TimeTicks now) {
+  CR_DCHECK(current_budget_ < TimeDelta());
+  // Round up, lest the timer fires just before the budget recovers.
+  const TimeDelta delay =
+      TimeDelta::FromMicroseconds(
+          static_cast<int64_t>(-current_budget_.InMicrosecondsF() *
+                               (window_ / budget_))) +
+      TimeDelta::FromMicroseconds(1);
+  unthrottle_time_ = now + delay;
+  control_task_runner_->PostDelayedTask(
+      CR_FROM_HERE,
+      BindOnce(&CPUTimeBudgetPool::OnUnthrottleTimer,
+               weak_factory_.GetWeakPtr()),
+      delay);
+}
+
+void CPUTimeBudgetPool::OnUnthrottleTimer() {
+  CR_DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  CR_DCHECK(is_throttled_);
+  const TimeTicks now = tick_clock_->NowTicks();
+  UpdateBudget(now);
+  if (current_budget_ < TimeDelta()) {
+    ScheduleUnthrottle(now);
+    return;
+  }
+
+  is_throttled_ = false;
+  throttled_duration_ += now - throttle_start_time_;
+  SetQueuesEnabled(true);
+}
+
+void CPUTimeBudgetPool::SetQueuesEnabled(bool enabled) {
+  for (auto& queue : queues_)
+    queue.second->SetVoteToEnable(enabled);
+}
+
+}  // namespace sequence_manager
+}  // namespace cr
@@ -0,0 +1,131 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MINI_CHROMIUM_SRC_CREVENT_TASK_SEQUENCE_MANAGER_CPU_TIME_BUDGET_POOL_H_
+#define MINI_CHROMIUM_SRC_CREVENT_TASK_SEQUENCE_MANAGER_CPU_TIME_BUDGET_POOL_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "cr_base/memory/ref_counted.h"
+#include "cr_base/memory/weak_ptr.h"
+#include "cr_base/time/time.h"
+
+#include "cr_event/event_export.h"
+#include "cr_event/task/sequence_manager/task_queue.h"
+#include "cr_event/threading/thread_checker.h"
+#include "cr_event/time/tick_clock.h"
+
+namespace cr {
+namespace sequence_manager {
+
+// Limits the CPU time which the tasks of a set of TaskQueues may use to
+// |budget| per |window|, e.g. to keep background work from delaying latency
+// sensitive tasks run on the same thread:
+//
+//   CPUTimeBudgetPool pool("background", TimeDelta::FromMilliseconds(10),
+//                          TimeDelta::FromMilliseconds(100),
+//                          control_task_runner);
+//   pool.AddQueue(compaction_queue.get());
+//   pool.AddQueue(metrics_queue.get());
+//
+// The budget is a token bucket: it recovers continuously at |budget| per
+// |window|, up to |budget|, and each task of the queues is charged the thread
+// time it ran for, or its wall time where ThreadTicks aren't supported. A task
+// always runs to completion, so the budget can go negative: the queues are
+// then disabled, which defers their wake-ups too, until the budget recovers.
+//
+// Must be used on the thread the queues run on, and outlived by them.
+class CREVENT_EXPORT CPUTimeBudgetPool {
+ public:
+  struct CREVENT_EXPORT State {
+    // Returns a one-line summary, for logs.
+    std::string ToString() const;
+
+    const char* name = "";
+    TimeDelta budget;
+    TimeDelta window;
+
+    // CPU time the queues may use before being throttled, negative while
+    // they are.
+    TimeDelta current_budget;
+
+    bool is_throttled = false;
+
+    // When the queues are due to run again, if throttled.
+    TimeTicks unthrottle_time;
+
+    // Totals since the pool was created.
+    TimeDelta cpu_time_used;
+    uint64_t throttle_count = 0;
+    TimeDelta throttled_duration;
+  };
+
+  // |control_task_runner| runs the task which unthrottles the queues, so must
+  // run on their thread, and not be throttled itself.
+  CPUTimeBudgetPool(const char* name,
+                    TimeDelta budget,
+                    TimeDelta window,
+                    RefPtr<SingleThreadTaskRunner> control_task_runner,
+                    const TickClock* tick_clock = TickClock::GetDefault());
+  CPUTimeBudgetPool(const CPUTimeBudgetPool&) = delete;
+  CPUTimeBudgetPool& operator=(const CPUTimeBudgetPool&) = delete;
+
+  // Removes all the queues, which get enabled again.
+  ~CPUTimeBudgetPool();
+
+  // A queue belongs to a pool at most.
+  void AddQueue(TaskQueue* queue);
+  void RemoveQueue(TaskQueue* queue);
+
+  State GetState() const;
+
+  bool IsThrottled() const { return is_throttled_; }
+
+  // Charges |cpu_time| to the budget, as of |now|. Called by the queues'
+  // SequenceManager after each of their tasks.
+  void RecordTaskRunTime(TimeDelta cpu_time, TimeTicks now);
+
+ private:
+  // Returns the budget as of |now|, which recovers from the last update.
+  TimeDelta GetBudgetAt(TimeTicks now) const;
+  void UpdateBudget(TimeTicks now);
+
+  void Throttle(TimeTicks now);
+  void ScheduleUnthrottle(TimeTicks now);
+  void OnUnthrottleTimer();
+
+  void SetQueuesEnabled(bool enabled);
+
+  const char* const name_;
+  const TimeDelta budget_;
+  const TimeDelta window_;
+  const RefPtr<SingleThreadTaskRunner> control_task_runner_;
+  const TickClock* const tick_clock_;
+
+  std::map<TaskQueue*, std::unique_ptr<TaskQueue::QueueEnabledVoter>> queues_;
+
+  TimeDelta current_budget_;
+  TimeTicks last_update_time_;
+
+  bool is_throttled_ = false;
+  TimeTicks throttle_start_time_;
+  TimeTicks unthrottle_time_;
+
+  TimeDelta cpu_time_used_;
+  uint64_t throttle_count_ = 0;
+  TimeDelta throttled_duration_;
+
+  CR_THREAD_CHECKER(thread_checker_);
+
+  WeakPtrFactory<CPUTimeBudgetPool> weak_factory_{this};
+};
+
+}  // namespace sequence_manager
+}  // namespace cr
+
+#endif  // MINI_CHROMIUM_SRC_CREVENT_TASK_SEQUENCE_MANAGER_CPU_TIME_BUDGET_POOL_H_
@@ -0,0 +1,238 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cr_event/task/sequence_manager/delayed_task_timing_wheel.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include "cr_base/logging/logging.h"
+#include "cr_base/numerics/bits.h"
+
+namespace cr {
+namespace sequence_manager {
+namespace internal {
+
+namespace {
+
+static_assert(DelayedTaskTimingWheel::kNumSlots <= 64,
+              "Slot occupancy is tracked with a uint64_t per level");
+
+// Number of bits of a tick covered by the wheels.
+constexpr size_t kWheelBits =
+    DelayedTaskTimingWheel::kSlotBits * DelayedTaskTimingWheel::kNumLevels;
+
+bool IsTaskCancelled(const Task& task) {
+  return !task.task || task.task.IsCancelled();
+}
+
+// Moves the cancelled tasks of |tasks| to |cancelled_tasks|, without keeping
+// the order of |tasks|.
+void MoveCancelledTasks(std::vector<Task>* tasks,
+                        std::vector<Task>* cancelled_tasks) {
+  auto cancelled_begin = std::partition(
+      tasks->begin(), tasks->end(),
+      [](const Task& task) { return !IsTaskCancelled(task); });
+  std::move(cancelled_begin, tasks->end(),
+            std::back_inserter(*cancelled_tasks));
+  tasks->erase(cancelled_begin, tasks->end());
+}
+
+}  // namespace
+
+DelayedTaskTimingWheel::DelayedTaskTimingWheel() = default;
+DelayedTaskTimingWheel::~DelayedTaskTimingWheel() = default;
+
+void DelayedTaskTimingWheel::push(Task task) {
+  const uint64_t tick = GetTick(task);
+  if (empty()) {
+    // The wheels are empty too: start them from this task.
+    cursor_ = tick;
+  } else if (tick < cursor_) {
+    // Keep |due_| to the earliest tick rather than let it grow into a heap of
+    // all the tasks posted with a shorter delay than the earliest one, unless
+    // that moves too many tasks: then |due_| is the cheaper place.
+    const size_t level = GetLevel(tick);
+    if (level < kNumLevels && GetNumTasksToRewind(level) <= kMaxRewoundTasks)
+      Rewind(tick);
+  }
+  ++size_;
+  Insert(std::move(task), tick);
+}
+
+void DelayedTaskTimingWheel::pop() {
+  CR_DCHECK(!empty());
+  due_.pop();
+  --size_;
+  if (due_.empty() && size_)
+    Advance();
+}
+
+void DelayedTaskTimingWheel::swap(DelayedTaskTimingWheel* other) {
+  std::swap(due_, other->due_);
+  for (size_t level = 0; level < kNumLevels; ++level) {
+    for (size_t slot = 0; slot < kNumSlots; ++slot)
+      slots_[level][slot].swap(other->slots_[level][slot]);
+    std::swap(occupied_slots_[level], other->occupied_slots_[level]);
+  }
+  std::swap(level_sizes_, other->level_sizes_);
+  std::swap(overflow_, other->overflow_);
+  std::swap(cursor_, other->cursor_);
+  std::swap(size_, other->size_);
+}
+
+void DelayedTaskTimingWheel::RemoveCancelledTasks(
+    std::vector<Task>* cancelled_tasks) {
+  const size_t num_cancelled_tasks = cancelled_tasks->size();
+
+  due_.RemoveCancelledTasks(cancelled_tasks);
+  for (size_t level = 0; level < kNumLevels; ++level) {
+    for (size_t slot = 0; slot < kNumSlots; ++slot) {
+      if (!(occupied_slots_[level] & (uint64_t(1) << slot)))
+        continue;
+      const size_t slot_size = slots_[level][slot].size();
+      MoveCancelledTasks(&slots_[level][slot], cancelled_tasks);
+      level_sizes_[level] -= slot_size - slots_[level][slot].size();
+      if (slots_[level][slot].empty())
+        occupied_slots_[level] &= ~(uint64_t(1) << slot);
+    }
+  }
+  overflow_.RemoveCancelledTasks(cancelled_tasks);
+
+  size_ -= cancelled_tasks->size() - num_cancelled_tasks;
+  if (due_.empty() && size_)
+    Advance();
+}
+
+void DelayedTaskTimingWheel::TaskHeap::TakeTasks(std::vector<Task>* tasks) {
+  std::move(c.begin(), c.end(), std::back_inserter(*tasks));
+  c.clear();
+}
+
+void DelayedTaskTimingWheel::TaskHeap::RemoveCancelledTasks(
+    std::vector<Task>* cancelled_tasks) {
+  // Like TaskQueueImpl::DelayedIncomingQueue::PQueue, filter the underlying
+  // vector in place.
+  const size_t num_cancelled_tasks = cancelled_tasks->size();
+  MoveCancelledTasks(&c, cancelled_tasks);
+  if (cancelled_tasks->size() != num_cancelled_tasks)
+    std::make_heap(c.begin(), c.end(), comp);
+}
+
+// static
+uint64_t DelayedTaskTimingWheel::GetTick(const Task& task) {
+  return static_cast<uint64_t>(
+             task.delayed_run_time.since_origin().InMicroseconds()) /
+         kMicrosecondsPerTick;
+}
+
+size_t DelayedTaskTimingWheel::GetLevel(uint64_t tick) const {
+  CR_DCHECK(tick != cursor_);
+  return (63 - bits::CountLeadingZeroBits(tick ^ cursor_)) / kSlotBits;
+}
+
+void DelayedTaskTimingWheel::Insert(Task task, uint64_t tick) {
+  if (tick <= cursor_) {
+    due_.push(std::move(task));
+    return;
+  }
+
+  const size_t level = GetLevel(tick);
+  if (level >= kNumLevels) {
+    overflow_.push(std::move(task));
+    return;
+  }
+
+  const size_t slot = (tick >> (level * kSlotBits)) & (kNumSlots - 1);
+  slots_[level][slot].push_back(std::move(task));
+  occupied_slots_[level] |= uint64_t(1) << slot;
+  ++level_sizes_[level];
+}
+
+size_t DelayedTaskTimingWheel::GetNumTasksToRewind(size_t rewind_level) const {
+  size_t num_tasks = due_.size();
+  for (size_t level = 0; level < rewind_level; ++level)
+    num_tasks += level_sizes_[level];
+  return num_tasks;
+}
+
+void DelayedTaskTimingWheel::Rewind(uint64_t tick) {
+  CR_DCHECK(tick < cursor_);
+  const size_t rewind_level = GetLevel(tick);
+  CR_DCHECK(rewind_level < kNumLevels);
+
+  // |tick| only differs from |cursor_| up to |rewind_level|, and is lower
+  // there. So the tasks of |rewind_level| and above keep their slot, while
+  // those below move up to |rewind_level|, or to |due_|. The overflowing
+  // tasks still overflow.
+  std::vector<Task> tasks;
+  due_.TakeTasks(&tasks);
+  for (size_t level = 0; level < rewind_level; ++level) {
+    while (occupied_slots_[level]) {
+      const size_t slot = bits::CountTrailingZeroBits(occupied_slots_[level]);
+      occupied_slots_[level] &= ~(uint64_t(1) << slot);
+      std::vector<Task>& slot_tasks = slots_[level][slot];
+      std::move(slot_tasks.begin(), slot_tasks.end(),
+                std::back_inserter(tasks));
+      slot_tasks.clear();
+    }
+    level_sizes_[level] = 0;
+  }
+
+  cursor_ = tick;
+  for (Task& task : tasks) {
+    const uint64_t task_tick = GetTick(task);
+    Insert(std::move(task), task_tick);
+  }
+}
+
+void DelayedTaskTimingWheel::Advance() {
+  CR_DCHECK(size_);
+  while (due_.empty()) {
+    size_t level = 0;
+    while (level < kNumLevels && !occupied_slots_[level])
+      ++level;
+
+    if (level == kNumLevels) {
+      // Only tasks beyond the span of the wheels are left: restart the wheels
+      // from the earliest one, and move in those which now fit.
+      CR_DCHECK(!overflow_.empty());
+      cursor_ = GetTick(overflow_.top());
+      while (!overflow_.empty()) {
+        const uint64_t tick = GetTick(overflow_.top());
+        if ((tick >> kWheelBits) != (cursor_ >> kWheelBits))
+          break;
+        Task task = std::move(const_cast<Task&>(overflow_.top()));
+        overflow_.pop();
+        Insert(std::move(task), tick);
+      }
+      continue;
+    }
+
+    // The earliest occupied slot of the lowest occupied level holds the
+    // earliest tasks, since lower levels are empty and the other slots and
+    // levels come later. Move the cursor to its first tick.
+    const size_t slot = bits::CountTrailingZeroBits(occupied_slots_[level]);
+    occupied_slots_[level] &= ~(uint64_t(1) << slot);
+    const size_t shift = level * kSlotBits;
+    cursor_ = ((cursor_ >> (shift + kSlotBits)) << (shift + kSlotBits)) |
+              (uint64_t(slot) << shift);
+
+    // Tasks of a level 0 slot are all due, the others cascade into lower
+    // levels. Either way none goes back into this slot, which keeps its
+    // capacity.
+    std::vector<Task>& tasks = slots_[level][slot];
+    level_sizes_[level] -= tasks.size();
+    for (Task& task : tasks) {
+      const uint64_t tick = GetTick(task);
+      Insert(std::move(task), tick);
+    }
+    tasks.clear();
+  }
+}
+
+}  // namespace internal
+}  // namespace sequence_manager
+}  // namespace cr
@@ -0,0 +1,117 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MINI_CHROMIUM_SRC_CREVENT_TASK_SEQUENCE_MANAGER_DELAYED_TASK_TIMING_WHEEL_H_
+#define MINI_CHROMIUM_SRC_CREVENT_TASK_SEQUENCE_MANAGER_DELAYED_TASK_TIMING_WHEEL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <queue>
+#include <vector>
+
+#include "cr_event/event_export.h"
+#include "cr_event/task/sequence_manager/tasks.h"
+
+namespace cr {
+namespace sequence_manager {
+namespace internal {
+
+// A store of delayed tasks which orders them like a std::priority_queue<Task>,
+// i.e. by delayed run time then by sequence number, used by TaskQueueImpl's
+// |delayed_incoming_queue| for queues with a large number of outstanding
+// delayed tasks. See TaskQueue::DelayedTaskStore.
+//
+// Run times are rounded down to ticks of kMicrosecondsPerTick, and tasks are
+// hashed by tick into kNumLevels wheels of kNumSlots slots, relative to the
+// current tick |cursor_|: level l holds the tasks whose tick only differs
+// from |cursor_| in the l-th group of kSlotBits bits, and tasks too far in
+// the future go to an overflow heap. When no task is due at |cursor_| any
+// more, the cursor moves to the earliest occupied slot: the tasks of a level
+// 0 slot all share the same tick and move, all at once, to |due_|, a heap
+// which orders them exactly, while the tasks of a higher level slot cascade
+// into lower levels. So push() is O(1), and so is pop() amortized over the
+// at most kNumLevels cascades of a task.
+//
+// Cancelled tasks are dropped lazily, like with the heap: TaskQueueImpl skips
+// them when they're due, or sweeps them with RemoveCancelledTasks().
+class CREVENT_EXPORT DelayedTaskTimingWheel {
+ public:
+  static constexpr int64_t kMicrosecondsPerTick = 1000;
+  static constexpr size_t kSlotBits = 6;
+  static constexpr size_t kNumSlots = size_t(1) << kSlotBits;
+  static constexpr size_t kNumLevels = 4;
+
+  // Maximum number of tasks moved to rewind the cursor, see Rewind().
+  static constexpr size_t kMaxRewoundTasks = 64;
+
+  DelayedTaskTimingWheel();
+  DelayedTaskTimingWheel(const DelayedTaskTimingWheel&) = delete;
+  DelayedTaskTimingWheel& operator=(const DelayedTaskTimingWheel&) = delete;
+  ~DelayedTaskTimingWheel();
+
+  void push(Task task);
+  void pop();
+
+  // |due_| is only empty if the whole wheel is.
+  bool empty() const { return due_.empty(); }
+  size_t size() const { return size_; }
+  const Task& top() const { return due_.top(); }
+
+  void swap(DelayedTaskTimingWheel* other);
+
+  // Moves the cancelled tasks to |cancelled_tasks|, so that the caller can
+  // delete them once the wheel is consistent again.
+  void RemoveCancelledTasks(std::vector<Task>* cancelled_tasks);
+
+ private:
+  struct TaskHeap : public std::priority_queue<Task> {
+    // Appends all the tasks to |tasks|, in no particular order.
+    void TakeTasks(std::vector<Task>* tasks);
+    void RemoveCancelledTasks(std::vector<Task>* cancelled_tasks);
+  };
+
+  static uint64_t GetTick(const Task& task);
+
+  // Returns the level of |tick|, which must differ from |cursor_|: the index
+  // of the highest group of kSlotBits bits in which they differ. kNumLevels
+  // or more means the task overflows.
+  size_t GetLevel(uint64_t tick) const;
+
+  // Puts |task| into |due_|, a slot or |overflow_|, according to |tick|.
+  void Insert(Task task, uint64_t tick);
+
+  // Moves the cursor to the earliest task, cascading slots until |due_| isn't
+  // empty. The wheel mustn't be empty.
+  void Advance();
+
+  // Moves the cursor back to |tick|, an earlier tick within the span of the
+  // wheels, e.g. when a task is posted with a shorter delay than all the
+  // others. Only moves the tasks of |due_| and of the levels below the one of
+  // |tick|, whose number GetNumTasksToRewind() returns.
+  void Rewind(uint64_t tick);
+  size_t GetNumTasksToRewind(size_t rewind_level) const;
+
+  // Tasks whose tick is at or before |cursor_|.
+  TaskHeap due_;
+
+  // |slots_[l][s]| holds tasks whose tick matches |cursor_| above the l-th
+  // group of bits and has |s| in it. Bit |s| of |occupied_slots_[l]| is set if
+  // that slot is not empty.
+  std::vector<Task> slots_[kNumLevels][kNumSlots];
+  uint64_t occupied_slots_[kNumLevels] = {};
+  size_t level_sizes_[kNumLevels] = {};
+
+  // Tasks beyond the span of the wheels.
+  TaskHeap overflow_;
+
+  uint64_t cursor_ = 0;
+  size_t size_ = 0;
+};
+
+}  // namespace internal
+}  // namespace sequence_manager
+}  // namespace cr
+
+#endif  // MINI_CHROMIUM_SRC_CREVENT_TASK_SEQUENCE_MANAGER_DELAYED_TASK_TIMING_WHEEL_H_
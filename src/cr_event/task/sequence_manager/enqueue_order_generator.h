@@ -7,6 +7,7 @@
 #ifndef MINI_CHROMIUM_SRC_CREVENT_TASK_SEQUENCE_MANAGER_ENQUEUE_ORDER_GENERATOR_H_
 #define MINI_CHROMIUM_SRC_CREVENT_TASK_SEQUENCE_MANAGER_ENQUEUE_ORDER_GENERATOR_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <atomic>
@@ -33,6 +34,19 @@ class CREVENT_EXPORT EnqueueOrderGenerator {
         &counter_, uint64_t(1), std::memory_order_relaxed));
   }
 
+  // Can be called from any thread. Reserves |count| consecutive enqueue orders
+  // and returns the first one, see Offset().
+  EnqueueOrder GenerateNext(size_t count) {
+    return EnqueueOrder(std::atomic_fetch_add_explicit(
+        &counter_, uint64_t(count), std::memory_order_relaxed));
+  }
+
+  // Returns the enqueue order |offset| places after |first| in a range
+  // reserved by GenerateNext(count), with |offset| < count.
+  static EnqueueOrder Offset(EnqueueOrder first, size_t offset) {
+    return EnqueueOrder(first + offset);
+  }
+
  private:
   std::atomic<uint64_t> counter_;
 };
@@ -0,0 +1,135 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cr_event/task/sequence_manager/incoming_task_queue.h"
+
+#include "cr_base/logging/logging.h"
+
+namespace cr {
+namespace sequence_manager {
+namespace internal {
+
+IncomingTaskQueue::IncomingTaskQueue() = default;
+
+IncomingTaskQueue::~IncomingTaskQueue() {
+  // Destroys the tasks still queued along with their nodes.
+  for (std::atomic<Node*>& chunk : chunks_)
+    delete[] chunk.load(std::memory_order_relaxed);
+}
+
+void IncomingTaskQueue::TakeTasks(TaskDeque* queue) {
+  uint64_t head = head_.load(std::memory_order_relaxed);
+  do {
+    if (!HeadIndex(head))
+      return;
+  } while (!head_.compare_exchange_weak(head, MakeHead(0, head),
+                                        std::memory_order_acquire,
+                                        std::memory_order_relaxed));
+
+  // The list is newest first.
+  const uint32_t newest = HeadIndex(head);
+  uint32_t oldest = 0;
+  size_t num_tasks = 0;
+  for (uint32_t index = newest; index;) {
+    Node& node = GetNode(index);
+    const uint32_t next = node.next.load(std::memory_order_relaxed);
+    node.next.store(oldest, std::memory_order_relaxed);
+    oldest = index;
+    index = next;
+    ++num_tasks;
+  }
+
+  for (uint32_t index = oldest; index;) {
+    Node& node = GetNode(index);
+    if (!node.task->enqueue_order_set())
+      SetEnqueueOrder(&node);
+    queue->push_back(std::move(*node.task));
+    node.task = nullopt;
+    index = node.next.load(std::memory_order_relaxed);
+  }
+
+  // The nodes are still linked, from |oldest| to |newest|.
+  FreeNodes(oldest, newest);
+  size_.fetch_sub(num_tasks, std::memory_order_relaxed);
+}
+
+EnqueueOrder IncomingTaskQueue::GetOldestEnqueueOrder() const {
+  // Nodes are only recycled by TakeTasks(), on this thread, and pushes don't
+  // modify the nodes already in the list.
+  uint32_t index = HeadIndex(head_.load(std::memory_order_acquire));
+  if (!index)
+    return EnqueueOrder::none();
+  for (;;) {
+    const Node& node = GetNode(index);
+    const uint32_t next = node.next.load(std::memory_order_relaxed);
+    if (!next)
+      return node.enqueue_order;
+    index = next;
+  }
+}
+
+uint32_t IncomingTaskQueue::AllocateNode() {
+  const uint32_t index = TryAllocateNode();
+  if (index)
+    return index;
+
+  AutoLock lock(chunks_lock_);
+  // Another thread may have added a chunk meanwhile.
+  const uint32_t free_index = TryAllocateNode();
+  if (free_index)
+    return free_index;
+
+  const size_t chunk = num_chunks_++;
+  CR_CHECK(chunk < kMaxChunks);
+  const uint32_t chunk_size = kFirstChunkSize << chunk;
+  Node* nodes = new Node[chunk_size];
+  chunks_[chunk].store(nodes, std::memory_order_release);
+
+  // Keep the first node of the chunk, and free the others.
+  const uint32_t first = (kFirstChunkSize << chunk) - kFirstChunkSize + 1;
+  for (uint32_t i = 1; i + 1 < chunk_size; ++i)
+    nodes[i].next.store(first + i + 1, std::memory_order_relaxed);
+  FreeNodes(first + 1, first + chunk_size - 1);
+  return first;
+}
+
+uint32_t IncomingTaskQueue::TryAllocateNode() {
+  uint64_t free_head = free_head_.load(std::memory_order_acquire);
+  for (;;) {
+    const uint32_t index = HeadIndex(free_head);
+    if (!index)
+      return 0;
+    // If another thread takes the node first, the CAS fails whatever was
+    // read here.
+    const uint32_t next = GetNode(index).next.load(std::memory_order_relaxed);
+    if (free_head_.compare_exchange_weak(free_head, MakeHead(next, free_head),
+                                         std::memory_order_acquire,
+                                         std::memory_order_acquire)) {
+      return index;
+    }
+  }
+}
+
+void IncomingTaskQueue::FreeNodes(uint32_t first, uint32_t last) {
+  Node& last_node = GetNode(last);
+  uint64_t free_head = free_head_.load(std::memory_order_relaxed);
+  do {
+    last_node.next.store(HeadIndex(free_head), std::memory_order_relaxed);
+  } while (!free_head_.compare_exchange_weak(free_head,
+                                             MakeHead(first, free_head),
+                                             std::memory_order_release,
+                                             std::memory_order_relaxed));
+}
+
+// static
+void IncomingTaskQueue::SetEnqueueOrder(Node* node) {
+  // Immediate tasks use their enqueue order as sequence number, see
+  // TaskQueueImpl::PostImmediateTaskImpl().
+  node->task->set_enqueue_order(node->enqueue_order);
+  node->task->sequence_num = static_cast<intptr_t>(node->enqueue_order);
+}
+
+}  // namespace internal
+}  // namespace sequence_manager
+}  // namespace cr
@@ -0,0 +1,238 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MINI_CHROMIUM_SRC_CREVENT_TASK_SEQUENCE_MANAGER_INCOMING_TASK_QUEUE_H_
+#define MINI_CHROMIUM_SRC_CREVENT_TASK_SEQUENCE_MANAGER_INCOMING_TASK_QUEUE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include "cr_base/containers/optional.h"
+#include "cr_base/logging/logging.h"
+#include "cr_base/numerics/bits.h"
+#include "cr_base/synchronization/lock.h"
+#include "cr_base/time/time.h"
+
+#include "cr_event/event_export.h"
+#include "cr_event/task/sequence_manager/enqueue_order.h"
+#include "cr_event/task/sequence_manager/enqueue_order_generator.h"
+#include "cr_event/task/sequence_manager/lazily_deallocated_deque.h"
+#include "cr_event/task/sequence_manager/tasks.h"
+
+namespace cr {
+namespace sequence_manager {
+namespace internal {
+
+// Lock-free multi-producer / single-consumer queue of immediate tasks, used as
+// TaskQueueImpl's |immediate_incoming_queue|. Any thread can push, while the
+// main thread takes all the tasks at once when its |immediate_work_queue|
+// runs dry.
+//
+// Pushing is a CAS onto the head of an intrusive list, newest task first;
+// TakeTasks() detaches the whole list with a single CAS and reverses it. Each
+// push takes its enqueue order after loading the head it links to and
+// retries with a new one if the CAS fails, so enqueue orders strictly
+// decrease from the head of the list: tasks come out of TakeTasks() oldest
+// first, with strictly increasing enqueue orders, and every task has a
+// greater enqueue order than the ones taken by the previous TakeTasks() call.
+//
+// That only holds if a CAS can't succeed against a head which was taken and
+// then pushed again since it was loaded (ABA), so the heads pair the index of
+// a node with a version bumped by every change. Nodes are indices into a pool
+// which only grows: TakeTasks() recycles the nodes it empties rather than
+// freeing them, so that pushing doesn't allocate once the pool covers the
+// largest backlog of the queue.
+class CREVENT_EXPORT IncomingTaskQueue {
+ public:
+  using TaskDeque = LazilyDeallocatedDeque<Task, TimeTicks::Now>;
+
+  IncomingTaskQueue();
+  IncomingTaskQueue(const IncomingTaskQueue&) = delete;
+  IncomingTaskQueue& operator=(const IncomingTaskQueue&) = delete;
+  ~IncomingTaskQueue();
+
+  // Can be called from any thread. Pushes |task| with an enqueue order
+  // returned by |next_enqueue_order|, which may be called more than once, and
+  // returns true if the queue was empty.
+  //
+  // The enqueue order is set on the task when it's taken. If |pushed_task| is
+  // not null, it's set right away instead and |pushed_task| receives the task
+  // as stored in the queue: this requires the caller to prevent TakeTasks()
+  // from running concurrently, e.g. with a lock, for as long as it uses the
+  // task.
+  template <typename NextEnqueueOrder>
+  bool Push(Task task,
+            NextEnqueueOrder next_enqueue_order,
+            Task** pushed_task = nullptr) {
+    const uint32_t index = AllocateNode();
+    Node& node = GetNode(index);
+    node.task.emplace(std::move(task));
+    size_.fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    for (;;) {
+      node.next.store(HeadIndex(head), std::memory_order_relaxed);
+      // |head| was published after its enqueue order was taken, hence the
+      // one taken here is greater.
+      node.enqueue_order = next_enqueue_order();
+      if (head_.compare_exchange_weak(head, MakeHead(index, head),
+                                      std::memory_order_release,
+                                      std::memory_order_relaxed)) {
+        break;
+      }
+    }
+
+    if (pushed_task) {
+      SetEnqueueOrder(&node);
+      *pushed_task = &*node.task;
+    }
+    return !HeadIndex(head);
+  }
+
+  // Like Push(), for a batch of tasks linked into the queue with a single CAS.
+  // |next_enqueue_orders| is called with the number of tasks and returns the
+  // first of as many consecutive enqueue orders, see
+  // EnqueueOrderGenerator::GenerateNext(count). The tasks come out of
+  // TakeTasks() in the order of |tasks|, which must not be empty.
+  //
+  // If |pushed_tasks| is not null, it receives the tasks as stored in the
+  // queue, in the same order, with the same requirement as above.
+  template <typename NextEnqueueOrders>
+  bool PushBatch(std::vector<Task> tasks,
+                 NextEnqueueOrders next_enqueue_orders,
+                 std::vector<Task*>* pushed_tasks = nullptr) {
+    const size_t num_tasks = tasks.size();
+    CR_DCHECK(num_tasks);
+
+    // Link the batch newest first, like the queue.
+    uint32_t newest = 0;
+    uint32_t oldest = 0;
+    for (Task& task : tasks) {
+      const uint32_t index = AllocateNode();
+      Node& node = GetNode(index);
+      node.task.emplace(std::move(task));
+      node.next.store(newest, std::memory_order_relaxed);
+      newest = index;
+      if (!oldest)
+        oldest = index;
+    }
+    size_.fetch_add(num_tasks, std::memory_order_relaxed);
+
+    Node& oldest_node = GetNode(oldest);
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    for (;;) {
+      oldest_node.next.store(HeadIndex(head), std::memory_order_relaxed);
+      // See Push().
+      const EnqueueOrder first = next_enqueue_orders(num_tasks);
+      uint32_t index = newest;
+      for (size_t i = num_tasks; i-- > 0;) {
+        Node& node = GetNode(index);
+        node.enqueue_order = EnqueueOrderGenerator::Offset(first, i);
+        index = node.next.load(std::memory_order_relaxed);
+      }
+      if (head_.compare_exchange_weak(head, MakeHead(newest, head),
+                                      std::memory_order_release,
+                                      std::memory_order_relaxed)) {
+        break;
+      }
+    }
+
+    if (pushed_tasks) {
+      pushed_tasks->resize(num_tasks);
+      uint32_t index = newest;
+      for (size_t i = num_tasks; i-- > 0;) {
+        Node& node = GetNode(index);
+        SetEnqueueOrder(&node);
+        (*pushed_tasks)[i] = &*node.task;
+        index = node.next.load(std::memory_order_relaxed);
+      }
+    }
+    return !HeadIndex(head);
+  }
+
+  // Must be called on the main thread. Appends all the tasks to |queue|,
+  // oldest first.
+  void TakeTasks(TaskDeque* queue);
+
+  // Can be called from any thread.
+  bool empty() const {
+    return !HeadIndex(head_.load(std::memory_order_acquire));
+  }
+
+  // Can be called from any thread. Approximate while tasks are being pushed
+  // or taken.
+  size_t size() const { return size_.load(std::memory_order_relaxed); }
+
+  // Must be called on the main thread. Returns the enqueue order of the task
+  // TakeTasks() would return first, or EnqueueOrder::none() if empty. Walks
+  // the whole queue, so it's only meant for infrequent operations such as
+  // inserting a fence.
+  EnqueueOrder GetOldestEnqueueOrder() const;
+
+ private:
+  struct Node {
+    Optional<Task> task;
+    EnqueueOrder enqueue_order;
+    // The next node of the list the node is in, i.e. the queue or the free
+    // list. Atomic since a thread which lost the race for a free node may
+    // still read it.
+    std::atomic<uint32_t> next{0};
+  };
+
+  // The pool is made of chunks of kFirstChunkSize, 2 * kFirstChunkSize, ...
+  // nodes, which hold the nodes of index 1 and up in order. Index 0 is null.
+  static constexpr int kLog2FirstChunkSize = 6;
+  static constexpr uint32_t kFirstChunkSize = 1u << kLog2FirstChunkSize;
+  static constexpr size_t kMaxChunks = 32 - kLog2FirstChunkSize;
+
+  // A head holds the index of the first node of a list in its low half, and
+  // its version in its high half.
+  static uint32_t HeadIndex(uint64_t head) {
+    return static_cast<uint32_t>(head);
+  }
+
+  static uint64_t MakeHead(uint32_t index, uint64_t previous_head) {
+    return (((previous_head >> 32) + 1) << 32) | index;
+  }
+
+  Node& GetNode(uint32_t index) const {
+    CR_DCHECK(index);
+    const uint32_t position = index + kFirstChunkSize - 1;
+    const int chunk = bits::Log2Floor(position) - kLog2FirstChunkSize;
+    return chunks_[chunk].load(std::memory_order_acquire)
+        [position - (kFirstChunkSize << chunk)];
+  }
+
+  // Returns the index of an empty node, taken off the free list, or from a
+  // new chunk if the free list is empty.
+  uint32_t AllocateNode();
+  uint32_t TryAllocateNode();
+
+  // Puts the nodes linked from |first| to |last| on the free list.
+  void FreeNodes(uint32_t first, uint32_t last);
+
+  static void SetEnqueueOrder(Node* node);
+
+  std::atomic<uint64_t> head_{0};
+  std::atomic<size_t> size_{0};
+
+  // The free list, pushed by TakeTasks() and popped by pushes.
+  std::atomic<uint64_t> free_head_{0};
+
+  std::atomic<Node*> chunks_[kMaxChunks] = {};
+
+  // Serializes the allocation of chunks.
+  Lock chunks_lock_;
+  size_t num_chunks_ = 0;
+};
+
+}  // namespace internal
+}  // namespace sequence_manager
+}  // namespace cr
+
+#endif  // MINI_CHROMIUM_SRC_CREVENT_TASK_SEQUENCE_MANAGER_INCOMING_TASK_QUEUE_H_
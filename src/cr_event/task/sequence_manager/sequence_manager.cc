@@ -51,6 +51,13 @@ SequenceManager::Settings::Builder::SetAddQueueTimeToTasks(
   return *this;
 }
 
+SequenceManager::Settings::Builder&
+SequenceManager::Settings::Builder::SetEarliestDeadlineFirst(
+    bool earliest_deadline_first_val) {
+  settings_.earliest_deadline_first = earliest_deadline_first_val;
+  return *this;
+}
+
 #if CR_DCHECK_IS_ON()
 
 SequenceManager::Settings::Builder&
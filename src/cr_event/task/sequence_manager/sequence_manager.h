@@ -9,8 +9,10 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "cr_event/time/tick_clock.h"
+#include "cr_event/message_pump/message_pump_metrics.h"
 #include "cr_event/message_pump/message_pump_type.h"
 #include "cr_event/message_pump/timer_slack.h"
 #include "cr_event/task/sequenced_task_runner.h"
@@ -96,6 +98,13 @@ class CREVENT_EXPORT SequenceManager {
     // If true, add the timestamp the task got queued to the task.
     bool add_queue_time_to_tasks = false;
 
+    // If true, within a priority the task with the earliest deadline runs
+    // first rather than the oldest one, see TaskQueue::Spec::SetTaskDeadline.
+    // Tasks without a deadline run after those with one, oldest first. To
+    // keep them from starving, the oldest task runs after a few tasks ran
+    // ahead of it.
+    bool earliest_deadline_first = false;
+
 #if CR_DCHECK_IS_ON()
     // TODO(alexclarke): Consider adding command line flags to control these.
     enum class TaskLogging {
@@ -200,6 +209,27 @@ class CREVENT_EXPORT SequenceManager {
   // Returns the metric recording configuration for the current SequenceManager.
   virtual const MetricRecordingSettings& GetMetricRecordingSettings() const = 0;
 
+  // Returns the stats of all the TaskQueues which record them, see
+  // TaskQueue::Spec::SetShouldRecordStats(). TaskQueueStats::ToString() turns
+  // them into a readable dump.
+  // Must be called on the main thread.
+  virtual std::vector<TaskQueueStats> GetAllTaskQueueStats() const = 0;
+
+  // Fills |metrics| with the event loop metrics of the MessagePump the
+  // SequenceManager is bound to, see MessagePump::GetMetrics(). Returns false
+  // if no pump is bound yet or the pump doesn't record metrics.
+  // Can be called on any thread.
+  virtual bool GetMessagePumpMetrics(MessagePumpMetrics* metrics) const = 0;
+
+  // Runs |callback| on the main thread with a fresh snapshot of the pump's
+  // metrics about every |interval|, between two units of work, for as long as
+  // the pump records metrics. An idle thread reports on its next wake-up. A
+  // null |callback| stops the sampling.
+  // Must be called on the main thread.
+  virtual void SetMessagePumpMetricsCallback(
+      TimeDelta interval,
+      MessagePumpMetricsCallback callback) = 0;
+
   // Creates a task queue with the given type, |spec| and args.
   // Must be called on the main thread.
   // TODO(scheduler-dev): SequenceManager should not create TaskQueues.
@@ -268,6 +298,9 @@ class CREVENT_EXPORT SequenceManager::Settings::Builder {
   // Whether or not queueing timestamp will be added to tasks.
   Builder& SetAddQueueTimeToTasks(bool add_queue_time_to_tasks);
 
+  // Whether or not tasks are selected by deadline within a priority.
+  Builder& SetEarliestDeadlineFirst(bool earliest_deadline_first);
+
 #if CR_DCHECK_IS_ON()
   // Controls task execution logging.
   Builder& SetTaskLogging(TaskLogging task_execution_logging);
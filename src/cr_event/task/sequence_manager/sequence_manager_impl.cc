@@ -170,6 +170,7 @@ SequenceManagerImpl::SequenceManagerImpl(
       metric_recording_settings_(InitializeMetricRecordingSettings(
           settings_.randomised_sampling_enabled)),
       add_queue_time_to_tasks_(settings_.add_queue_time_to_tasks),
+      task_tracer_(TaskTracer::GetInstance()),
 
       empty_queues_to_reload_(associated_thread_),
       memory_corruption_sentinel_(kMemoryCorruptionSentinelValue),
@@ -725,13 +726,17 @@ TaskQueue::TaskTiming SequenceManagerImpl::InitializeTaskTiming(
     internal::TaskQueueImpl* task_queue) {
   bool records_wall_time =
       ShouldRecordTaskTiming(task_queue) == TimeRecordingPolicy::DoRecord;
-  bool records_thread_time = records_wall_time && ShouldRecordCPUTimeForTask();
+  // Budget pools are charged the thread time of every task.
+  bool records_thread_time =
+      records_wall_time &&
+      ((task_queue->budget_pool() && ThreadTicks::IsSupported()) ||
+       ShouldRecordCPUTimeForTask());
   return TaskQueue::TaskTiming(records_wall_time, records_thread_time);
 }
 
 TimeRecordingPolicy SequenceManagerImpl::ShouldRecordTaskTiming(
     const internal::TaskQueueImpl* task_queue) {
-  if (task_queue->RequiresTaskTiming())
+  if (task_queue->RequiresTaskTiming() || task_tracer_->IsEnabled())
     return TimeRecordingPolicy::DoRecord;
   if (main_thread_only().nesting_depth == 0 &&
       !main_thread_only().task_time_observers.empty()) {
@@ -752,8 +757,11 @@ void SequenceManagerImpl::NotifyWillProcessTask(ExecutingTask* executing_task,
 
   TimeRecordingPolicy recording_policy =
       ShouldRecordTaskTiming(executing_task->task_queue);
-  if (recording_policy == TimeRecordingPolicy::DoRecord)
+  if (recording_policy == TimeRecordingPolicy::DoRecord) {
     executing_task->task_timing.RecordTaskStart(time_before_task);
+    executing_task->task_queue->RecordStatsOnTaskStarted(
+        executing_task->pending_task, executing_task->task_timing);
+  }
 
   if (!executing_task->task_queue->GetShouldNotifyObservers())
     return;
@@ -800,12 +808,11 @@ void SequenceManagerImpl::NotifyDidProcessTask(ExecutingTask* executing_task,
                                                LazyNow* time_after_task) {
   ///TRACE_EVENT0(TRACE_DISABLED_BY_DEFAULT("sequence_manager"),
   ///             "SequenceManagerImpl::NotifyDidProcessTaskObservers");
-  if (!executing_task->task_queue->GetShouldNotifyObservers())
-    return;
-
   TaskQueue::TaskTiming& task_timing = executing_task->task_timing;
+  const bool should_notify_observers =
+      executing_task->task_queue->GetShouldNotifyObservers();
 
-  {
+  if (should_notify_observers) {
     ///TRACE_EVENT0(TRACE_DISABLED_BY_DEFAULT("sequence_manager"),
     ///             "SequenceManager.QueueOnTaskCompleted");
     if (task_timing.has_wall_time()) {
@@ -816,13 +823,23 @@ void SequenceManagerImpl::NotifyDidProcessTask(ExecutingTask* executing_task,
 
   bool has_valid_start =
       task_timing.state() != TaskQueue::TaskTiming::State::NotStarted;
-  TimeRecordingPolicy recording_policy =
-      ShouldRecordTaskTiming(executing_task->task_queue);
-  // Record end time ASAP to avoid bias due to the overhead of observers.
-  if (recording_policy == TimeRecordingPolicy::DoRecord && has_valid_start) {
+  // Record end time ASAP to avoid bias due to the overhead of observers. A
+  // started task is always ended, even if the recording policy changed while
+  // it ran, since the stats and the budget pool below use its end time.
+  if (has_valid_start)
     task_timing.RecordTaskEnd(time_after_task);
+
+  if (has_valid_start && task_timing.has_wall_time()) {
+    executing_task->task_queue->RecordStatsOnTaskCompleted(task_timing,
+                                                           time_after_task);
+    executing_task->task_queue->ChargeBudgetPoolOnTaskCompleted(task_timing);
+    if (task_tracer_->IsEnabled())
+      RecordTaskTrace(*executing_task, time_after_task);
   }
 
+  if (!should_notify_observers)
+    return;
+
   if (has_valid_start && task_timing.has_wall_time() &&
       main_thread_only().nesting_depth == 0) {
     ///TRACE_EVENT0(TRACE_DISABLED_BY_DEFAULT("sequence_manager"),
@@ -848,7 +865,6 @@ void SequenceManagerImpl::NotifyDidProcessTask(ExecutingTask* executing_task,
 
   // TODO(altimin): Move this back to blink.
   ///if (task_timing.has_wall_time() &&
-  ///    recording_policy == TimeRecordingPolicy::DoRecord &&
   ///    task_timing.wall_duration() > kLongTaskTraceEventThreshold &&
   ///    main_thread_only().nesting_depth == 0) {
   ///  TRACE_EVENT_INSTANT1("blink", "LongTask", TRACE_EVENT_SCOPE_THREAD,
@@ -856,6 +872,18 @@ void SequenceManagerImpl::NotifyDidProcessTask(ExecutingTask* executing_task,
   ///}
 }
 
+void SequenceManagerImpl::RecordTaskTrace(const ExecutingTask& executing_task,
+                                          LazyNow* time_after_task) {
+  RefPtr<TaskTracer::ThreadBuffer>& trace_buffer =
+      main_thread_only().trace_buffer;
+  if (!trace_buffer || !task_tracer_->IsCurrent(*trace_buffer))
+    trace_buffer = task_tracer_->CreateThreadBuffer();
+  trace_buffer->RecordTask(executing_task.pending_task,
+                           executing_task.task_queue_name,
+                           executing_task.task_timing.start_time(),
+                           time_after_task->Now());
+}
+
 void SequenceManagerImpl::SetWorkBatchSize(size_t work_batch_size) {
   CR_DCHECK_CALLED_ON_VALID_THREAD(associated_thread_->thread_checker);
   CR_DCHECK(work_batch_size >= 1);
@@ -900,6 +928,10 @@ EnqueueOrder SequenceManagerImpl::GetNextSequenceNumber() {
   return enqueue_order_generator_.GenerateNext();
 }
 
+EnqueueOrder SequenceManagerImpl::GetNextSequenceNumbers(size_t count) {
+  return enqueue_order_generator_.GenerateNext(count);
+}
+
 void SequenceManagerImpl::OnTaskQueueEnabled(internal::TaskQueueImpl* queue) {
   CR_DCHECK_CALLED_ON_VALID_THREAD(associated_thread_->thread_checker);
   CR_DCHECK(queue->IsQueueEnabled());
@@ -1000,6 +1032,28 @@ bool SequenceManagerImpl::IsIdleForTesting() {
   return !main_thread_only().selector.GetHighestPendingPriority().has_value();
 }
 
+std::vector<TaskQueueStats> SequenceManagerImpl::GetAllTaskQueueStats() const {
+  CR_DCHECK_CALLED_ON_VALID_THREAD(associated_thread_->thread_checker);
+  std::vector<TaskQueueStats> all_stats;
+  for (internal::TaskQueueImpl* task_queue : main_thread_only().active_queues) {
+    if (task_queue->stats_recorder())
+      all_stats.push_back(task_queue->stats_recorder()->GetSnapshot());
+  }
+  return all_stats;
+}
+
+bool SequenceManagerImpl::GetMessagePumpMetrics(
+    MessagePumpMetrics* metrics) const {
+  return controller_->GetMessagePumpMetrics(metrics);
+}
+
+void SequenceManagerImpl::SetMessagePumpMetricsCallback(
+    TimeDelta interval,
+    MessagePumpMetricsCallback callback) {
+  CR_DCHECK_CALLED_ON_VALID_THREAD(associated_thread_->thread_checker);
+  controller_->SetMessagePumpMetricsCallback(interval, std::move(callback));
+}
+
 size_t SequenceManagerImpl::GetPendingTaskCountForTesting() const {
   size_t total = 0;
   for (internal::TaskQueueImpl* task_queue : main_thread_only().active_queues) {
@@ -1046,6 +1100,13 @@ MessagePump* SequenceManagerImpl::GetMessagePump() const {
 }
 
 bool SequenceManagerImpl::IsType(MessagePumpType type) const {
+#if defined(MINI_CHROMIUM_OS_LINUX)
+  // An IO_URING pump is a MessagePumpForIO with a different kernel backend.
+  if (type == MessagePumpType::IO &&
+      settings_.message_loop_type == MessagePumpType::IO_URING) {
+    return true;
+  }
+#endif
   return settings_.message_loop_type == type;
 }
 
@@ -37,6 +37,7 @@
 #include "cr_event/task/sequence_manager/sequence_manager.h"
 #include "cr_event/task/sequence_manager/task_queue_impl.h"
 #include "cr_event/task/sequence_manager/task_queue_selector.h"
+#include "cr_event/task/sequence_manager/task_tracer.h"
 #include "cr_event/task/sequence_manager/thread_controller.h"
 #include "cr_event/threading/thread_checker.h"
 
@@ -113,6 +114,11 @@ class CREVENT_EXPORT SequenceManagerImpl
   void SetTimerSlack(TimerSlack timer_slack) override;
   void EnableCrashKeys(const char* async_stack_crash_key) override;
   const MetricRecordingSettings& GetMetricRecordingSettings() const override;
+  std::vector<TaskQueueStats> GetAllTaskQueueStats() const override;
+  bool GetMessagePumpMetrics(MessagePumpMetrics* metrics) const override;
+  void SetMessagePumpMetricsCallback(
+      TimeDelta interval,
+      MessagePumpMetricsCallback callback) override;
   size_t GetPendingTaskCountForTesting() const override;
   RefPtr<TaskQueue> CreateTaskQueue(
       const TaskQueue::Spec& spec) override;
@@ -309,6 +315,9 @@ class CREVENT_EXPORT SequenceManagerImpl
     // By default native work is not prioritized at all.
     std::multiset<TaskQueue::QueuePriority> pending_native_work{
         TaskQueue::kBestEffortPriority};
+
+    // Where this thread records its tasks while TaskTracer is enabled.
+    RefPtr<TaskTracer::ThreadBuffer> trace_buffer;
   };
 
   void CompleteInitializationOnBoundThread();
@@ -332,10 +341,21 @@ class CREVENT_EXPORT SequenceManagerImpl
   void NotifyWillProcessTask(ExecutingTask* task, LazyNow* time_before_task);
   void NotifyDidProcessTask(ExecutingTask* task, LazyNow* time_after_task);
 
+  // Records |executing_task| into the TaskTracer, which must be enabled.
+  void RecordTaskTrace(const ExecutingTask& executing_task,
+                       LazyNow* time_after_task);
+
   EnqueueOrder GetNextSequenceNumber();
 
+  // Reserves |count| consecutive sequence numbers and returns the first one,
+  // see EnqueueOrderGenerator::Offset().
+  EnqueueOrder GetNextSequenceNumbers(size_t count);
+
   bool GetAddQueueTimeToTasks();
 
+  // Traced tasks carry the time they were posted at too.
+  bool IsTaskTracerEnabled() const { return task_tracer_->IsEnabled(); }
+
   // Used in construction of TaskQueueImpl to obtain an AtomicFlag which it can
   // use to request reload by ReloadEmptyWorkQueues. The lifetime of
   // TaskQueueImpl is managed by this class and the handle will be released by
@@ -398,6 +418,8 @@ class CREVENT_EXPORT SequenceManagerImpl
   // Whether to add the queue time to tasks.
   cr::subtle::Atomic32 add_queue_time_to_tasks_;
 
+  TaskTracer* const task_tracer_;
+
   AtomicFlagSet empty_queues_to_reload_;
 
   // A check to bail out early during memory corruption.
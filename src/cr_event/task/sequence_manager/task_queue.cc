@@ -128,7 +128,8 @@ TaskQueue::TaskQueue(std::unique_ptr<internal::TaskQueueImpl> impl,
                              : MakeRefCounted<internal::AssociatedThreadId>()),
       default_task_runner_(impl_ ? impl_->CreateTaskRunner(kTaskTypeNone)
                                  : CreateNullTaskRunner()),
-      name_(impl_ ? impl_->GetName() : "") {}
+      name_(impl_ ? impl_->GetName() : ""),
+      stats_recorder_(impl_ ? impl_->stats_recorder() : nullptr) {}
 
 TaskQueue::~TaskQueue() {
   ShutdownTaskQueueGracefully();
@@ -201,6 +202,17 @@ RefPtr<SingleThreadTaskRunner> TaskQueue::CreateTaskRunner(
   return impl_->CreateTaskRunner(task_type);
 }
 
+RefPtr<SingleThreadTaskRunner> TaskQueue::CreateTaskRunnerWithDeadline(
+    TaskType task_type,
+    TimeDelta deadline) {
+  // We only need to lock if we're not on the main thread.
+  cr::internal::CheckedAutoLockMaybe lock(IsOnMainThread() ? &impl_lock_
+                                                             : nullptr);
+  if (!impl_)
+    return CreateNullTaskRunner();
+  return impl_->CreateTaskRunner(task_type, deadline);
+}
+
 std::unique_ptr<TaskQueue::QueueEnabledVoter>
 TaskQueue::CreateQueueEnabledVoter() {
   CR_DCHECK_CALLED_ON_VALID_THREAD(associated_thread_->thread_checker);
@@ -322,6 +334,15 @@ const char* TaskQueue::GetName() const {
   return name_;
 }
 
+TaskQueueStats TaskQueue::GetStats() const {
+  if (stats_recorder_)
+    return stats_recorder_->GetSnapshot();
+  TaskQueueStats stats;
+  stats.name = name_;
+  stats.sample_time = TimeTicks::Now();
+  return stats;
+}
+
 void TaskQueue::SetObserver(Observer* observer) {
   CR_DCHECK_CALLED_ON_VALID_THREAD(associated_thread_->thread_checker);
   if (!impl_)
@@ -20,6 +20,7 @@
 #include "cr_event/task/single_thread_task_runner.h"
 #include "cr_event/task/common/checked_lock.h"
 #include "cr_event/task/sequence_manager/lazy_now.h"
+#include "cr_event/task/sequence_manager/task_queue_stats.h"
 #include "cr_event/task/sequence_manager/tasks.h"
 #include "cr_event/task/task_observer.h"
 
@@ -35,6 +36,7 @@ class SequenceManagerImpl;
 class TaskQueueImpl;
 }  // namespace internal
 
+class CPUTimeBudgetPool;
 class TimeDomain;
 
 // TODO(kraynov): Make TaskQueue to actually be an interface for TaskQueueImpl
@@ -99,6 +101,18 @@ class CREVENT_EXPORT TaskQueue : public RefCountedThreadSafe<TaskQueue> {
   // Can be called on any thread.
   static const char* PriorityToString(QueuePriority priority);
 
+  // How a queue stores its delayed tasks until they're due.
+  enum class DelayedTaskStore {
+    // A binary heap, with O(log n) insertion and removal.
+    kHeap,
+
+    // A hierarchical timing wheel with millisecond ticks, with O(1) insertion
+    // and amortized removal. Meant for queues with a large number of
+    // outstanding delayed tasks, e.g. network timeouts. See
+    // internal::DelayedTaskTimingWheel.
+    kTimingWheel,
+  };
+
   // Options for constructing a TaskQueue.
   struct Spec {
     explicit Spec(const char* name) : name(name) {}
@@ -125,11 +139,49 @@ class CREVENT_EXPORT TaskQueue : public RefCountedThreadSafe<TaskQueue> {
       return *this;
     }
 
+    Spec SetDelayedTaskStore(DelayedTaskStore store) {
+      delayed_task_store = store;
+      return *this;
+    }
+
+    // Lets the delayed tasks of the queue run up to |leeway| after their
+    // delay, unless posted with DelayPolicy::kPrecise. Their run times are
+    // aligned to multiples of |leeway|, so that timers of queues with the same
+    // leeway share their wake-ups. Meant for housekeeping timers.
+    Spec SetDelayedTaskLeeway(TimeDelta leeway) {
+      delayed_task_leeway = leeway;
+      return *this;
+    }
+
+    // Records the queueing delay and the run duration of the tasks of the
+    // queue, see GetStats(). Costs two clock reads per task, plus one per
+    // immediate task posted if SequenceManager doesn't add queue times to
+    // tasks already.
+    Spec SetShouldRecordStats(bool should_record) {
+      should_record_stats = should_record;
+      return *this;
+    }
+
+    // Gives the tasks of the queue a deadline |deadline| after they are
+    // posted, or after their delay expires, unless posted through a task
+    // runner with a deadline of its own, see CreateTaskRunnerWithDeadline().
+    // Only matters to SequenceManagers created with
+    // Settings::earliest_deadline_first. Costs a clock read per immediate
+    // task posted.
+    Spec SetTaskDeadline(TimeDelta deadline) {
+      task_deadline = deadline;
+      return *this;
+    }
+
     const char* name;
     bool should_monitor_quiescence = false;
     TimeDomain* time_domain = nullptr;
     bool should_notify_observers = true;
     bool delayed_fence_allowed = false;
+    DelayedTaskStore delayed_task_store = DelayedTaskStore::kHeap;
+    TimeDelta delayed_task_leeway;
+    bool should_record_stats = false;
+    TimeDelta task_deadline;
   };
 
   // TODO(altimin): Make this private after TaskQueue/TaskQueueImpl refactoring.
@@ -251,6 +303,12 @@ class CREVENT_EXPORT TaskQueue : public RefCountedThreadSafe<TaskQueue> {
   // NOTE: this must be called on the thread this TaskQueue was created by.
   Optional<TimeTicks> GetNextScheduledWakeUp();
 
+  // Returns the statistics of the tasks run so far if the queue was created
+  // with Spec::SetShouldRecordStats(true), and empty ones otherwise. Remains
+  // valid after the queue is shut down.
+  // Can be called on any thread.
+  TaskQueueStats GetStats() const;
+
   // Can be called on any thread.
   virtual const char* GetName() const;
 
@@ -324,6 +382,13 @@ class CREVENT_EXPORT TaskQueue : public RefCountedThreadSafe<TaskQueue> {
   // shutdown. Unique ownership of task queues will fix this issue soon.
   RefPtr<SingleThreadTaskRunner> CreateTaskRunner(TaskType task_type);
 
+  // Like CreateTaskRunner(), but the posted tasks must start |deadline| after
+  // they were posted, or after their delay expired. See
+  // Spec::SetTaskDeadline().
+  RefPtr<SingleThreadTaskRunner> CreateTaskRunnerWithDeadline(
+      TaskType task_type,
+      TimeDelta deadline);
+
   // Default task runner which doesn't annotate tasks with a task type.
   const RefPtr<SingleThreadTaskRunner>& task_runner() const {
     return default_task_runner_;
@@ -369,6 +434,7 @@ class CREVENT_EXPORT TaskQueue : public RefCountedThreadSafe<TaskQueue> {
 
  private:
   friend class RefCountedThreadSafe<TaskQueue>;
+  friend class CPUTimeBudgetPool;
   friend class internal::SequenceManagerImpl;
   friend class internal::TaskQueueImpl;
 
@@ -403,6 +469,10 @@ class CREVENT_EXPORT TaskQueue : public RefCountedThreadSafe<TaskQueue> {
   intptr_t voter_count_ = 0;
   const char* name_;
 
+  // Shared with |impl_|, so that GetStats() needs neither |impl_lock_| nor
+  // |impl_|.
+  const RefPtr<internal::TaskQueueStatsRecorder> stats_recorder_;
+
   cr::WeakPtrFactory<TaskQueue> weak_ptr_factory_{this};
 };
 
@@ -7,6 +7,7 @@
 
 #include <inttypes.h>
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 
@@ -16,6 +17,7 @@
 #include "cr_base/strings/stringprintf.h"
 
 #include "cr_event/task/common/scoped_defer_task_posting.h"
+#include "cr_event/task/sequence_manager/cpu_time_budget_pool.h"
 #include "cr_event/task/sequence_manager/sequence_manager_impl.h"
 #include "cr_event/task/sequence_manager/time_domain.h"
 #include "cr_event/task/sequence_manager/work_queue.h"
@@ -80,31 +82,76 @@ bool TaskQueueImpl::GuardedTaskPoster::PostTask(PostedTask task) {
   return true;
 }
 
+bool TaskQueueImpl::GuardedTaskPoster::PostTasks(
+    std::vector<PostedTask> tasks) {
+  // See PostTask().
+  ScopedDeferTaskPosting disallow_task_posting;
+
+  auto token = operations_controller_.TryBeginOperation();
+  if (!token)
+    return false;
+
+  outer_->PostTasks(std::move(tasks));
+  return true;
+}
+
 TaskQueueImpl::TaskRunner::TaskRunner(
     RefPtr<GuardedTaskPoster> task_poster,
     RefPtr<AssociatedThreadId> associated_thread,
-    TaskType task_type)
+    TaskType task_type,
+    TimeDelta deadline)
     : task_poster_(std::move(task_poster)),
       associated_thread_(std::move(associated_thread)),
-      task_type_(task_type) {}
+      task_type_(task_type),
+      deadline_(deadline) {}
 
 TaskQueueImpl::TaskRunner::~TaskRunner() {}
 
 bool TaskQueueImpl::TaskRunner::PostDelayedTask(const Location& location,
                                                 OnceClosure callback,
                                                 TimeDelta delay) {
-  return task_poster_->PostTask(PostedTask(this, std::move(callback), location,
-                                           delay, Nestable::kNestable,
-                                           task_type_));
+  return PostTask(PostedTask(this, std::move(callback), location, delay,
+                            Nestable::kNestable, task_type_));
 }
 
 bool TaskQueueImpl::TaskRunner::PostNonNestableDelayedTask(
     const Location& location,
     OnceClosure callback,
     TimeDelta delay) {
-  return task_poster_->PostTask(PostedTask(this, std::move(callback), location,
-                                           delay, Nestable::kNonNestable,
-                                           task_type_));
+  return PostTask(PostedTask(this, std::move(callback), location, delay,
+                            Nestable::kNonNestable, task_type_));
+}
+
+bool TaskQueueImpl::TaskRunner::PostDelayedTaskWithLeeway(
+    const Location& location,
+    OnceClosure callback,
+    TimeDelta delay,
+    TimeDelta leeway,
+    DelayPolicy delay_policy) {
+  return PostTask(PostedTask(this, std::move(callback), location, delay,
+                            Nestable::kNestable, task_type_, leeway,
+                            delay_policy));
+}
+
+bool TaskQueueImpl::TaskRunner::PostTasks(
+    const Location& location,
+    std::vector<OnceClosure> callbacks) {
+  if (callbacks.empty())
+    return true;
+
+  std::vector<PostedTask> tasks;
+  tasks.reserve(callbacks.size());
+  for (OnceClosure& callback : callbacks) {
+    tasks.emplace_back(this, std::move(callback), location, TimeDelta(),
+                       Nestable::kNestable, task_type_);
+    tasks.back().deadline = deadline_;
+  }
+  return task_poster_->PostTasks(std::move(tasks));
+}
+
+bool TaskQueueImpl::TaskRunner::PostTask(PostedTask task) const {
+  task.deadline = deadline_;
+  return task_poster_->PostTask(std::move(task));
 }
 
 bool TaskQueueImpl::TaskRunner::RunsTasksInCurrentSequence() const {
@@ -121,14 +168,19 @@ TaskQueueImpl::TaskQueueImpl(SequenceManagerImpl* sequence_manager,
                              : AssociatedThreadId::CreateBound()),
       task_poster_(MakeRefCounted<GuardedTaskPoster>(this)),
       any_thread_(time_domain),
-      main_thread_only_(this, time_domain),
+      main_thread_only_(this, time_domain, spec.delayed_task_store),
       empty_queues_to_reload_handle_(
           sequence_manager
               ? sequence_manager->GetFlagToRequestReloadForEmptyQueue(this)
               : AtomicFlagSet::AtomicFlag()),
       should_monitor_quiescence_(spec.should_monitor_quiescence),
       should_notify_observers_(spec.should_notify_observers),
-      delayed_fence_allowed_(spec.delayed_fence_allowed) {
+      delayed_fence_allowed_(spec.delayed_fence_allowed),
+      delayed_task_leeway_(spec.delayed_task_leeway),
+      stats_recorder_(spec.should_record_stats
+                          ? MakeRefCounted<TaskQueueStatsRecorder>(spec.name)
+                          : nullptr),
+      task_deadline_(spec.task_deadline) {
   CR_DCHECK(time_domain);
   UpdateCrossThreadQueueStateLocked();
   // SequenceManager can't be set later, so we need to prevent task runners
@@ -154,21 +206,25 @@ TaskQueueImpl::AnyThread::AnyThread(TimeDomain* time_domain)
 
 TaskQueueImpl::AnyThread::~AnyThread() = default;
 
-TaskQueueImpl::MainThreadOnly::MainThreadOnly(TaskQueueImpl* task_queue,
-                                              TimeDomain* time_domain)
+TaskQueueImpl::MainThreadOnly::MainThreadOnly(
+    TaskQueueImpl* task_queue,
+    TimeDomain* time_domain,
+    TaskQueue::DelayedTaskStore delayed_task_store)
     : time_domain(time_domain),
       delayed_work_queue(
           new WorkQueue(task_queue, "delayed", WorkQueue::QueueType::kDelayed)),
       immediate_work_queue(new WorkQueue(task_queue,
                                          "immediate",
-                                         WorkQueue::QueueType::kImmediate)) {}
+                                         WorkQueue::QueueType::kImmediate)),
+      delayed_incoming_queue(delayed_task_store) {}
 
 TaskQueueImpl::MainThreadOnly::~MainThreadOnly() = default;
 
 RefPtr<SingleThreadTaskRunner> TaskQueueImpl::CreateTaskRunner(
-    TaskType task_type) const {
+    TaskType task_type,
+    TimeDelta deadline) const {
   return MakeRefCounted<TaskRunner>(task_poster_, associated_thread_,
-                                    task_type);
+                                    task_type, deadline);
 }
 
 void TaskQueueImpl::UnregisterTaskQueue() {
@@ -185,7 +241,7 @@ void TaskQueueImpl::UnregisterTaskQueue() {
     cr::internal::CheckedAutoLock lock(any_thread_lock_);
     any_thread_.unregistered = true;
     any_thread_.time_domain = nullptr;
-    immediate_incoming_queue.swap(any_thread_.immediate_incoming_queue);
+    immediate_incoming_queue_.TakeTasks(&immediate_incoming_queue);
     any_thread_.task_queue_observer = nullptr;
   }
 
@@ -227,6 +283,9 @@ void TaskQueueImpl::PostTask(PostedTask task) {
           ? TaskQueueImpl::CurrentThread::kMainThread
           : TaskQueueImpl::CurrentThread::kNotMainThread;
 
+  if (task.deadline.is_zero())
+    task.deadline = task_deadline_;
+
 #if CR_DCHECK_IS_ON()
   MaybeLogPostTask(&task);
   MaybeAdjustTaskDelay(&task, current_thread);
@@ -239,6 +298,36 @@ void TaskQueueImpl::PostTask(PostedTask task) {
   }
 }
 
+void TaskQueueImpl::PostTasks(std::vector<PostedTask> tasks) {
+  CurrentThread current_thread =
+      associated_thread_->IsBoundToCurrentThread()
+          ? TaskQueueImpl::CurrentThread::kMainThread
+          : TaskQueueImpl::CurrentThread::kNotMainThread;
+
+  for (PostedTask& task : tasks) {
+    if (task.deadline.is_zero())
+      task.deadline = task_deadline_;
+  }
+
+#if CR_DCHECK_IS_ON()
+  // Tasks delayed by MaybeAdjustTaskDelay() leave the batch.
+  std::vector<PostedTask> immediate_tasks;
+  immediate_tasks.reserve(tasks.size());
+  for (PostedTask& task : tasks) {
+    MaybeLogPostTask(&task);
+    MaybeAdjustTaskDelay(&task, current_thread);
+    if (task.delay.is_zero())
+      immediate_tasks.push_back(std::move(task));
+    else
+      PostDelayedTaskImpl(std::move(task), current_thread);
+  }
+  tasks = std::move(immediate_tasks);
+#endif  // DCHECK_IS_ON()
+
+  if (!tasks.empty())
+    PostImmediateTasksImpl(std::move(tasks), current_thread);
+}
+
 void TaskQueueImpl::MaybeLogPostTask(PostedTask* task) {
 #if CR_DCHECK_IS_ON()
   if (!sequence_manager_->settings().log_post_task)
@@ -274,51 +363,57 @@ void TaskQueueImpl::PostImmediateTaskImpl(PostedTask task,
   // for details.
   CR_DCHECK(task.callback);
 
-  bool should_schedule_work = false;
-  {
-    // TODO(alexclarke): Maybe add a main thread only immediate_incoming_queue
-    // See https://crbug.com/901800
+  // A deadline is relative to the queue time of immediate tasks.
+  bool add_queue_time_to_tasks = sequence_manager_->GetAddQueueTimeToTasks();
+  if (add_queue_time_to_tasks || delayed_fence_allowed_) {
+    // The main thread may change |any_thread_.time_domain|.
     cr::internal::CheckedAutoLock lock(any_thread_lock_);
-    LazyNow lazy_now = any_thread_.time_domain->CreateLazyNow();
-    bool add_queue_time_to_tasks = sequence_manager_->GetAddQueueTimeToTasks();
-    if (add_queue_time_to_tasks || delayed_fence_allowed_)
-      task.queue_time = lazy_now.Now();
-
-    // The sequence number must be incremented atomically with pushing onto the
-    // incoming queue. Otherwise if there are several threads posting task we
-    // risk breaking the assumption that sequence numbers increase monotonically
-    // within a queue.
-    EnqueueOrder sequence_number = sequence_manager_->GetNextSequenceNumber();
-    bool was_immediate_incoming_queue_empty =
-        any_thread_.immediate_incoming_queue.empty();
-    // Delayed run time is null for an immediate task.
-    cr::TimeTicks delayed_run_time;
-    any_thread_.immediate_incoming_queue.push_back(Task(
-        std::move(task), delayed_run_time, sequence_number, sequence_number));
+    task.queue_time = any_thread_.time_domain->Now();
+  } else if (stats_recorder_ || !task.deadline.is_zero() ||
+             sequence_manager_->IsTaskTracerEnabled()) {
+    // Only the stats, the deadline and the trace use the queue time, so read
+    // the SequenceManager's clock rather than take the lock. It's the clock
+    // of the default time domain, and the one task timings are measured with.
+    task.queue_time = sequence_manager_->NowTicks();
+  }
+
+  // Delayed run time is null for an immediate task. The sequence number and
+  // enqueue order are assigned by |immediate_incoming_queue_|, which keeps them
+  // increasing monotonically within the queue even with several threads
+  // posting.
+  Task pending_task(std::move(task), TimeTicks(), EnqueueOrder());
 
 #if CR_DCHECK_IS_ON()
-    any_thread_.immediate_incoming_queue.back().cross_thread_ =
-        (current_thread == TaskQueueImpl::CurrentThread::kNotMainThread);
+  pending_task.cross_thread_ =
+      (current_thread == TaskQueueImpl::CurrentThread::kNotMainThread);
 #endif
 
-    sequence_manager_->WillQueueTask(
-        &any_thread_.immediate_incoming_queue.back(), name_);
+  sequence_manager_->WillQueueTask(&pending_task, name_);
 
-    if (!any_thread_.on_task_posted_handler.is_null()) {
-      any_thread_.on_task_posted_handler.Run(
-          any_thread_.immediate_incoming_queue.back());
-    }
+  auto next_enqueue_order = [this]() {
+    return sequence_manager_->GetNextSequenceNumber();
+  };
 
-    // If this queue was completely empty, then the SequenceManager needs to be
-    // informed so it can reload the work queue and add us to the
-    // TaskQueueSelector which can only be done from the main thread. In
-    // addition it may need to schedule a DoWork if this queue isn't blocked.
-    if (was_immediate_incoming_queue_empty &&
-        any_thread_.immediate_work_queue_empty) {
-      empty_queues_to_reload_handle_.SetActive(true);
-      should_schedule_work =
-          any_thread_.post_immediate_task_should_schedule_work;
-    }
+  bool should_schedule_work = false;
+  if (has_on_task_posted_handler_.load(std::memory_order_acquire)) {
+    // The handler must see the task in the queue, so keep the main thread from
+    // taking it meanwhile.
+    cr::internal::CheckedAutoLock lock(any_thread_lock_);
+    Task* pushed_task = nullptr;
+    bool was_immediate_incoming_queue_empty = immediate_incoming_queue_.Push(
+        std::move(pending_task), next_enqueue_order, &pushed_task);
+
+    if (!any_thread_.on_task_posted_handler.is_null())
+      any_thread_.on_task_posted_handler.Run(*pushed_task);
+
+    if (was_immediate_incoming_queue_empty)
+      should_schedule_work = OnImmediateIncomingQueueNoLongerEmptyLocked();
+  } else if (immediate_incoming_queue_.Push(std::move(pending_task),
+                                            next_enqueue_order)) {
+    // Pushing onto a non-empty queue needs nothing more: whoever pushed onto
+    // it while it was empty takes care of the wake-up.
+    cr::internal::CheckedAutoLock lock(any_thread_lock_);
+    should_schedule_work = OnImmediateIncomingQueueNoLongerEmptyLocked();
   }
 
   // On windows it's important to call this outside of a lock because calling a
@@ -338,6 +433,86 @@ void TaskQueueImpl::PostImmediateTaskImpl(PostedTask task,
   TraceQueueSize();
 }
 
+void TaskQueueImpl::PostImmediateTasksImpl(std::vector<PostedTask> tasks,
+                                           CurrentThread current_thread) {
+  // All the tasks of the batch share their queue time, if any.
+  TimeTicks queue_time;
+  // The tasks of a batch come from the same task runner, hence share their
+  // deadline.
+  bool add_queue_time_to_tasks = sequence_manager_->GetAddQueueTimeToTasks();
+  if (add_queue_time_to_tasks || delayed_fence_allowed_) {
+    cr::internal::CheckedAutoLock lock(any_thread_lock_);
+    queue_time = any_thread_.time_domain->Now();
+  } else if (stats_recorder_ || !tasks.front().deadline.is_zero() ||
+             sequence_manager_->IsTaskTracerEnabled()) {
+    // See PostImmediateTaskImpl().
+    queue_time = sequence_manager_->NowTicks();
+  }
+
+  std::vector<Task> pending_tasks;
+  pending_tasks.reserve(tasks.size());
+  for (PostedTask& task : tasks) {
+    CR_DCHECK(task.callback);
+    task.queue_time = queue_time;
+    // See PostImmediateTaskImpl().
+    pending_tasks.emplace_back(std::move(task), TimeTicks(), EnqueueOrder());
+
+#if CR_DCHECK_IS_ON()
+    pending_tasks.back().cross_thread_ =
+        (current_thread == TaskQueueImpl::CurrentThread::kNotMainThread);
+#endif
+
+    sequence_manager_->WillQueueTask(&pending_tasks.back(), name_);
+  }
+
+  auto next_enqueue_orders = [this](size_t count) {
+    return sequence_manager_->GetNextSequenceNumbers(count);
+  };
+
+  bool should_schedule_work = false;
+  if (has_on_task_posted_handler_.load(std::memory_order_acquire)) {
+    cr::internal::CheckedAutoLock lock(any_thread_lock_);
+    std::vector<Task*> pushed_tasks;
+    bool was_immediate_incoming_queue_empty =
+        immediate_incoming_queue_.PushBatch(std::move(pending_tasks),
+                                            next_enqueue_orders,
+                                            &pushed_tasks);
+
+    if (!any_thread_.on_task_posted_handler.is_null()) {
+      for (Task* pushed_task : pushed_tasks)
+        any_thread_.on_task_posted_handler.Run(*pushed_task);
+    }
+
+    if (was_immediate_incoming_queue_empty)
+      should_schedule_work = OnImmediateIncomingQueueNoLongerEmptyLocked();
+  } else if (immediate_incoming_queue_.PushBatch(std::move(pending_tasks),
+                                                 next_enqueue_orders)) {
+    cr::internal::CheckedAutoLock lock(any_thread_lock_);
+    should_schedule_work = OnImmediateIncomingQueueNoLongerEmptyLocked();
+  }
+
+  // See PostImmediateTaskImpl() for why this is done outside of the lock.
+  if (should_schedule_work)
+    sequence_manager_->ScheduleWork();
+
+  TraceQueueSize();
+}
+
+bool TaskQueueImpl::OnImmediateIncomingQueueNoLongerEmptyLocked() {
+  // If this queue was completely empty, then the SequenceManager needs to be
+  // informed so it can reload the work queue and add us to the
+  // TaskQueueSelector which can only be done from the main thread. In
+  // addition it may need to schedule a DoWork if this queue isn't blocked.
+  //
+  // The main thread takes |immediate_incoming_queue_| and updates
+  // |any_thread_.immediate_work_queue_empty| while holding the lock, so if the
+  // work queue is seen empty here the task just pushed hasn't been taken yet.
+  if (!any_thread_.immediate_work_queue_empty)
+    return false;
+  empty_queues_to_reload_handle_.SetActive(true);
+  return any_thread_.post_immediate_task_should_schedule_work;
+}
+
 void TaskQueueImpl::PostDelayedTaskImpl(PostedTask task,
                                         CurrentThread current_thread) {
   // Use CHECK instead of DCHECK to crash earlier. See http://crbug.com/711167
@@ -360,9 +535,12 @@ void TaskQueueImpl::PostDelayedTaskImpl(PostedTask task,
     EnqueueOrder sequence_number = sequence_manager_->GetNextSequenceNumber();
 
     TimeTicks time_domain_now = main_thread_only().time_domain->Now();
-    TimeTicks time_domain_delayed_run_time = time_domain_now + task.delay;
-    if (sequence_manager_->GetAddQueueTimeToTasks())
+    TimeTicks time_domain_delayed_run_time =
+        GetDelayedRunTime(task, time_domain_now);
+    if (sequence_manager_->GetAddQueueTimeToTasks() ||
+        sequence_manager_->IsTaskTracerEnabled()) {
       task.queue_time = time_domain_now;
+    }
 
     PushOntoDelayedIncomingQueueFromMainThread(
         Task(std::move(task), time_domain_delayed_run_time, sequence_number,
@@ -380,9 +558,12 @@ void TaskQueueImpl::PostDelayedTaskImpl(PostedTask task,
       cr::internal::CheckedAutoLock lock(any_thread_lock_);
       time_domain_now = any_thread_.time_domain->Now();
     }
-    TimeTicks time_domain_delayed_run_time = time_domain_now + task.delay;
-    if (sequence_manager_->GetAddQueueTimeToTasks())
+    TimeTicks time_domain_delayed_run_time =
+        GetDelayedRunTime(task, time_domain_now);
+    if (sequence_manager_->GetAddQueueTimeToTasks() ||
+        sequence_manager_->IsTaskTracerEnabled()) {
       task.queue_time = time_domain_now;
+    }
 
     PushOntoDelayedIncomingQueue(
         Task(std::move(task), time_domain_delayed_run_time, sequence_number,
@@ -390,6 +571,28 @@ void TaskQueueImpl::PostDelayedTaskImpl(PostedTask task,
   }
 }
 
+TimeTicks TaskQueueImpl::GetDelayedRunTime(const PostedTask& task,
+                                           TimeTicks now) const {
+  const TimeTicks delayed_run_time = now + task.delay;
+  if (task.delay_policy == DelayPolicy::kPrecise)
+    return delayed_run_time;
+
+  const TimeDelta leeway = std::max(task.leeway, delayed_task_leeway_);
+  if (leeway <= TimeDelta())
+    return delayed_run_time;
+
+  // Round up to the next multiple of |leeway|, or down for kFlexiblePreferEarly
+  // tasks. A task with a precise sibling due in the same window may now run
+  // after it, which its leeway allows.
+  const TimeTicks aligned_run_time =
+      delayed_run_time.SnappedToNextTick(TimeTicks(), leeway);
+  if (task.delay_policy == DelayPolicy::kFlexiblePreferEarly &&
+      aligned_run_time != delayed_run_time) {
+    return aligned_run_time - leeway;
+  }
+  return aligned_run_time;
+}
+
 void TaskQueueImpl::PushOntoDelayedIncomingQueueFromMainThread(
     Task pending_task,
     TimeTicks now,
@@ -463,11 +666,7 @@ void TaskQueueImpl::ReloadEmptyImmediateWorkQueue() {
 void TaskQueueImpl::TakeImmediateIncomingQueueTasks(TaskDeque* queue) {
   cr::internal::CheckedAutoLock lock(any_thread_lock_);
   CR_DCHECK(queue->empty());
-  queue->swap(any_thread_.immediate_incoming_queue);
-
-  // Since |immediate_incoming_queue| is empty, now is a good time to consider
-  // reducing it's capacity if we're wasting memory.
-  any_thread_.immediate_incoming_queue.MaybeShrinkQueue();
+  immediate_incoming_queue_.TakeTasks(queue);
 
   // Activate delayed fence if necessary. This is ideologically similar to
   // ActivateDelayedFenceIfNeeded, but due to immediate tasks being posted
@@ -503,8 +702,7 @@ bool TaskQueueImpl::IsEmpty() const {
     return false;
   }
 
-  cr::internal::CheckedAutoLock lock(any_thread_lock_);
-  return any_thread_.immediate_incoming_queue.empty();
+  return immediate_incoming_queue_.empty();
 }
 
 size_t TaskQueueImpl::GetNumberOfPendingTasks() const {
@@ -512,9 +710,7 @@ size_t TaskQueueImpl::GetNumberOfPendingTasks() const {
   task_count += main_thread_only().delayed_work_queue->Size();
   task_count += main_thread_only().delayed_incoming_queue.size();
   task_count += main_thread_only().immediate_work_queue->Size();
-
-  cr::internal::CheckedAutoLock lock(any_thread_lock_);
-  task_count += any_thread_.immediate_incoming_queue.size();
+  task_count += immediate_incoming_queue_.size();
   return task_count;
 }
 
@@ -534,8 +730,7 @@ bool TaskQueueImpl::HasTaskToRunImmediately() const {
   }
 
   // Finally tasks on |immediate_incoming_queue| count as immediate work.
-  cr::internal::CheckedAutoLock lock(any_thread_lock_);
-  return !any_thread_.immediate_incoming_queue.empty();
+  return !immediate_incoming_queue_.empty();
 }
 
 Optional<DelayedWakeUp> TaskQueueImpl::GetNextScheduledWakeUpImpl() {
@@ -721,11 +916,10 @@ void TaskQueueImpl::InsertFence(TaskQueue::InsertFencePosition position) {
     cr::internal::CheckedAutoLock lock(any_thread_lock_);
     if (!front_task_unblocked && previous_fence &&
         previous_fence < current_fence) {
-      if (!any_thread_.immediate_incoming_queue.empty() &&
-          any_thread_.immediate_incoming_queue.front().enqueue_order() >
-              previous_fence &&
-          any_thread_.immediate_incoming_queue.front().enqueue_order() <
-              current_fence) {
+      EnqueueOrder oldest_incoming_task =
+          immediate_incoming_queue_.GetOldestEnqueueOrder();
+      if (oldest_incoming_task && oldest_incoming_task > previous_fence &&
+          oldest_incoming_task < current_fence) {
         front_task_unblocked = true;
       }
     }
@@ -761,11 +955,10 @@ void TaskQueueImpl::RemoveFence() {
   {
     cr::internal::CheckedAutoLock lock(any_thread_lock_);
     if (!front_task_unblocked && previous_fence) {
-      if (!any_thread_.immediate_incoming_queue.empty() &&
-          any_thread_.immediate_incoming_queue.front().enqueue_order() >
-              previous_fence) {
+      EnqueueOrder oldest_incoming_task =
+          immediate_incoming_queue_.GetOldestEnqueueOrder();
+      if (oldest_incoming_task && oldest_incoming_task > previous_fence)
         front_task_unblocked = true;
-      }
     }
 
     UpdateCrossThreadQueueStateLocked();
@@ -786,12 +979,12 @@ bool TaskQueueImpl::BlockedByFence() const {
     return false;
   }
 
-  cr::internal::CheckedAutoLock lock(any_thread_lock_);
-  if (any_thread_.immediate_incoming_queue.empty())
+  EnqueueOrder oldest_incoming_task =
+      immediate_incoming_queue_.GetOldestEnqueueOrder();
+  if (!oldest_incoming_task)
     return true;
 
-  return any_thread_.immediate_incoming_queue.front().enqueue_order() >
-         main_thread_only().current_fence;
+  return oldest_incoming_task > main_thread_only().current_fence;
 }
 
 bool TaskQueueImpl::HasActiveFence() {
@@ -899,18 +1092,14 @@ void TaskQueueImpl::ReclaimMemory(TimeTicks now) {
   main_thread_only().delayed_work_queue->MaybeShrinkQueue();
   main_thread_only().immediate_work_queue->MaybeShrinkQueue();
 
-  {
-    cr::internal::CheckedAutoLock lock(any_thread_lock_);
-    any_thread_.immediate_incoming_queue.MaybeShrinkQueue();
-  }
-
   LazyNow lazy_now(now);
   UpdateDelayedWakeUp(&lazy_now);
 }
 
 void TaskQueueImpl::PushImmediateIncomingTaskForTest(Task&& task) {
-  cr::internal::CheckedAutoLock lock(any_thread_lock_);
-  any_thread_.immediate_incoming_queue.push_back(std::move(task));
+  EnqueueOrder enqueue_order = task.enqueue_order();
+  immediate_incoming_queue_.Push(std::move(task),
+                                 [enqueue_order]() { return enqueue_order; });
 }
 
 void TaskQueueImpl::RequeueDeferredNonNestableTask(
@@ -991,14 +1180,13 @@ bool TaskQueueImpl::HasPendingImmediateWork() {
   }
 
   // Finally tasks on |immediate_incoming_queue| count as immediate work.
-  cr::internal::CheckedAutoLock lock(any_thread_lock_);
-  return !any_thread_.immediate_incoming_queue.empty();
+  return !immediate_incoming_queue_.empty();
 }
 
 bool TaskQueueImpl::HasPendingImmediateWorkLocked() {
   return !main_thread_only().delayed_work_queue->Empty() ||
          !main_thread_only().immediate_work_queue->Empty() ||
-         !any_thread_.immediate_incoming_queue.empty();
+         !immediate_incoming_queue_.empty();
 }
 
 void TaskQueueImpl::SetOnTaskStartedHandler(
@@ -1030,12 +1218,59 @@ void TaskQueueImpl::OnTaskCompleted(const Task& task,
 
 bool TaskQueueImpl::RequiresTaskTiming() const {
   return !main_thread_only().on_task_started_handler.is_null() ||
-         !main_thread_only().on_task_completed_handler.is_null();
+         !main_thread_only().on_task_completed_handler.is_null() ||
+         stats_recorder_ || main_thread_only().budget_pool;
+}
+
+void TaskQueueImpl::RecordStatsOnTaskStarted(
+    const Task& task,
+    const TaskQueue::TaskTiming& task_timing) {
+  if (!stats_recorder_)
+    return;
+
+  // |task| has already left its work queue. The incoming immediate tasks are
+  // ready to run too, they're just not reloaded yet.
+  const size_t backlog = 1 + main_thread_only().immediate_work_queue->Size() +
+                         main_thread_only().delayed_work_queue->Size() +
+                         immediate_incoming_queue_.size();
+  stats_recorder_->RecordTaskStarted(backlog);
+
+  // The tasks of the queue all have a queue time, see PostImmediateTaskImpl().
+  stats_recorder_->RecordQueueingDelay(task_timing.start_time() -
+                                       GetTaskDesiredExecutionTime(task));
+}
+
+void TaskQueueImpl::RecordStatsOnTaskCompleted(
+    const TaskQueue::TaskTiming& task_timing,
+    LazyNow* lazy_now) {
+  if (!stats_recorder_)
+    return;
+  stats_recorder_->RecordTaskCompleted(lazy_now->Now() -
+                                       task_timing.start_time());
+}
+
+void TaskQueueImpl::SetBudgetPool(CPUTimeBudgetPool* budget_pool) {
+  CR_DCHECK_CALLED_ON_VALID_THREAD(associated_thread_->thread_checker);
+  main_thread_only().budget_pool = budget_pool;
+}
+
+void TaskQueueImpl::ChargeBudgetPoolOnTaskCompleted(
+    const TaskQueue::TaskTiming& task_timing) {
+  CPUTimeBudgetPool* budget_pool = main_thread_only().budget_pool;
+  if (!budget_pool)
+    return;
+  CR_DCHECK(task_timing.state() == TaskQueue::TaskTiming::State::Finished);
+  const TimeDelta cpu_time = task_timing.has_thread_time()
+                                 ? task_timing.thread_duration()
+                                 : task_timing.wall_duration();
+  budget_pool->RecordTaskRunTime(cpu_time, task_timing.end_time());
 }
 
 void TaskQueueImpl::SetOnTaskPostedHandler(OnTaskPostedHandler handler) {
   CR_DCHECK(should_notify_observers_ || handler.is_null());
   cr::internal::CheckedAutoLock lock(any_thread_lock_);
+  has_on_task_posted_handler_.store(!handler.is_null(),
+                                    std::memory_order_release);
   any_thread_.on_task_posted_handler = std::move(handler);
 }
 
@@ -1076,13 +1311,21 @@ void TaskQueueImpl::OnQueueUnblocked() {
   }
 }
 
-TaskQueueImpl::DelayedIncomingQueue::DelayedIncomingQueue() = default;
+TaskQueueImpl::DelayedIncomingQueue::DelayedIncomingQueue(
+    TaskQueue::DelayedTaskStore store) {
+  if (store == TaskQueue::DelayedTaskStore::kTimingWheel)
+    timing_wheel_ = std::make_unique<DelayedTaskTimingWheel>();
+}
+
 TaskQueueImpl::DelayedIncomingQueue::~DelayedIncomingQueue() = default;
 
 void TaskQueueImpl::DelayedIncomingQueue::push(Task&& task) {
   if (task.is_high_res)
     pending_high_res_tasks_++;
-  queue_.push(std::move(task));
+  if (timing_wheel_)
+    timing_wheel_->push(std::move(task));
+  else
+    queue_.push(std::move(task));
 }
 
 void TaskQueueImpl::DelayedIncomingQueue::pop() {
@@ -1091,18 +1334,34 @@ void TaskQueueImpl::DelayedIncomingQueue::pop() {
     pending_high_res_tasks_--;
     CR_DCHECK(pending_high_res_tasks_ >= 0);
   }
-  queue_.pop();
+  if (timing_wheel_)
+    timing_wheel_->pop();
+  else
+    queue_.pop();
 }
 
 void TaskQueueImpl::DelayedIncomingQueue::swap(DelayedIncomingQueue* rhs) {
   std::swap(pending_high_res_tasks_, rhs->pending_high_res_tasks_);
   std::swap(queue_, rhs->queue_);
+  std::swap(timing_wheel_, rhs->timing_wheel_);
   CR_DCHECK(pending_high_res_tasks_ >= 0);
 }
 
 void TaskQueueImpl::DelayedIncomingQueue::SweepCancelledTasks(
     SequenceManagerImpl* sequence_manager) {
-  pending_high_res_tasks_ -= queue_.SweepCancelledTasks(sequence_manager);
+  if (!timing_wheel_) {
+    pending_high_res_tasks_ -= queue_.SweepCancelledTasks(sequence_manager);
+    return;
+  }
+
+  // As below, delete the cancelled tasks once the wheel is consistent again.
+  std::vector<Task> cancelled_tasks;
+  timing_wheel_->RemoveCancelledTasks(&cancelled_tasks);
+  for (const Task& task : cancelled_tasks) {
+    if (task.is_high_res)
+      pending_high_res_tasks_--;
+  }
+  CR_DCHECK(pending_high_res_tasks_ >= 0);
 }
 
 size_t TaskQueueImpl::DelayedIncomingQueue::PQueue::SweepCancelledTasks(
@@ -8,10 +8,12 @@
 
 #include <stddef.h>
 
+#include <atomic>
 #include <memory>
 #include <queue>
 #include <set>
 #include <utility>
+#include <vector>
 
 #include "cr_base/functional/callback.h"
 #include "cr_base/memory/weak_ptr.h"
@@ -25,15 +27,19 @@
 #include "cr_event/task/common/operations_controller.h"
 #include "cr_event/task/sequence_manager/associated_thread_id.h"
 #include "cr_event/task/sequence_manager/atomic_flag_set.h"
+#include "cr_event/task/sequence_manager/delayed_task_timing_wheel.h"
 #include "cr_event/task/sequence_manager/enqueue_order.h"
+#include "cr_event/task/sequence_manager/incoming_task_queue.h"
 #include "cr_event/task/sequence_manager/lazily_deallocated_deque.h"
 #include "cr_event/task/sequence_manager/sequenced_task_source.h"
 #include "cr_event/task/sequence_manager/task_queue.h"
+#include "cr_event/task/sequence_manager/task_queue_stats.h"
 #include "cr_event/threading/thread_checker.h"
 
 namespace cr {
 namespace sequence_manager {
 
+class CPUTimeBudgetPool;
 class LazyNow;
 class TimeDomain;
 
@@ -54,9 +60,10 @@ class WorkQueueSets;
 //    |delayed_work_queue| - SequenceManager takes delayed tasks here.
 //
 // The |immediate_incoming_queue| can be accessed from any thread, the other
-// queues are main-thread only. To reduce the overhead of locking,
-// |immediate_work_queue| is swapped with |immediate_incoming_queue| when
-// |immediate_work_queue| becomes empty.
+// queues are main-thread only. It's a lock-free IncomingTaskQueue: posting
+// only takes |any_thread_lock_| when the queue was empty, to decide whether
+// the SequenceManager must be woken up. All of its tasks are moved to
+// |immediate_work_queue| at once when |immediate_work_queue| becomes empty.
 //
 // Delayed tasks are initially posted to |delayed_incoming_queue| and a wake-up
 // is scheduled with the TimeDomain.  When the delay has elapsed, the TimeDomain
@@ -102,7 +109,8 @@ class CREVENT_EXPORT TaskQueueImpl {
 
   // May be called from any thread.
   RefPtr<SingleThreadTaskRunner> CreateTaskRunner(
-      TaskType task_type) const;
+      TaskType task_type,
+      TimeDelta deadline = TimeDelta()) const;
 
   // TaskQueue implementation.
   const char* GetName() const;
@@ -145,6 +153,18 @@ class CREVENT_EXPORT TaskQueueImpl {
   bool GetQuiescenceMonitored() const { return should_monitor_quiescence_; }
   bool GetShouldNotifyObservers() const { return should_notify_observers_; }
 
+  // Null unless the queue records stats, see TaskQueue::GetStats().
+  const RefPtr<TaskQueueStatsRecorder>& stats_recorder() const {
+    return stats_recorder_;
+  }
+
+  // The pool charged for the tasks of the queue, if any. Set by
+  // CPUTimeBudgetPool.
+  void SetBudgetPool(CPUTimeBudgetPool* budget_pool);
+  CPUTimeBudgetPool* budget_pool() const {
+    return main_thread_only().budget_pool;
+  }
+
   void NotifyWillProcessTask(const Task& task,
                              bool was_blocked_or_low_priority);
   void NotifyDidProcessTask(const Task& task);
@@ -215,6 +235,19 @@ class CREVENT_EXPORT TaskQueueImpl {
                        LazyNow* lazy_now);
   bool RequiresTaskTiming() const;
 
+  // Update the stats, if the queue records them, as |task| starts and
+  // completes. |task_timing| must have the wall time.
+  void RecordStatsOnTaskStarted(const Task& task,
+                                const TaskQueue::TaskTiming& task_timing);
+  void RecordStatsOnTaskCompleted(const TaskQueue::TaskTiming& task_timing,
+                                  LazyNow* lazy_now);
+
+  // Charges the budget pool of the queue, if any, for a task which just
+  // completed. |task_timing| must be finished and have the wall time, and the
+  // thread time if supported.
+  void ChargeBudgetPoolOnTaskCompleted(
+      const TaskQueue::TaskTiming& task_timing);
+
   // Set a callback for adding custom functionality for processing posted task.
   // Callback will be dispatched while holding a scheduler lock. As a result,
   // callback should not call scheduler APIs directly, as this can lead to
@@ -251,6 +284,7 @@ class CREVENT_EXPORT TaskQueueImpl {
     explicit GuardedTaskPoster(TaskQueueImpl* outer);
 
     bool PostTask(PostedTask task);
+    bool PostTasks(std::vector<PostedTask> tasks);
 
     void StartAcceptingOperations() {
       operations_controller_.StartAcceptingOperations();
@@ -274,7 +308,8 @@ class CREVENT_EXPORT TaskQueueImpl {
    public:
     explicit TaskRunner(RefPtr<GuardedTaskPoster> task_poster,
                         RefPtr<AssociatedThreadId> associated_thread,
-                        TaskType task_type);
+                        TaskType task_type,
+                        TimeDelta deadline = TimeDelta());
 
     bool PostDelayedTask(const Location& location,
                          OnceClosure callback,
@@ -282,6 +317,13 @@ class CREVENT_EXPORT TaskQueueImpl {
     bool PostNonNestableDelayedTask(const Location& location,
                                     OnceClosure callback,
                                     TimeDelta delay) final;
+    bool PostDelayedTaskWithLeeway(const Location& location,
+                                   OnceClosure callback,
+                                   TimeDelta delay,
+                                   TimeDelta leeway,
+                                   DelayPolicy delay_policy) final;
+    bool PostTasks(const Location& location,
+                   std::vector<OnceClosure> callbacks) final;
     bool RunsTasksInCurrentSequence() const final;
 
    private:
@@ -292,21 +334,32 @@ class CREVENT_EXPORT TaskQueueImpl {
     const RefPtr<GuardedTaskPoster> task_poster_;
     const RefPtr<AssociatedThreadId> associated_thread_;
     const TaskType task_type_;
+    // See TaskQueue::CreateTaskRunnerWithDeadline().
+    const TimeDelta deadline_;
   };
 
-  // A queue for holding delayed tasks before their delay has expired.
+  // A queue for holding delayed tasks before their delay has expired. The
+  // tasks are stored in |timing_wheel_| if the queue was created with
+  // TaskQueue::DelayedTaskStore::kTimingWheel, in |queue_| otherwise.
   struct DelayedIncomingQueue {
    public:
-    DelayedIncomingQueue();
+    explicit DelayedIncomingQueue(
+        TaskQueue::DelayedTaskStore store = TaskQueue::DelayedTaskStore::kHeap);
     DelayedIncomingQueue(const DelayedIncomingQueue&) = delete;
     DelayedIncomingQueue& operator=(const DelayedIncomingQueue&) = delete;
     ~DelayedIncomingQueue();
 
     void push(Task&& task);
     void pop();
-    bool empty() const { return queue_.empty(); }
-    size_t size() const { return queue_.size(); }
-    const Task& top() const { return queue_.top(); }
+    bool empty() const {
+      return timing_wheel_ ? timing_wheel_->empty() : queue_.empty();
+    }
+    size_t size() const {
+      return timing_wheel_ ? timing_wheel_->size() : queue_.size();
+    }
+    const Task& top() const {
+      return timing_wheel_ ? timing_wheel_->top() : queue_.top();
+    }
     void swap(DelayedIncomingQueue* other);
 
     bool has_pending_high_resolution_tasks() const {
@@ -316,7 +369,6 @@ class CREVENT_EXPORT TaskQueueImpl {
     // TODO(crbug.com/1155905): we pass SequenceManager to be able to record
     // crash keys. Remove this parameter after chasing down this crash.
     void SweepCancelledTasks(SequenceManagerImpl* sequence_manager);
-    std::priority_queue<Task> TakeTasks() { return std::move(queue_); }
 
    private:
     struct PQueue : public std::priority_queue<Task> {
@@ -330,13 +382,16 @@ class CREVENT_EXPORT TaskQueueImpl {
     };
 
     PQueue queue_;
+    std::unique_ptr<DelayedTaskTimingWheel> timing_wheel_;
 
     // Number of pending tasks in the queue that need high resolution timing.
     intptr_t pending_high_res_tasks_ = 0;
   };
 
   struct MainThreadOnly {
-    MainThreadOnly(TaskQueueImpl* task_queue, TimeDomain* time_domain);
+    MainThreadOnly(TaskQueueImpl* task_queue,
+                   TimeDomain* time_domain,
+                   TaskQueue::DelayedTaskStore delayed_task_store);
     ~MainThreadOnly();
 
     // Another copy of TimeDomain for lock-free access from the main thread.
@@ -378,6 +433,7 @@ class CREVENT_EXPORT TaskQueueImpl {
         enqueue_order_at_which_we_became_unblocked_with_normal_priority;
     OnTaskStartedHandler on_task_started_handler;
     OnTaskCompletedHandler on_task_completed_handler;
+    CPUTimeBudgetPool* budget_pool = nullptr;  // NOT OWNED
     // Last reported wake up, used only in UpdateWakeUp to avoid
     // excessive calls.
     Optional<DelayedWakeUp> scheduled_wake_up;
@@ -390,9 +446,22 @@ class CREVENT_EXPORT TaskQueueImpl {
 
   void PostTask(PostedTask task);
 
+  // Posts |tasks| in order. The immediate ones are pushed onto
+  // |immediate_incoming_queue_| at once, with consecutive enqueue orders and
+  // at most one wake-up.
+  void PostTasks(std::vector<PostedTask> tasks);
+
   void PostImmediateTaskImpl(PostedTask task, CurrentThread current_thread);
+  void PostImmediateTasksImpl(std::vector<PostedTask> tasks,
+                              CurrentThread current_thread);
   void PostDelayedTaskImpl(PostedTask task, CurrentThread current_thread);
 
+  // Returns the run time of the delayed |task| posted at |now|. Unless it's
+  // precise, it is aligned to a multiple of the leeway of |task|, or of
+  // |delayed_task_leeway_| if bigger, so that the tasks posted with the same
+  // leeway share their wake-ups.
+  TimeTicks GetDelayedRunTime(const PostedTask& task, TimeTicks now) const;
+
   // Push the task onto the |delayed_incoming_queue|. Lock-free main thread
   // only fast path.
   void PushOntoDelayedIncomingQueueFromMainThread(Task pending_task,
@@ -411,8 +480,7 @@ class CREVENT_EXPORT TaskQueueImpl {
 
   // LazilyDeallocatedDeque use TimeTicks to figure out when to resize.  We
   // should use real time here always.
-  using TaskDeque =
-      LazilyDeallocatedDeque<Task, TimeTicks::Now>;
+  using TaskDeque = IncomingTaskQueue::TaskDeque;
 
   // Extracts all the tasks from the immediate incoming queue and swaps it with
   // |queue| which must be empty.
@@ -432,6 +500,10 @@ class CREVENT_EXPORT TaskQueueImpl {
   // Updates state protected by any_thread_lock_.
   void UpdateCrossThreadQueueStateLocked();
 
+  // Called after pushing onto an empty |immediate_incoming_queue_|. Returns
+  // true if the SequenceManager must be scheduled.
+  bool OnImmediateIncomingQueueNoLongerEmptyLocked();
+
   void MaybeLogPostTask(PostedTask* task);
   void MaybeAdjustTaskDelay(PostedTask* task, CurrentThread current_thread);
 
@@ -458,8 +530,6 @@ class CREVENT_EXPORT TaskQueueImpl {
 
     TaskQueue::Observer* task_queue_observer = nullptr;
 
-    TaskDeque immediate_incoming_queue;
-
     // True if main_thread_only().immediate_work_queue is empty.
     bool immediate_work_queue_empty = true;
 
@@ -480,6 +550,15 @@ class CREVENT_EXPORT TaskQueueImpl {
 
   AnyThread any_thread_ /* GUARDED_BY(any_thread_lock_) */;
 
+  // Tasks are pushed without holding |any_thread_lock_|, but taken with it
+  // held so that a push onto an empty queue and the update of
+  // |any_thread_.immediate_work_queue_empty| are seen in a consistent order.
+  IncomingTaskQueue immediate_incoming_queue_;
+
+  // Whether |any_thread_.on_task_posted_handler| is set, checked before
+  // taking |any_thread_lock_| to run it.
+  std::atomic<bool> has_on_task_posted_handler_{false};
+
   MainThreadOnly main_thread_only_;
   MainThreadOnly& main_thread_only() {
     CR_DCHECK_CALLED_ON_VALID_THREAD(associated_thread_->thread_checker);
@@ -500,6 +579,9 @@ class CREVENT_EXPORT TaskQueueImpl {
   const bool should_monitor_quiescence_;
   const bool should_notify_observers_;
   const bool delayed_fence_allowed_;
+  const TimeDelta delayed_task_leeway_;
+  const RefPtr<TaskQueueStatsRecorder> stats_recorder_;
+  const TimeDelta task_deadline_;
 };
 
 }  // namespace internal
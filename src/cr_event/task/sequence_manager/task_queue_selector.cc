@@ -26,6 +26,7 @@ TaskQueueSelector::TaskQueueSelector(
 #if CR_DCHECK_IS_ON()
       random_task_selection_(settings.random_task_selection_seed != 0),
 #endif
+      earliest_deadline_first_(settings.earliest_deadline_first),
       delayed_work_queue_sets_("delayed", this, settings),
       immediate_work_queue_sets_("immediate", this, settings) {
 }
@@ -187,6 +188,11 @@ WorkQueue* TaskQueueSelector::SelectWorkQueueToService(
   // task, HighestActivePriority(...) returns the priority of the delayed task
   // but the resulting queue must be the lower one.
   if (option == SelectTaskOption::kSkipDelayedTask) {
+    if (earliest_deadline_first_) {
+      return ApplyDeadlineStarvationLimit(
+          immediate_work_queue_sets_.GetEarliestDeadlineQueueInSet(priority),
+          ChooseImmediateOnlyWithPriority<SetOperationOldest>(priority));
+    }
     WorkQueue* queue =
 #if CR_DCHECK_IS_ON()
         random_task_selection_
@@ -197,12 +203,20 @@ WorkQueue* TaskQueueSelector::SelectWorkQueueToService(
     return queue;
   }
 
-  WorkQueue* queue =
+  WorkQueue* queue;
+  if (earliest_deadline_first_) {
+    queue = ApplyDeadlineStarvationLimit(
+        ChooseEarliestDeadlineWithPriority(priority),
+        ChooseWithPriority<SetOperationOldest>(priority));
+  } else {
+    queue =
 #if CR_DCHECK_IS_ON()
-      random_task_selection_ ? ChooseWithPriority<SetOperationRandom>(priority)
-                             :
+        random_task_selection_
+            ? ChooseWithPriority<SetOperationRandom>(priority)
+            :
 #endif
-                             ChooseWithPriority<SetOperationOldest>(priority);
+            ChooseWithPriority<SetOperationOldest>(priority);
+  }
 
   // If we have selected a delayed task while having an immediate task of the
   // same priority, increase the starvation count.
@@ -215,6 +229,38 @@ WorkQueue* TaskQueueSelector::SelectWorkQueueToService(
   return queue;
 }
 
+WorkQueue* TaskQueueSelector::ChooseEarliestDeadlineWithPriority(
+    TaskQueue::QueuePriority priority) const {
+  WorkQueueSets::TaskDeadline immediate_deadline;
+  WorkQueue* immediate_queue =
+      immediate_work_queue_sets_.GetEarliestDeadlineQueueAndDeadlineInSet(
+          priority, &immediate_deadline);
+  WorkQueueSets::TaskDeadline delayed_deadline;
+  WorkQueue* delayed_queue =
+      delayed_work_queue_sets_.GetEarliestDeadlineQueueAndDeadlineInSet(
+          priority, &delayed_deadline);
+  if (!delayed_queue)
+    return immediate_queue;
+  if (!immediate_queue)
+    return delayed_queue;
+  return immediate_deadline <= delayed_deadline ? immediate_queue
+                                                : delayed_queue;
+}
+
+WorkQueue* TaskQueueSelector::ApplyDeadlineStarvationLimit(
+    WorkQueue* earliest_deadline_queue,
+    WorkQueue* oldest_queue) {
+  // Count the tasks run ahead of the oldest one, which runs once there are
+  // too many.
+  if (earliest_deadline_queue == oldest_queue ||
+      deadline_starvation_count_ >= kMaxDeadlineStarvationTasks) {
+    deadline_starvation_count_ = 0;
+    return oldest_queue;
+  }
+  deadline_starvation_count_++;
+  return earliest_deadline_queue;
+}
+
 void TaskQueueSelector::SetTaskQueueSelectorObserver(Observer* observer) {
   task_queue_selector_observer_ = observer;
 }
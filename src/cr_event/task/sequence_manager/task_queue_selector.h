@@ -103,6 +103,10 @@ class CREVENT_EXPORT TaskQueueSelector : public WorkQueueSets::Observer {
   // waiting non-delayed task.
   static const size_t kMaxDelayedStarvationTasks = 3;
 
+  // Maximum number of tasks which can be run ahead of the oldest task of their
+  // priority, when selecting by deadline.
+  static const size_t kMaxDeadlineStarvationTasks = 8;
+
   // Tracks which priorities are currently active, meaning there are pending
   // runnable tasks with that priority. Because there are only a handful of
   // priorities, and because we always run tasks in order from highest to lowest
@@ -203,6 +207,17 @@ class CREVENT_EXPORT TaskQueueSelector : public WorkQueueSets::Observer {
   bool CheckContainsQueueForTest(const internal::TaskQueueImpl* queue) const;
 #endif
 
+  // Returns the queue whose front task has the earliest deadline, immediate or
+  // delayed. Only with SequenceManager::Settings::earliest_deadline_first.
+  WorkQueue* ChooseEarliestDeadlineWithPriority(
+      TaskQueue::QueuePriority priority) const;
+
+  // Returns |earliest_deadline_queue|, unless kMaxDeadlineStarvationTasks
+  // tasks were selected by deadline ahead of the oldest one in a row, in
+  // which case returns |oldest_queue|.
+  WorkQueue* ApplyDeadlineStarvationLimit(WorkQueue* earliest_deadline_queue,
+                                          WorkQueue* oldest_queue);
+
   template <typename SetOperation>
   WorkQueue* ChooseImmediateOrDelayedTaskWithPriority(
       TaskQueue::QueuePriority priority) const {
@@ -238,6 +253,8 @@ class CREVENT_EXPORT TaskQueueSelector : public WorkQueueSets::Observer {
   const bool random_task_selection_ = false;
 #endif
 
+  const bool earliest_deadline_first_;
+
   // Count of the number of sets (delayed or immediate) for each priority.
   // Should only contain 0, 1 or 2.
   std::array<int, TaskQueue::kQueuePriorityCount> non_empty_set_counts_ = {{0}};
@@ -252,6 +269,10 @@ class CREVENT_EXPORT TaskQueueSelector : public WorkQueueSets::Observer {
   WorkQueueSets immediate_work_queue_sets_;
   size_t immediate_starvation_count_ = 0;
 
+  // Number of tasks selected by deadline in a row while an older task of the
+  // same priority was waiting.
+  size_t deadline_starvation_count_ = 0;
+
   Observer* task_queue_selector_observer_ = nullptr;  // Not owned.
 };
 
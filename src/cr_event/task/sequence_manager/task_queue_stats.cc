@@ -0,0 +1,149 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cr_event/task/sequence_manager/task_queue_stats.h"
+
+#include <inttypes.h>
+
+#include <algorithm>
+
+#include "cr_base/logging/logging.h"
+#include "cr_base/numerics/bits.h"
+#include "cr_base/strings/stringprintf.h"
+
+namespace cr {
+namespace sequence_manager {
+
+constexpr size_t TaskQueueStats::Histogram::kNumBuckets;
+
+namespace {
+
+using Histogram = TaskQueueStats::Histogram;
+
+std::string PercentileToString(const Histogram& histogram, double fraction) {
+  const TimeDelta percentile = histogram.GetPercentile(fraction);
+  if (percentile.is_max())
+    return "max";
+  return StringPrintf("%" PRId64 "us", percentile.InMicroseconds());
+}
+
+}  // namespace
+
+// static
+size_t TaskQueueStats::Histogram::GetBucket(TimeDelta duration) {
+  if (duration < TimeDelta::FromMicroseconds(1))
+    return 0;
+  const uint64_t us = static_cast<uint64_t>(duration.InMicroseconds());
+  return std::min<size_t>(64 - bits::CountLeadingZeroBits(us),
+                          kNumBuckets - 1);
+}
+
+// static
+TimeDelta TaskQueueStats::Histogram::GetBucketMin(size_t bucket) {
+  CR_DCHECK(bucket < kNumBuckets);
+  if (bucket == 0)
+    return TimeDelta();
+  return TimeDelta::FromMicroseconds(int64_t(1) << (bucket - 1));
+}
+
+// static
+TimeDelta TaskQueueStats::Histogram::GetBucketMax(size_t bucket) {
+  CR_DCHECK(bucket < kNumBuckets);
+  if (bucket == kNumBuckets - 1)
+    return TimeDelta::Max();
+  return TimeDelta::FromMicroseconds(int64_t(1) << bucket);
+}
+
+uint64_t TaskQueueStats::Histogram::GetTotalCount() const {
+  uint64_t total_count = 0;
+  for (uint64_t count : counts)
+    total_count += count;
+  return total_count;
+}
+
+TimeDelta TaskQueueStats::Histogram::GetPercentile(double fraction) const {
+  const uint64_t total_count = GetTotalCount();
+  if (!total_count)
+    return TimeDelta();
+
+  // The rank of the percentile, counting from 1.
+  const uint64_t rank = std::max<uint64_t>(
+      1, static_cast<uint64_t>(fraction * static_cast<double>(total_count) +
+                               0.5));
+  uint64_t cumulative_count = 0;
+  for (size_t bucket = 0; bucket < kNumBuckets; ++bucket) {
+    cumulative_count += counts[bucket];
+    if (cumulative_count >= rank)
+      return GetBucketMax(bucket);
+  }
+  return GetBucketMax(kNumBuckets - 1);
+}
+
+Histogram TaskQueueStats::Histogram::Since(const Histogram& previous) const {
+  Histogram histogram;
+  for (size_t bucket = 0; bucket < kNumBuckets; ++bucket)
+    histogram.counts[bucket] = counts[bucket] - previous.counts[bucket];
+  return histogram;
+}
+
+double TaskQueueStats::TasksPerSecondSince(
+    const TaskQueueStats& previous) const {
+  const double seconds = (sample_time - previous.sample_time).InSecondsF();
+  if (seconds <= 0.0)
+    return 0.0;
+  return static_cast<double>(tasks_run - previous.tasks_run) / seconds;
+}
+
+std::string TaskQueueStats::ToString() const {
+  return StringPrintf(
+      "%s: %" PRIu64 " tasks, queueing delay p50 %s p99 %s, "
+      "run duration p50 %s p99 %s, max backlog %zu",
+      name, tasks_run, PercentileToString(queueing_delay, 0.5).c_str(),
+      PercentileToString(queueing_delay, 0.99).c_str(),
+      PercentileToString(run_duration, 0.5).c_str(),
+      PercentileToString(run_duration, 0.99).c_str(), max_backlog);
+}
+
+namespace internal {
+
+TaskQueueStatsRecorder::TaskQueueStatsRecorder(const char* name)
+    : name_(name) {}
+
+TaskQueueStatsRecorder::~TaskQueueStatsRecorder() = default;
+
+void TaskQueueStatsRecorder::RecordTaskStarted(size_t backlog) {
+  Increment(tasks_run_);
+  if (backlog > max_backlog_.load(std::memory_order_relaxed))
+    max_backlog_.store(backlog, std::memory_order_relaxed);
+}
+
+void TaskQueueStatsRecorder::RecordQueueingDelay(TimeDelta queueing_delay) {
+  Increment(queueing_delay_[Histogram::GetBucket(queueing_delay)]);
+}
+
+void TaskQueueStatsRecorder::RecordTaskCompleted(TimeDelta run_duration) {
+  Increment(run_duration_[Histogram::GetBucket(run_duration)]);
+}
+
+TaskQueueStats TaskQueueStatsRecorder::GetSnapshot() const {
+  TaskQueueStats stats;
+  stats.name = name_;
+  stats.sample_time = TimeTicks::Now();
+  stats.tasks_run = tasks_run_.load(std::memory_order_relaxed);
+  CopyHistogram(queueing_delay_, &stats.queueing_delay);
+  CopyHistogram(run_duration_, &stats.run_duration);
+  stats.max_backlog = max_backlog_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+// static
+void TaskQueueStatsRecorder::CopyHistogram(const AtomicHistogram& from,
+                                           TaskQueueStats::Histogram* to) {
+  for (size_t bucket = 0; bucket < Histogram::kNumBuckets; ++bucket)
+    to->counts[bucket] = from[bucket].load(std::memory_order_relaxed);
+}
+
+}  // namespace internal
+}  // namespace sequence_manager
+}  // namespace cr
@@ -0,0 +1,133 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MINI_CHROMIUM_SRC_CREVENT_TASK_SEQUENCE_MANAGER_TASK_QUEUE_STATS_H_
+#define MINI_CHROMIUM_SRC_CREVENT_TASK_SEQUENCE_MANAGER_TASK_QUEUE_STATS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <string>
+
+#include "cr_base/memory/ref_counted.h"
+#include "cr_base/time/time.h"
+
+#include "cr_event/event_export.h"
+
+namespace cr {
+namespace sequence_manager {
+
+// A snapshot of the tasks a TaskQueue has run since it was created, see
+// TaskQueue::Spec::SetShouldRecordStats(). Counters only grow, so rates and
+// distributions over an interval are computed from two snapshots, e.g.:
+//
+//   TaskQueueStats previous = queue->GetStats();
+//   ...
+//   TaskQueueStats current = queue->GetStats();
+//   TimeDelta p99 =
+//       current.queueing_delay.Since(previous.queueing_delay).GetPercentile(
+//           0.99);
+struct CREVENT_EXPORT TaskQueueStats {
+  // Counts of durations in log-scale buckets of microseconds: bucket 0 holds
+  // durations under 1us, bucket i those in [2^(i-1), 2^i) us, and the last
+  // bucket all those from 2^(kNumBuckets-2) us, i.e. about 18 minutes.
+  struct CREVENT_EXPORT Histogram {
+    static constexpr size_t kNumBuckets = 32;
+
+    static size_t GetBucket(TimeDelta duration);
+
+    // Bounds of the durations of |bucket|. The last bucket has no upper
+    // bound: TimeDelta::Max().
+    static TimeDelta GetBucketMin(size_t bucket);
+    static TimeDelta GetBucketMax(size_t bucket);
+
+    uint64_t GetTotalCount() const;
+
+    // Returns an upper bound of the |fraction| percentile, between 0 and 1:
+    // the upper bound of the bucket it falls in. Zero if empty.
+    TimeDelta GetPercentile(double fraction) const;
+
+    // Returns the counts added since |previous|, an earlier snapshot.
+    Histogram Since(const Histogram& previous) const;
+
+    uint64_t counts[kNumBuckets] = {};
+  };
+
+  // Averages over the interval between `previous` and this snapshot. 0 if
+  // the interval is empty.
+  double TasksPerSecondSince(const TaskQueueStats& previous) const;
+
+  // Returns a one-line summary, for logs.
+  std::string ToString() const;
+
+  // Name of the TaskQueue.
+  const char* name = "";
+
+  // When the snapshot was taken.
+  TimeTicks sample_time;
+
+  // Number of tasks started.
+  uint64_t tasks_run = 0;
+
+  // Time between the moment a task could have run, i.e. when it was posted or
+  // when its delay expired, and the moment it started.
+  Histogram queueing_delay;
+
+  // Wall time spent running tasks, including the nested RunLoops they run.
+  Histogram run_duration;
+
+  // Highest number of tasks ready to run in the queue seen when a task
+  // started, the task included. Delayed tasks count once due.
+  size_t max_backlog = 0;
+};
+
+namespace internal {
+
+// Collects TaskQueueStats for a TaskQueue. The Record*() methods must all be
+// called on the queue's main thread; they only use relaxed loads and stores,
+// so that keeping the stats up to date costs next to nothing. GetSnapshot()
+// can be called on any thread, and may see a task half recorded.
+class CREVENT_EXPORT TaskQueueStatsRecorder
+    : public RefCountedThreadSafe<TaskQueueStatsRecorder> {
+ public:
+  explicit TaskQueueStatsRecorder(const char* name);
+  TaskQueueStatsRecorder(const TaskQueueStatsRecorder&) = delete;
+  TaskQueueStatsRecorder& operator=(const TaskQueueStatsRecorder&) = delete;
+
+  void RecordTaskStarted(size_t backlog);
+  void RecordQueueingDelay(TimeDelta queueing_delay);
+  void RecordTaskCompleted(TimeDelta run_duration);
+
+  TaskQueueStats GetSnapshot() const;
+
+ private:
+  friend class RefCountedThreadSafe<TaskQueueStatsRecorder>;
+
+  using AtomicHistogram =
+      std::atomic<uint64_t>[TaskQueueStats::Histogram::kNumBuckets];
+
+  ~TaskQueueStatsRecorder();
+
+  // Single writer: a read-modify-write isn't needed to stay consistent.
+  static void Increment(std::atomic<uint64_t>& counter) {
+    counter.store(counter.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_relaxed);
+  }
+
+  static void CopyHistogram(const AtomicHistogram& from,
+                            TaskQueueStats::Histogram* to);
+
+  const char* const name_;
+  std::atomic<uint64_t> tasks_run_{0};
+  AtomicHistogram queueing_delay_ = {};
+  AtomicHistogram run_duration_ = {};
+  std::atomic<size_t> max_backlog_{0};
+};
+
+}  // namespace internal
+}  // namespace sequence_manager
+}  // namespace cr
+
+#endif  // MINI_CHROMIUM_SRC_CREVENT_TASK_SEQUENCE_MANAGER_TASK_QUEUE_STATS_H_
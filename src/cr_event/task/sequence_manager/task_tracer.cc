@@ -0,0 +1,180 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cr_event/task/sequence_manager/task_tracer.h"
+
+#include <inttypes.h>
+
+#include "cr_base/json/internal/string_escape.h"
+#include "cr_base/logging/logging.h"
+#include "cr_base/memory/singleton.h"
+#include "cr_base/strings/stringprintf.h"
+
+#include "cr_event/task/sequence_manager/tasks.h"
+#include "cr_event/threading/thread_id_name_manager.h"
+
+namespace cr {
+namespace sequence_manager {
+
+constexpr size_t TaskTracer::kDefaultRecordsPerThread;
+
+namespace {
+
+int64_t ToMicroseconds(TimeTicks time_ticks) {
+  return time_ticks.since_origin().InMicroseconds();
+}
+
+void AppendJSONString(const char* str, std::string* output) {
+  cr::internal::EscapeJSONString(str ? str : "", true, output);
+}
+
+}  // namespace
+
+TaskTracer::ThreadBuffer::ThreadBuffer(uint32_t session, size_t capacity)
+    : session_(session),
+      thread_id_(PlatformThread::CurrentId()),
+      thread_name_(
+          ThreadIdNameManager::GetInstance()->GetNameForCurrentThread()),
+      capacity_(capacity),
+      records_(new Record[capacity]) {
+  CR_DCHECK(capacity_ > 0);
+}
+
+TaskTracer::ThreadBuffer::~ThreadBuffer() = default;
+
+void TaskTracer::ThreadBuffer::RecordTask(const Task& task,
+                                          const char* queue_name,
+                                          TimeTicks start_time,
+                                          TimeTicks end_time) {
+  // Single writer: no read-modify-write needed.
+  const uint64_t num_records = num_records_.load(std::memory_order_relaxed);
+  Record& record = records_[num_records % capacity_];
+
+  record.sequence.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  record.function_name.store(task.posted_from.function_name(),
+                             std::memory_order_relaxed);
+  record.file_name.store(task.posted_from.file_name(),
+                         std::memory_order_relaxed);
+  record.line_number.store(task.posted_from.line_number(),
+                           std::memory_order_relaxed);
+  record.queue_name.store(queue_name, std::memory_order_relaxed);
+  record.queue_time_us.store(
+      task.queue_time.is_null() ? 0 : ToMicroseconds(task.queue_time),
+      std::memory_order_relaxed);
+  record.start_time_us.store(ToMicroseconds(start_time),
+                             std::memory_order_relaxed);
+  record.end_time_us.store(ToMicroseconds(end_time),
+                           std::memory_order_relaxed);
+  record.sequence.store(num_records + 1, std::memory_order_release);
+
+  num_records_.store(num_records + 1, std::memory_order_release);
+}
+
+void TaskTracer::ThreadBuffer::AppendTraceEvents(ProcessId pid,
+                                                 std::string* output) const {
+  const int trace_pid = static_cast<int>(pid);
+  const int trace_tid = static_cast<int>(thread_id_);
+
+  StringAppendF(output,
+                ",{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,"
+                "\"tid\":%d,\"args\":{\"name\":",
+                trace_pid, trace_tid);
+  AppendJSONString(thread_name_.c_str(), output);
+  output->append("}}");
+
+  const uint64_t end = num_records_.load(std::memory_order_acquire);
+  const uint64_t begin = end > capacity_ ? end - capacity_ : 0;
+  for (uint64_t i = begin; i < end; ++i) {
+    const Record& record = records_[i % capacity_];
+
+    const uint64_t sequence = record.sequence.load(std::memory_order_acquire);
+    if (sequence != i + 1)
+      continue;  // Overwritten since |end| was read.
+    const char* function_name =
+        record.function_name.load(std::memory_order_relaxed);
+    const char* file_name = record.file_name.load(std::memory_order_relaxed);
+    const int line_number = record.line_number.load(std::memory_order_relaxed);
+    const char* queue_name = record.queue_name.load(std::memory_order_relaxed);
+    const int64_t queue_time_us =
+        record.queue_time_us.load(std::memory_order_relaxed);
+    const int64_t start_time_us =
+        record.start_time_us.load(std::memory_order_relaxed);
+    const int64_t end_time_us =
+        record.end_time_us.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (record.sequence.load(std::memory_order_relaxed) != sequence)
+      continue;  // Overwritten while read.
+
+    output->append(",{\"name\":");
+    AppendJSONString(function_name, output);
+    StringAppendF(output,
+                  ",\"cat\":\"sequence_manager\",\"ph\":\"X\",\"ts\":%" PRId64
+                  ",\"dur\":%" PRId64 ",\"pid\":%d,\"tid\":%d,"
+                  "\"args\":{\"queue\":",
+                  start_time_us, end_time_us - start_time_us, trace_pid,
+                  trace_tid);
+    AppendJSONString(queue_name, output);
+    output->append(",\"posted_from\":");
+    AppendJSONString(
+        StringPrintf("%s:%d", file_name ? file_name : "", line_number).c_str(),
+        output);
+    if (queue_time_us)
+      StringAppendF(output, ",\"queue_time\":%" PRId64, queue_time_us);
+    output->append("}}");
+  }
+}
+
+// static
+TaskTracer* TaskTracer::GetInstance() {
+  return Singleton<TaskTracer, LeakySingletonTraits<TaskTracer>>::get();
+}
+
+TaskTracer::TaskTracer() = default;
+TaskTracer::~TaskTracer() = default;
+
+void TaskTracer::Start(size_t records_per_thread) {
+  CR_DCHECK(records_per_thread > 0);
+  AutoLock lock(lock_);
+  records_per_thread_ = records_per_thread;
+  thread_buffers_.clear();
+  // Threads notice the new session when they next run a task, and drop their
+  // buffer of the previous one.
+  session_.store(session_.load(std::memory_order_relaxed) + 1,
+                 std::memory_order_relaxed);
+  enabled_.store(true, std::memory_order_relaxed);
+}
+
+void TaskTracer::Stop() {
+  enabled_.store(false, std::memory_order_relaxed);
+}
+
+void TaskTracer::WriteJSON(std::string* output) const {
+  std::vector<RefPtr<ThreadBuffer>> thread_buffers;
+  {
+    AutoLock lock(lock_);
+    thread_buffers = thread_buffers_;
+  }
+
+  output->append("{\"traceEvents\":[");
+  const size_t events_begin = output->size();
+  const ProcessId pid = GetCurrentProcId();
+  for (const auto& thread_buffer : thread_buffers)
+    thread_buffer->AppendTraceEvents(pid, output);
+  // Each event comes after a comma, which the first one doesn't need.
+  if (output->size() > events_begin)
+    output->erase(events_begin, 1);
+  output->append("],\"displayTimeUnit\":\"ms\"}");
+}
+
+RefPtr<TaskTracer::ThreadBuffer> TaskTracer::CreateThreadBuffer() {
+  AutoLock lock(lock_);
+  auto thread_buffer = MakeRefCounted<ThreadBuffer>(
+      session_.load(std::memory_order_relaxed), records_per_thread_);
+  thread_buffers_.push_back(thread_buffer);
+  return thread_buffer;
+}
+
+}  // namespace sequence_manager
+}  // namespace cr
@@ -0,0 +1,151 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MINI_CHROMIUM_SRC_CREVENT_TASK_SEQUENCE_MANAGER_TASK_TRACER_H_
+#define MINI_CHROMIUM_SRC_CREVENT_TASK_SEQUENCE_MANAGER_TASK_TRACER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cr_base/memory/ref_counted.h"
+#include "cr_base/process/process_handle.h"
+#include "cr_base/synchronization/lock.h"
+#include "cr_base/threading/platform_thread.h"
+#include "cr_base/time/time.h"
+
+#include "cr_event/event_export.h"
+
+namespace cr {
+
+template <typename T>
+struct DefaultSingletonTraits;
+
+namespace sequence_manager {
+
+struct Task;
+
+// Records the tasks run by the SequenceManagers of the process, and writes
+// them out as Chrome trace event JSON, which chrome://tracing and Perfetto
+// open:
+//
+//   TaskTracer::GetInstance()->Start();
+//   ...
+//   TaskTracer::GetInstance()->Stop();
+//   std::string json;
+//   TaskTracer::GetInstance()->WriteJSON(&json);
+//
+// Each task gets a complete event named after the function which posted it,
+// with the name of its queue, where it was posted from and when, as args.
+//
+// Each thread records into a ring buffer of its own which keeps its latest
+// tasks, without taking a lock: running a task costs a few relaxed stores on
+// top of the two clock reads needed for its start and end times, and posting
+// one costs a clock read for its queue time, also without a lock unless
+// something else needs the queue time of the tasks too. The buffers can be
+// written out at any time, even while tracing.
+class CREVENT_EXPORT TaskTracer {
+ public:
+  // Each record takes 64 bytes.
+  static constexpr size_t kDefaultRecordsPerThread = 1 << 16;
+
+  // The records of a thread. Only that thread writes to it, see RecordTask().
+  class CREVENT_EXPORT ThreadBuffer
+      : public RefCountedThreadSafe<ThreadBuffer> {
+   public:
+    ThreadBuffer(uint32_t session, size_t capacity);
+    ThreadBuffer(const ThreadBuffer&) = delete;
+    ThreadBuffer& operator=(const ThreadBuffer&) = delete;
+
+    uint32_t session() const { return session_; }
+
+    // Records |task|, of the queue named |queue_name|, which ran from
+    // |start_time| to |end_time|. Overwrites the oldest record when full.
+    void RecordTask(const Task& task,
+                    const char* queue_name,
+                    TimeTicks start_time,
+                    TimeTicks end_time);
+
+    // Appends the trace events of the records to |output|, each preceded by
+    // a comma.
+    void AppendTraceEvents(ProcessId pid, std::string* output) const;
+
+   private:
+    friend class RefCountedThreadSafe<ThreadBuffer>;
+
+    // A seqlock: |sequence| is 0 while the record is written, then the number
+    // of records written by then. All fields are atomics so that reading a
+    // record while it is overwritten is merely detected, not a data race.
+    struct Record {
+      std::atomic<uint64_t> sequence{0};
+      std::atomic<const char*> function_name{nullptr};
+      std::atomic<const char*> file_name{nullptr};
+      std::atomic<const char*> queue_name{nullptr};
+      std::atomic<int64_t> queue_time_us{0};
+      std::atomic<int64_t> start_time_us{0};
+      std::atomic<int64_t> end_time_us{0};
+      std::atomic<int> line_number{0};
+    };
+
+    ~ThreadBuffer();
+
+    const uint32_t session_;
+    const PlatformThreadId thread_id_;
+    const std::string thread_name_;
+    const size_t capacity_;
+    const std::unique_ptr<Record[]> records_;
+
+    // Number of records written since the buffer was created.
+    std::atomic<uint64_t> num_records_{0};
+  };
+
+  static TaskTracer* GetInstance();
+
+  TaskTracer(const TaskTracer&) = delete;
+  TaskTracer& operator=(const TaskTracer&) = delete;
+
+  // Starts a new tracing session, dropping the records of the previous one.
+  // Each thread keeps its |records_per_thread| latest records.
+  void Start(size_t records_per_thread = kDefaultRecordsPerThread);
+
+  // Stops recording. The records are kept until the next Start().
+  void Stop();
+
+  // Can be called on any thread.
+  bool IsEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  // Appends the records of the current or last session to |output|, as a
+  // JSON object in the trace event format. Can be called on any thread.
+  void WriteJSON(std::string* output) const;
+
+  // Returns a buffer for the current thread to record into during the
+  // current session, which it should keep until IsCurrent() turns false.
+  RefPtr<ThreadBuffer> CreateThreadBuffer();
+
+  bool IsCurrent(const ThreadBuffer& buffer) const {
+    return buffer.session() == session_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  friend struct DefaultSingletonTraits<TaskTracer>;
+
+  TaskTracer();
+  ~TaskTracer();
+
+  std::atomic<bool> enabled_{false};
+  std::atomic<uint32_t> session_{0};
+
+  mutable Lock lock_;
+  size_t records_per_thread_ = kDefaultRecordsPerThread;
+  std::vector<RefPtr<ThreadBuffer>> thread_buffers_;
+};
+
+}  // namespace sequence_manager
+}  // namespace cr
+
+#endif  // MINI_CHROMIUM_SRC_CREVENT_TASK_SEQUENCE_MANAGER_TASK_TRACER_H_
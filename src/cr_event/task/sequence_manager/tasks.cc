@@ -28,6 +28,11 @@ Task::Task(internal::PostedTask posted_task,
   sequence_num = static_cast<intptr_t>(sequence_order);
   this->is_high_res = resolution == internal::WakeUpResolution::kHigh;
   queue_time = posted_task.queue_time;
+  if (!posted_task.deadline.is_zero()) {
+    CR_DCHECK(!delayed_run_time.is_null() || !queue_time.is_null());
+    deadline = (delayed_run_time.is_null() ? queue_time : delayed_run_time) +
+               posted_task.deadline;
+  }
 }
 
 Task::Task(Task&& move_from) = default;
@@ -42,12 +47,16 @@ PostedTask::PostedTask(RefPtr<SequencedTaskRunner> task_runner,
                        Location location,
                        TimeDelta delay,
                        Nestable nestable,
-                       TaskType task_type)
+                       TaskType task_type,
+                       TimeDelta leeway,
+                       DelayPolicy delay_policy)
     : callback(std::move(callback)),
       location(location),
       delay(delay),
       nestable(nestable),
       task_type(task_type),
+      leeway(leeway),
+      delay_policy(delay_policy),
       task_runner(std::move(task_runner)) {}
 
 PostedTask::PostedTask(PostedTask&& move_from) noexcept
@@ -56,8 +65,11 @@ PostedTask::PostedTask(PostedTask&& move_from) noexcept
       delay(move_from.delay),
       nestable(move_from.nestable),
       task_type(move_from.task_type),
+      leeway(move_from.leeway),
+      delay_policy(move_from.delay_policy),
       task_runner(std::move(move_from.task_runner)),
-      queue_time(move_from.queue_time) {}
+      queue_time(move_from.queue_time),
+      deadline(move_from.deadline) {}
 
 PostedTask::~PostedTask() = default;
 
@@ -6,6 +6,7 @@
 #ifndef MINI_CHROMIUM_SRC_CREVENT_TASK_SEQUENCE_MANAGER_TASKS_H_
 #define MINI_CHROMIUM_SRC_CREVENT_TASK_SEQUENCE_MANAGER_TASKS_H_
 
+#include "cr_event/task/delay_policy.h"
 #include "cr_event/task/pending_task.h"
 #include "cr_event/task/sequenced_task_runner.h"
 #include "cr_event/task/sequence_manager/enqueue_order.h"
@@ -23,12 +24,15 @@ enum class WakeUpResolution { kLow, kHigh };
 // Wrapper around PostTask method arguments and the assigned task type.
 // Eventually it becomes a PendingTask once accepted by a TaskQueueImpl.
 struct CREVENT_EXPORT PostedTask {
-  explicit PostedTask(RefPtr<SequencedTaskRunner> task_runner,
-                      OnceClosure callback = OnceClosure(),
-                      Location location = Location(),
-                      TimeDelta delay = TimeDelta(),
-                      Nestable nestable = Nestable::kNestable,
-                      TaskType task_type = kTaskTypeNone);
+  explicit PostedTask(
+      RefPtr<SequencedTaskRunner> task_runner,
+      OnceClosure callback = OnceClosure(),
+      Location location = Location(),
+      TimeDelta delay = TimeDelta(),
+      Nestable nestable = Nestable::kNestable,
+      TaskType task_type = kTaskTypeNone,
+      TimeDelta leeway = TimeDelta(),
+      DelayPolicy delay_policy = DelayPolicy::kFlexibleNoSooner);
   PostedTask(PostedTask&& move_from) noexcept;
   PostedTask(const PostedTask&) = delete;
   PostedTask& operator=(const PostedTask&) = delete;
@@ -39,11 +43,17 @@ struct CREVENT_EXPORT PostedTask {
   TimeDelta delay;
   Nestable nestable;
   TaskType task_type;
+  // How far from |delay| a delayed task may run, see DelayPolicy.
+  TimeDelta leeway;
+  DelayPolicy delay_policy;
   // The task runner this task is running on. Can be used by task runners that
   // support posting back to the "current sequence".
   RefPtr<SequencedTaskRunner> task_runner;
   // The time at which the task was queued.
   TimeTicks queue_time;
+  // How long after it could run the task must start at the latest, zero if
+  // it has no deadline. See SequenceManager::Settings::earliest_deadline_first.
+  TimeDelta deadline;
 };
 
 // Represents a time at which a task wants to run. Tasks scheduled for the
@@ -116,6 +126,11 @@ struct CREVENT_EXPORT Task : public PendingTask {
   // support posting back to the "current sequence".
   RefPtr<SequencedTaskRunner> task_runner;
 
+  // When the task must start at the latest: its PostedTask::deadline after it
+  // was posted, or after its delay expired for a delayed task. Null if it has
+  // no deadline.
+  TimeTicks deadline;
+
 #if CR_DCHECK_IS_ON()
   bool cross_thread_;
 #endif
@@ -93,6 +93,12 @@ class CREVENT_EXPORT ThreadController {
   // Returns the MessagePump we're bound to if any.
   virtual MessagePump* GetBoundMessagePump() const = 0;
 
+  // See SequenceManager.
+  virtual bool GetMessagePumpMetrics(MessagePumpMetrics* metrics) const = 0;
+  virtual void SetMessagePumpMetricsCallback(
+      TimeDelta interval,
+      MessagePumpMetricsCallback callback) = 0;
+
   // Returns true if the current run loop should quit when idle.
   virtual bool ShouldQuitRunLoopWhenIdle() = 0;
 
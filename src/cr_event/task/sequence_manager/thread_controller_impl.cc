@@ -334,6 +334,18 @@ MessagePump* ThreadControllerImpl::GetBoundMessagePump() const {
   return nullptr;
 }
 
+bool ThreadControllerImpl::GetMessagePumpMetrics(
+    MessagePumpMetrics* metrics) const {
+  // The MessageLoop's pump isn't exposed.
+  return false;
+}
+
+void ThreadControllerImpl::SetMessagePumpMetricsCallback(
+    TimeDelta interval,
+    MessagePumpMetricsCallback callback) {
+  // Nothing to sample, see GetMessagePumpMetrics().
+}
+
 }  // namespace internal
 }  // namespace sequence_manager
 }  // namespace cr
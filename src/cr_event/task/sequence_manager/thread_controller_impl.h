@@ -63,6 +63,10 @@ class CREVENT_EXPORT ThreadControllerImpl : public ThreadController,
   void SetTaskExecutionAllowed(bool allowed) override;
   bool IsTaskExecutionAllowed() const override;
   MessagePump* GetBoundMessagePump() const override;
+  bool GetMessagePumpMetrics(MessagePumpMetrics* metrics) const override;
+  void SetMessagePumpMetricsCallback(
+      TimeDelta interval,
+      MessagePumpMetricsCallback callback) override;
   bool ShouldQuitRunLoopWhenIdle() override;
 
   // RunLoop::NestingObserver:
@@ -77,6 +77,7 @@ void ThreadControllerWithMessagePumpImpl::BindToCurrentThread(
     std::unique_ptr<MessagePump> message_pump) {
   associated_thread_->BindToCurrentThread();
   pump_ = std::move(message_pump);
+  metrics_pump_.store(pump_.get(), std::memory_order_release);
   work_id_provider_ = WorkIdProvider::GetForCurrentThread();
   RunLoop::RegisterDelegateForCurrentThread(this);
   scoped_set_sequence_local_storage_map_for_current_thread_ = std::make_unique<
@@ -256,6 +257,8 @@ ThreadControllerWithMessagePumpImpl::DoWork() {
   work_deduplicator_.OnWorkStarted();
   LazyNow continuation_lazy_now(time_source_);
   TimeDelta delay_till_next_task = DoWorkImpl(&continuation_lazy_now);
+  if (!main_thread_only().metrics_callback.is_null())
+    MaybeSampleMessagePumpMetrics(continuation_lazy_now.Now());
   // Schedule a continuation.
   WorkDeduplicator::NextTask next_task =
       delay_till_next_task.is_zero() ? WorkDeduplicator::NextTask::kIsImmediate
@@ -480,6 +483,41 @@ void ThreadControllerWithMessagePumpImpl::OnExitNestedRunLoop() {
     main_thread_only().nesting_observer->OnExitNestedRunLoop();
 }
 
+bool ThreadControllerWithMessagePumpImpl::GetMessagePumpMetrics(
+    MessagePumpMetrics* metrics) const {
+  // |pump_| may be bound concurrently on the controller's thread.
+  MessagePump* pump = metrics_pump_.load(std::memory_order_acquire);
+  return pump && pump->GetMetrics(metrics);
+}
+
+void ThreadControllerWithMessagePumpImpl::SetMessagePumpMetricsCallback(
+    TimeDelta interval,
+    MessagePumpMetricsCallback callback) {
+  CR_DCHECK(RunsTasksInCurrentSequence());
+  CR_DCHECK(callback.is_null() || interval > TimeDelta());
+  main_thread_only().metrics_callback = std::move(callback);
+  main_thread_only().metrics_interval = interval;
+  main_thread_only().next_metrics_sample =
+      main_thread_only().metrics_callback.is_null()
+          ? TimeTicks::Max()
+          : time_source_->NowTicks() + interval;
+}
+
+void ThreadControllerWithMessagePumpImpl::MaybeSampleMessagePumpMetrics(
+    TimeTicks now) {
+  if (now < main_thread_only().next_metrics_sample)
+    return;
+  // Skip the intervals the thread slept through rather than catching up.
+  main_thread_only().next_metrics_sample =
+      now + main_thread_only().metrics_interval;
+  MessagePumpMetrics metrics;
+  if (!GetMessagePumpMetrics(&metrics))
+    return;
+  // The callback may replace itself.
+  MessagePumpMetricsCallback callback = main_thread_only().metrics_callback;
+  callback.Run(metrics);
+}
+
 void ThreadControllerWithMessagePumpImpl::Quit() {
   CR_DCHECK(RunsTasksInCurrentSequence());
   // Interrupt a batch of work.
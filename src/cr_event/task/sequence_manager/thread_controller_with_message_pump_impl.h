@@ -6,11 +6,13 @@
 #ifndef MINI_CHROMIUM_SRC_CREVENT_TASK_SEQUENCE_MANAGER_THREAD_CONTROLLER_WITH_MESSAGE_PUMP_IMPL_H_
 #define MINI_CHROMIUM_SRC_CREVENT_TASK_SEQUENCE_MANAGER_THREAD_CONTROLLER_WITH_MESSAGE_PUMP_IMPL_H_
 
+#include <atomic>
 #include <memory>
 
 #include "cr_base/compiler_config.h"
 
 #include "cr_base/containers/optional.h"
+#include "cr_base/functional/callback.h"
 #include "cr_base/threading/platform_thread.h"
 
 #include "cr_event/message_pump/message_pump.h"
@@ -73,6 +75,10 @@ class CREVENT_EXPORT ThreadControllerWithMessagePumpImpl
   bool IsTaskExecutionAllowed() const override;
   MessagePump* GetBoundMessagePump() const override;
   bool ShouldQuitRunLoopWhenIdle() override;
+  bool GetMessagePumpMetrics(MessagePumpMetrics* metrics) const override;
+  void SetMessagePumpMetricsCallback(
+      TimeDelta interval,
+      MessagePumpMetricsCallback callback) override;
 
   // RunLoop::NestingObserver:
   void OnBeginNestedRunLoop() override;
@@ -122,6 +128,11 @@ class CREVENT_EXPORT ThreadControllerWithMessagePumpImpl
     TimeTicks quit_runloop_after = TimeTicks::Max();
 
     bool task_execution_allowed = true;
+
+    // See SetMessagePumpMetricsCallback().
+    MessagePumpMetricsCallback metrics_callback;
+    TimeDelta metrics_interval;
+    TimeTicks next_metrics_sample = TimeTicks::Max();
   };
 
   const MainThreadOnly& MainThreadOnlyForTesting() const {
@@ -142,6 +153,9 @@ class CREVENT_EXPORT ThreadControllerWithMessagePumpImpl
 
   void InitializeThreadTaskRunnerHandle();
 
+  // Runs the metrics callback if it is due at |now|.
+  void MaybeSampleMessagePumpMetrics(TimeTicks now);
+
   MainThreadOnly& main_thread_only() {
     CR_DCHECK_CALLED_ON_VALID_THREAD(associated_thread_->thread_checker);
     return main_thread_only_;
@@ -173,6 +187,10 @@ class CREVENT_EXPORT ThreadControllerWithMessagePumpImpl
   // allowed.
   std::unique_ptr<MessagePump> pump_;
 
+  // |pump_|, published once set for GetMessagePumpMetrics(), which can be
+  // called on any thread.
+  std::atomic<MessagePump*> metrics_pump_{nullptr};
+
   const TickClock* time_source_;  // Not owned.
 
   // Non-null provider of id state for identifying distinct work items executed
@@ -29,6 +29,10 @@ namespace internal {
 //
 // Nesting is assumed to be dealt with by the ThreadController.
 //
+// The ScheduleWork() calls which get through are further filtered by the
+// MessagePump, which only wakes its thread up if it is actually parked (see
+// MessagePumpWakeState).
+//
 // Most methods are thread-affine except for On(Delayed)WorkRequested which are
 // is thread-safe.
 class CREVENT_EXPORT WorkDeduplicator {
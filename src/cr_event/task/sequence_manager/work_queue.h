@@ -122,6 +122,14 @@ class CREVENT_EXPORT WorkQueue {
     heap_handle_ = handle;
   }
 
+  cr::internal::HeapHandle deadline_heap_handle() const {
+    return deadline_heap_handle_;
+  }
+
+  void set_deadline_heap_handle(cr::internal::HeapHandle handle) {
+    deadline_heap_handle_ = handle;
+  }
+
   QueueType queue_type() const { return queue_type_; }
 
   // Returns true if the front task in this queue has an older enqueue order
@@ -174,6 +182,9 @@ class CREVENT_EXPORT WorkQueue {
   // |heap_handle_| will be valid and correspond to this queue's location within
   // an IntrusiveHeap inside the WorkQueueSet.
   cr::internal::HeapHandle heap_handle_;
+  // Likewise for the earliest deadline IntrusiveHeap, only used if
+  // SequenceManager::Settings::earliest_deadline_first is set.
+  cr::internal::HeapHandle deadline_heap_handle_;
   const char* const name_;
   EnqueueOrder fence_;
   const QueueType queue_type_;
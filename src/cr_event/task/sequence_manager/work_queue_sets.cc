@@ -15,6 +15,7 @@ WorkQueueSets::WorkQueueSets(const char* name,
                              Observer* observer,
                              const SequenceManager::Settings& settings)
     : name_(name),
+      earliest_deadline_first_(settings.earliest_deadline_first),
 #if CR_DCHECK_IS_ON()
       last_rand_(settings.random_task_selection_seed),
 #endif
@@ -35,6 +36,7 @@ void WorkQueueSets::AddQueue(WorkQueue* work_queue, size_t set_index) {
     return;
   bool was_empty = work_queue_heaps_[set_index].empty();
   work_queue_heaps_[set_index].insert({enqueue_order, work_queue});
+  InsertIntoDeadlineHeap(work_queue, set_index);
   if (was_empty)
     observer_->WorkQueueSetBecameNonEmpty(set_index);
 }
@@ -47,6 +49,7 @@ void WorkQueueSets::RemoveQueue(WorkQueue* work_queue) {
   size_t set_index = work_queue->work_queue_set_index();
   CR_DCHECK(set_index < work_queue_heaps_.size());
   work_queue_heaps_[set_index].erase(work_queue->heap_handle());
+  EraseFromDeadlineHeap(work_queue, set_index);
   if (work_queue_heaps_[set_index].empty())
     observer_->WorkQueueSetBecameEmpty(set_index);
   CR_DCHECK(!work_queue->heap_handle().IsValid());
@@ -65,8 +68,10 @@ void WorkQueueSets::ChangeSetIndex(WorkQueue* work_queue, size_t set_index) {
   if (!has_enqueue_order)
     return;
   work_queue_heaps_[old_set].erase(work_queue->heap_handle());
+  EraseFromDeadlineHeap(work_queue, old_set);
   bool was_empty = work_queue_heaps_[set_index].empty();
   work_queue_heaps_[set_index].insert({enqueue_order, work_queue});
+  InsertIntoDeadlineHeap(work_queue, set_index);
   if (work_queue_heaps_[old_set].empty())
     observer_->WorkQueueSetBecameEmpty(old_set);
   if (was_empty)
@@ -84,9 +89,11 @@ void WorkQueueSets::OnQueuesFrontTaskChanged(WorkQueue* work_queue) {
     // O(log n)
     work_queue_heaps_[set_index].ChangeKey(work_queue->heap_handle(),
                                            {enqueue_order, work_queue});
+    UpdateDeadlineHeap(work_queue, set_index);
   } else {
     // O(log n)
     work_queue_heaps_[set_index].erase(work_queue->heap_handle());
+    EraseFromDeadlineHeap(work_queue, set_index);
     CR_DCHECK(!work_queue->heap_handle().IsValid());
     if (work_queue_heaps_[set_index].empty())
       observer_->WorkQueueSetBecameEmpty(set_index);
@@ -107,11 +114,18 @@ void WorkQueueSets::OnTaskPushedToEmptyQueue(WorkQueue* work_queue) {
   CR_DCHECK(!work_queue->heap_handle().IsValid());
   bool was_empty = work_queue_heaps_[set_index].empty();
   work_queue_heaps_[set_index].insert({enqueue_order, work_queue});
+  InsertIntoDeadlineHeap(work_queue, set_index);
   if (was_empty)
     observer_->WorkQueueSetBecameNonEmpty(set_index);
 }
 
 void WorkQueueSets::OnPopMinQueueInSet(WorkQueue* work_queue) {
+  // The queue with the earliest deadline needn't have the oldest task.
+  if (earliest_deadline_first_) {
+    OnQueuesFrontTaskChanged(work_queue);
+    return;
+  }
+
   // Assume that |work_queue| contains the lowest enqueue_order.
   size_t set_index = work_queue->work_queue_set_index();
   CR_DCHECK(this == work_queue->work_queue_sets());
@@ -144,6 +158,7 @@ void WorkQueueSets::OnQueueBlocked(WorkQueue* work_queue) {
   size_t set_index = work_queue->work_queue_set_index();
   CR_DCHECK(set_index < work_queue_heaps_.size());
   work_queue_heaps_[set_index].erase(heap_handle);
+  EraseFromDeadlineHeap(work_queue, set_index);
   if (work_queue_heaps_[set_index].empty())
     observer_->WorkQueueSetBecameEmpty(set_index);
 }
@@ -205,6 +220,26 @@ WorkQueue* WorkQueueSets::GetRandomQueueAndEnqueueOrderInSet(
 }
 #endif
 
+WorkQueue* WorkQueueSets::GetEarliestDeadlineQueueInSet(
+    size_t set_index) const {
+  TaskDeadline deadline;
+  return GetEarliestDeadlineQueueAndDeadlineInSet(set_index, &deadline);
+}
+
+WorkQueue* WorkQueueSets::GetEarliestDeadlineQueueAndDeadlineInSet(
+    size_t set_index,
+    TaskDeadline* out_deadline) const {
+  CR_DCHECK(earliest_deadline_first_);
+  CR_DCHECK(set_index < deadline_heaps_.size());
+  if (deadline_heaps_[set_index].empty())
+    return nullptr;
+  const EarliestTaskDeadline& earliest = deadline_heaps_[set_index].Min();
+  CR_DCHECK(set_index == earliest.value->work_queue_set_index());
+  CR_DCHECK(earliest.value->deadline_heap_handle().IsValid());
+  *out_deadline = earliest.key;
+  return earliest.value;
+}
+
 bool WorkQueueSets::IsSetEmpty(size_t set_index) const {
   CR_DCHECK(set_index < work_queue_heaps_.size())
       << " set_index = " << set_index;
@@ -238,6 +273,43 @@ bool WorkQueueSets::ContainsWorkQueueForTest(
 }
 #endif
 
+// static
+WorkQueueSets::TaskDeadline WorkQueueSets::GetFrontTaskDeadline(
+    const WorkQueue* work_queue) {
+  const Task* task = work_queue->GetFrontTask();
+  CR_DCHECK(task);
+  return {task->deadline.is_null() ? TimeTicks::Max() : task->deadline,
+          task->enqueue_order()};
+}
+
+void WorkQueueSets::InsertIntoDeadlineHeap(WorkQueue* work_queue,
+                                           size_t set_index) {
+  if (!earliest_deadline_first_)
+    return;
+  CR_DCHECK(!work_queue->deadline_heap_handle().IsValid());
+  deadline_heaps_[set_index].insert(
+      {GetFrontTaskDeadline(work_queue), work_queue});
+}
+
+void WorkQueueSets::EraseFromDeadlineHeap(WorkQueue* work_queue,
+                                          size_t set_index) {
+  if (!earliest_deadline_first_)
+    return;
+  CR_DCHECK(work_queue->deadline_heap_handle().IsValid());
+  deadline_heaps_[set_index].erase(work_queue->deadline_heap_handle());
+  CR_DCHECK(!work_queue->deadline_heap_handle().IsValid());
+}
+
+void WorkQueueSets::UpdateDeadlineHeap(WorkQueue* work_queue,
+                                       size_t set_index) {
+  if (!earliest_deadline_first_)
+    return;
+  CR_DCHECK(work_queue->deadline_heap_handle().IsValid());
+  deadline_heaps_[set_index].ChangeKey(
+      work_queue->deadline_heap_handle(),
+      {GetFrontTaskDeadline(work_queue), work_queue});
+}
+
 void WorkQueueSets::CollectSkippedOverLowerPriorityTasks(
     const internal::WorkQueue* selected_work_queue,
     std::vector<const Task*>* result) const {
@@ -28,8 +28,24 @@ namespace internal {
 // TaskQueueSelector chooses to run a task a given priority).  The reason this
 // works is because std::map is a tree based associative container and all the
 // values are kept in sorted order.
+//
+// With SequenceManager::Settings::earliest_deadline_first, each WorkQueueSet
+// also keeps a heap of its queues ordered by the deadline of their front task.
 class CREVENT_EXPORT WorkQueueSets {
  public:
+  // Orders the tasks by deadline, then by enqueue order. Tasks without a
+  // deadline have TimeTicks::Max() as theirs, so come last.
+  struct TaskDeadline {
+    TimeTicks deadline;
+    EnqueueOrder enqueue_order;
+
+    bool operator<=(const TaskDeadline& other) const {
+      if (deadline == other.deadline)
+        return enqueue_order <= other.enqueue_order;
+      return deadline < other.deadline;
+    }
+  };
+
   class CREVENT_EXPORT Observer {
    public:
     virtual ~Observer() {}
@@ -87,6 +103,14 @@ class CREVENT_EXPORT WorkQueueSets {
       EnqueueOrder* out_enqueue_order) const;
 #endif
 
+  // O(1). Only with SequenceManager::Settings::earliest_deadline_first.
+  WorkQueue* GetEarliestDeadlineQueueInSet(size_t set_index) const;
+
+  // O(1). Only with SequenceManager::Settings::earliest_deadline_first.
+  WorkQueue* GetEarliestDeadlineQueueAndDeadlineInSet(
+      size_t set_index,
+      TaskDeadline* out_deadline) const;
+
   // O(1)
   bool IsSetEmpty(size_t set_index) const;
 
@@ -124,6 +148,35 @@ class CREVENT_EXPORT WorkQueueSets {
     HeapHandle GetHeapHandle() const { return value->heap_handle(); }
   };
 
+  struct EarliestTaskDeadline {
+    TaskDeadline key;
+    WorkQueue* value;
+
+    bool operator<=(const EarliestTaskDeadline& other) const {
+      return key <= other.key;
+    }
+
+    void SetHeapHandle(cr::internal::HeapHandle handle) {
+      value->set_deadline_heap_handle(handle);
+    }
+
+    void ClearHeapHandle() {
+      value->set_deadline_heap_handle(cr::internal::HeapHandle());
+    }
+
+    HeapHandle GetHeapHandle() const { return value->deadline_heap_handle(); }
+  };
+
+  // Returns the TaskDeadline of the front task of |work_queue|, which must
+  // have one it can run.
+  static TaskDeadline GetFrontTaskDeadline(const WorkQueue* work_queue);
+
+  // Keep |deadline_heaps_| in step with |work_queue_heaps_|. No-ops unless
+  // |earliest_deadline_first_|.
+  void InsertIntoDeadlineHeap(WorkQueue* work_queue, size_t set_index);
+  void EraseFromDeadlineHeap(WorkQueue* work_queue, size_t set_index);
+  void UpdateDeadlineHeap(WorkQueue* work_queue, size_t set_index);
+
   const char* const name_;
 
   // For each set |work_queue_heaps_| has a queue of WorkQueue ordered by the
@@ -132,6 +185,14 @@ class CREVENT_EXPORT WorkQueueSets {
              TaskQueue::kQueuePriorityCount>
       work_queue_heaps_;
 
+  const bool earliest_deadline_first_;
+
+  // For each set, the same WorkQueues as |work_queue_heaps_| ordered by the
+  // deadline of their oldest task, if |earliest_deadline_first_|.
+  std::array<cr::internal::IntrusiveHeap<EarliestTaskDeadline>,
+             TaskQueue::kQueuePriorityCount>
+      deadline_heaps_;
+
 #if CR_DCHECK_IS_ON()
   static inline uint64_t MurmurHash3(uint64_t value) {
     value ^= value >> 33;
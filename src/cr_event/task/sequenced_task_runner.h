@@ -71,6 +71,9 @@ namespace cr {
 //
 //   - Tasks posted via PostTask are run in FIFO order.
 //
+//   - Tasks posted via PostTasks are run in the order of the batch, and
+//     in FIFO order with the tasks posted via PostTask.
+//
 //   - Tasks posted via PostNonNestableTask are run in FIFO order.
 //
 //   - Tasks posted with the same delay and the same nestable state
@@ -0,0 +1,73 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cr_event/task/task_chain.h"
+
+namespace cr {
+namespace internal {
+
+constexpr size_t TaskChainState::kInlineResultSize;
+
+TaskChainState::TaskChainState(const Location& from_here)
+    : from_here_(from_here) {}
+
+TaskChainState::~TaskChainState() {
+  DestroyResult();
+}
+
+void TaskChainState::AddStep(RefPtr<SequencedTaskRunner> task_runner,
+                             OnceCallback<void(TaskChainState*)> step) {
+  CR_DCHECK(!next_step_);
+  steps_.push_back({std::move(task_runner), std::move(step)});
+}
+
+// static
+bool TaskChainState::Start(std::unique_ptr<TaskChainState> state) {
+  // A chain without steps has nothing to post.
+  if (state->steps_.empty())
+    return false;
+  return PostNextStep(std::move(state));
+}
+
+// static
+void TaskChainState::RunSteps(std::unique_ptr<TaskChainState> state) {
+  do {
+    if (state->IsCancelled())
+      return;
+    Step& step = state->steps_[state->next_step_++];
+    std::move(step.run).Run(state.get());
+    // Released here rather than wherever the chain ends.
+    step.task_runner = nullptr;
+  } while (state->next_step_ < state->steps_.size() &&
+           state->steps_[state->next_step_]
+               .task_runner->RunsTasksInCurrentSequence());
+
+  if (state->next_step_ < state->steps_.size())
+    PostNextStep(std::move(state));
+}
+
+// static
+bool TaskChainState::PostNextStep(std::unique_ptr<TaskChainState> state) {
+  // Keep a pointer to the TaskRunner and a copy of the Location before
+  // |state| is moved into the callback.
+  SequencedTaskRunner* task_runner =
+      state->steps_[state->next_step_].task_runner.get();
+  const Location from_here = state->from_here_;
+  return task_runner->PostTask(
+      from_here, BindOnce(&TaskChainState::RunSteps, std::move(state)));
+}
+
+bool TaskChainState::IsCancelled() const {
+  return is_valid_ && !is_valid_.Run();
+}
+
+void TaskChainState::DestroyResult() {
+  if (!result_)
+    return;
+  destroy_result_(result_);
+  result_ = nullptr;
+}
+
+}  // namespace internal
+}  // namespace cr
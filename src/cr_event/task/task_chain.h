@@ -0,0 +1,249 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MINI_CHROMIUM_SRC_CREVENT_TASK_TASK_CHAIN_H_
+#define MINI_CHROMIUM_SRC_CREVENT_TASK_TASK_CHAIN_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "cr_base/functional/bind.h"
+#include "cr_base/functional/callback.h"
+#include "cr_base/location.h"
+#include "cr_base/logging/logging.h"
+#include "cr_base/memory/ref_counted.h"
+#include "cr_base/memory/weak_ptr.h"
+
+#include "cr_event/event_export.h"
+#include "cr_event/task/sequenced_task_runner.h"
+#include "cr_event/task/sequenced_task_runner_handle.h"
+
+namespace cr {
+
+namespace internal {
+
+// The state of a TaskChain, which is handed from sequence to sequence as it
+// runs, so that a hop costs a PostTask() and nothing more.
+class CREVENT_EXPORT TaskChainState {
+ public:
+  // Results up to this size are stored inline.
+  static constexpr size_t kInlineResultSize = 4 * sizeof(void*);
+
+  explicit TaskChainState(const Location& from_here);
+  TaskChainState(const TaskChainState&) = delete;
+  TaskChainState& operator=(const TaskChainState&) = delete;
+  ~TaskChainState();
+
+  void AddStep(RefPtr<SequencedTaskRunner> task_runner,
+               OnceCallback<void(TaskChainState*)> step);
+
+  void set_is_valid(RepeatingCallback<bool()> is_valid) {
+    is_valid_ = std::move(is_valid);
+  }
+
+  // Posts the first step. Returns false if there is none.
+  static bool Start(std::unique_ptr<TaskChainState> state);
+
+  template <typename T>
+  void SetResult(T&& value) {
+    using Result = std::decay_t<T>;
+    CR_DCHECK(!result_);
+    if (sizeof(Result) <= kInlineResultSize &&
+        alignof(Result) <= alignof(InlineResult)) {
+      result_ = new (&inline_result_) Result(std::forward<T>(value));
+      destroy_result_ = &DestroyInlineResult<Result>;
+    } else {
+      result_ = new Result(std::forward<T>(value));
+      destroy_result_ = &DeleteResult<Result>;
+    }
+  }
+
+  template <typename T>
+  T TakeResult() {
+    CR_DCHECK(result_);
+    T value = std::move(*static_cast<T*>(result_));
+    DestroyResult();
+    return value;
+  }
+
+ private:
+  using InlineResult =
+      std::aligned_storage_t<kInlineResultSize, alignof(void*) * 2>;
+
+  struct Step {
+    RefPtr<SequencedTaskRunner> task_runner;
+    OnceCallback<void(TaskChainState*)> run;
+  };
+
+  template <typename T>
+  static void DestroyInlineResult(void* result) {
+    static_cast<T*>(result)->~T();
+  }
+
+  template <typename T>
+  static void DeleteResult(void* result) {
+    delete static_cast<T*>(result);
+  }
+
+  // Runs the next step, and those following it on the same sequence, then
+  // posts the chain to the sequence of the step after.
+  static void RunSteps(std::unique_ptr<TaskChainState> state);
+  static bool PostNextStep(std::unique_ptr<TaskChainState> state);
+
+  bool IsCancelled() const;
+  void DestroyResult();
+
+  const Location from_here_;
+  std::vector<Step> steps_;
+  size_t next_step_ = 0;
+  RepeatingCallback<bool()> is_valid_;
+
+  InlineResult inline_result_;
+  void* result_ = nullptr;
+  void (*destroy_result_)(void*) = nullptr;
+};
+
+// Runs a step of a chain whose previous step returned a |T|, calling a
+// callback of type |Signature| with it, and keeps the result for the next.
+template <typename T, typename Signature>
+struct TaskChainStep;
+
+template <typename R>
+struct TaskChainStep<void, R()> {
+  using ReturnType = R;
+  static void Run(OnceCallback<R()> step, TaskChainState* state) {
+    state->SetResult(std::move(step).Run());
+  }
+};
+
+template <>
+struct TaskChainStep<void, void()> {
+  using ReturnType = void;
+  static void Run(OnceCallback<void()> step, TaskChainState* state) {
+    std::move(step).Run();
+  }
+};
+
+template <typename T, typename R, typename Arg>
+struct TaskChainStep<T, R(Arg)> {
+  using ReturnType = R;
+  static void Run(OnceCallback<R(Arg)> step, TaskChainState* state) {
+    state->SetResult(std::move(step).Run(state->TakeResult<T>()));
+  }
+};
+
+template <typename T, typename Arg>
+struct TaskChainStep<T, void(Arg)> {
+  using ReturnType = void;
+  static void Run(OnceCallback<void(Arg)> step, TaskChainState* state) {
+    std::move(step).Run(state->TakeResult<T>());
+  }
+};
+
+template <typename T>
+bool TaskChainMaybeValid(const WeakPtr<T>& weak_ptr) {
+  return weak_ptr.MaybeValid();
+}
+
+}  // namespace internal
+
+// Runs a sequence of steps one after the other, each on a SequencedTaskRunner
+// of its own, handing the result of a step to the next. This lets a request
+// which hops between sequences be written linearly, where it would otherwise
+// nest PostTaskAndReplyWithResult() calls:
+//
+//   TaskChain<>(CR_FROM_HERE)
+//       .Then(io_task_runner_, BindOnce(&ReadFile, path))
+//       .Then(worker_task_runner_, BindOnce(&ParseConfig))
+//       .Then(BindOnce(&ConfigLoader::OnConfigLoaded,
+//                      weak_factory_.GetWeakPtr()))
+//       .CancelWith(weak_factory_.GetWeakPtr())
+//       .Post();
+//
+// |T| is the type returned by the last step so far. A step without a task
+// runner runs on the sequence the chain was created on.
+//
+// The chain is a single allocation which moves from sequence to sequence,
+// with the result of the last step stored inline when small: a hop costs a
+// PostTask(), not a relay per hop as nested PostTaskAndReply() calls do.
+// Consecutive steps on the same sequence run in the same task.
+//
+// Once cancelled, through CancelWith(), or when a post fails during shutdown,
+// the steps left are not run, and the chain is destroyed on the sequence it
+// stopped on, along with the result it holds.
+template <typename T = void>
+class TaskChain {
+ public:
+  explicit TaskChain(const Location& from_here)
+      : state_(std::make_unique<internal::TaskChainState>(from_here)) {
+    if (SequencedTaskRunnerHandle::IsSet())
+      origin_task_runner_ = SequencedTaskRunnerHandle::Get();
+  }
+
+  TaskChain(TaskChain&&) = default;
+  TaskChain& operator=(TaskChain&&) = default;
+
+  // Adds a step running |step| on |task_runner|. |step| takes the result of
+  // the previous step, if it returned one.
+  template <typename Signature>
+  TaskChain<typename internal::TaskChainStep<T, Signature>::ReturnType> Then(
+      RefPtr<SequencedTaskRunner> task_runner,
+      OnceCallback<Signature> step) && {
+    CR_DCHECK(task_runner);
+    CR_DCHECK(step);
+    state_->AddStep(
+        std::move(task_runner),
+        BindOnce(&internal::TaskChainStep<T, Signature>::Run,
+                 std::move(step)));
+    return TaskChain<
+        typename internal::TaskChainStep<T, Signature>::ReturnType>(
+        std::move(state_), std::move(origin_task_runner_));
+  }
+
+  // Adds a step running |step| on the sequence the chain was created on.
+  template <typename Signature>
+  TaskChain<typename internal::TaskChainStep<T, Signature>::ReturnType> Then(
+      OnceCallback<Signature> step) && {
+    CR_DCHECK(origin_task_runner_);
+    RefPtr<SequencedTaskRunner> task_runner = origin_task_runner_;
+    return std::move(*this).Then(std::move(task_runner), std::move(step));
+  }
+
+  // Cancels the steps not run yet once |weak_ptr| is invalidated. A step
+  // which is a method bound to a WeakPtr is cancelled by it anyway; this
+  // also skips the steps, and hops, leading up to it.
+  template <typename U>
+  TaskChain CancelWith(WeakPtr<U> weak_ptr) && {
+    state_->set_is_valid(BindRepeating(&internal::TaskChainMaybeValid<U>,
+                                       std::move(weak_ptr)));
+    return std::move(*this);
+  }
+
+  // Posts the first step. Returns false if it couldn't be posted, or if the
+  // chain has no steps.
+  bool Post() && {
+    return internal::TaskChainState::Start(std::move(state_));
+  }
+
+ private:
+  template <typename U>
+  friend class TaskChain;
+
+  TaskChain(std::unique_ptr<internal::TaskChainState> state,
+            RefPtr<SequencedTaskRunner> origin_task_runner)
+      : state_(std::move(state)),
+        origin_task_runner_(std::move(origin_task_runner)) {}
+
+  std::unique_ptr<internal::TaskChainState> state_;
+  RefPtr<SequencedTaskRunner> origin_task_runner_;
+};
+
+}  // namespace cr
+
+#endif  // MINI_CHROMIUM_SRC_CREVENT_TASK_TASK_CHAIN_H_
@@ -5,6 +5,7 @@
 
 #include "cr_event/task/task_executor.h"
 
+#include <atomic>
 #include <type_traits>
 
 #include "cr_base/logging/logging.h"
@@ -33,6 +34,8 @@ static_assert(
     TaskTraitsExtensionStorage::kInvalidExtensionId == 0,
     "TaskExecutorMap depends on 0 being an invalid TaskTraits extension ID");
 
+std::atomic<TaskExecutor*> g_thread_pool_task_executor{nullptr};
+
 }  // namespace
 
 ThreadLocalPointer<TaskExecutor>* GetTLSForCurrentTaskExecutor() {
@@ -66,6 +69,12 @@ void UnregisterTaskExecutorForTesting(uint8_t extension_id) {
   (*GetTaskExecutorMap())[extension_id - 1] = nullptr;
 }
 
+void SetThreadPoolTaskExecutor(TaskExecutor* task_executor) {
+  CR_DCHECK(!task_executor ||
+            !g_thread_pool_task_executor.load(std::memory_order_relaxed));
+  g_thread_pool_task_executor.store(task_executor, std::memory_order_release);
+}
+
 TaskExecutor* GetRegisteredTaskExecutorForTraits(const TaskTraits& traits) {
   uint8_t extension_id = traits.extension_id();
   if (extension_id != TaskTraitsExtensionStorage::kInvalidExtensionId) {
@@ -77,7 +86,7 @@ TaskExecutor* GetRegisteredTaskExecutorForTraits(const TaskTraits& traits) {
     return executor;
   }
 
-  return nullptr;
+  return g_thread_pool_task_executor.load(std::memory_order_acquire);
 }
 
 }  // namespace cr
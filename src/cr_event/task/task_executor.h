@@ -6,6 +6,7 @@
 #ifndef MINI_CHROMIUM_SRC_CREVENT_TASK_TASK_EXECUTOR_H_
 #define MINI_CHROMIUM_SRC_CREVENT_TASK_TASK_EXECUTOR_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "cr_base/compiler_config.h"
@@ -16,11 +17,11 @@
 #include "cr_event/task/sequenced_task_runner.h"
 #include "cr_event/task/single_thread_task_runner.h"
 #include "cr_event/task/single_thread_task_runner_thread_mode.h"
+#include "cr_event/task/task_traits.h"
 
 namespace cr {
 
 class Location;
-class TaskTraits;
 
 // A TaskExecutor can execute Tasks with a specific TaskTraits extension id. To
 // handle Tasks posted via the //base/task/post_task.h API, the TaskExecutor
@@ -65,6 +66,19 @@ class CREVENT_EXPORT TaskExecutor {
       const TaskTraits& traits,
       SingleThreadTaskRunnerThreadMode thread_mode) = 0;
 #endif  // defined(MINI_CHROMIUM_OS_WIN)
+
+  // Returns true if work of a higher priority than |priority| is waiting for
+  // a thread, or if shutdown started, for long running work of |priority|
+  // such as a job's workers to yield. Can be called on any thread.
+  virtual bool ShouldYield(TaskPriority priority) { return false; }
+
+  // Returns how many tasks posted with |traits| can run concurrently as long
+  // as none of them blocks, e.g. to split work between that many tasks. Can
+  // be called on any thread.
+  virtual size_t GetMaxConcurrentNonBlockedTasks(
+      const TaskTraits& traits) const {
+    return 1;
+  }
 };
 
 // Register a TaskExecutor with the //base/task/post_task.h API in the current
@@ -84,6 +98,10 @@ CREVENT_EXPORT void SetTaskExecutorForCurrentThread(
 // Returns the task executor registered for the current thread.
 CREVENT_EXPORT TaskExecutor* GetTaskExecutorForCurrentThread();
 
+// Registers |task_executor|, typically a ThreadPool, for tasks posted with
+// TaskTraits which have no extension. Pass nullptr to unregister it.
+CREVENT_EXPORT void SetThreadPoolTaskExecutor(TaskExecutor* task_executor);
+
 // Determines whether a registered TaskExecutor will handle tasks with the given
 // |traits| and, if so, returns a pointer to it. Otherwise, returns |nullptr|.
 CREVENT_EXPORT TaskExecutor* GetRegisteredTaskExecutorForTraits(
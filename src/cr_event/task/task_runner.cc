@@ -47,6 +47,22 @@ bool TaskRunner::PostTask(const Location& from_here, OnceClosure task) {
   return PostDelayedTask(from_here, std::move(task), cr::TimeDelta());
 }
 
+bool TaskRunner::PostTasks(const Location& from_here,
+                           std::vector<OnceClosure> tasks) {
+  bool posted = true;
+  for (OnceClosure& task : tasks)
+    posted &= PostTask(from_here, std::move(task));
+  return posted;
+}
+
+bool TaskRunner::PostDelayedTaskWithLeeway(const Location& from_here,
+                                           OnceClosure task,
+                                           cr::TimeDelta delay,
+                                           cr::TimeDelta leeway,
+                                           DelayPolicy delay_policy) {
+  return PostDelayedTask(from_here, std::move(task), delay);
+}
+
 bool TaskRunner::PostTaskAndReply(const Location& from_here,
                                   OnceClosure task,
                                   OnceClosure reply) {
@@ -8,6 +8,8 @@
 
 #include <stddef.h>
 
+#include <vector>
+
 #include "cr_base/logging/logging.h"
 #include "cr_base/functional/bind.h"
 #include "cr_base/functional/callback.h"
@@ -16,6 +18,7 @@
 #include "cr_base/time/time.h"
 
 #include "cr_event/event_export.h"
+#include "cr_event/task/delay_policy.h"
 #include "cr_event/task/internal/post_task_and_reply_with_result_internal.h"
 
 namespace cr {
@@ -68,6 +71,15 @@ class CREVENT_EXPORT TaskRunner
   // Equivalent to PostDelayedTask(from_here, task, 0).
   bool PostTask(const Location& from_here, OnceClosure task);
 
+  // Posts |tasks| to be run, like as many PostTask() calls in a row. Returns
+  // true if the tasks may be run at some point in the future, and false if
+  // they definitely will not be run.
+  //
+  // Implementations may override this to post the whole batch at once, which
+  // is cheaper than posting the tasks one by one.
+  virtual bool PostTasks(const Location& from_here,
+                         std::vector<OnceClosure> tasks);
+
   // Like PostTask, but tries to run the posted task only after |delay_ms|
   // has passed. Implementations should use a tick clock, rather than wall-
   // clock time, to implement |delay|.
@@ -75,6 +87,16 @@ class CREVENT_EXPORT TaskRunner
                                OnceClosure task,
                                cr::TimeDelta delay) = 0;
 
+  // Like PostDelayedTask, but lets the posted task run within |leeway| of
+  // |delay|, as |delay_policy| says, so that it can share a wake-up with other
+  // tasks. Implementations which don't coalesce wake-ups run it after |delay|,
+  // which any |delay_policy| allows.
+  virtual bool PostDelayedTaskWithLeeway(const Location& from_here,
+                                         OnceClosure task,
+                                         cr::TimeDelta delay,
+                                         cr::TimeDelta leeway,
+                                         DelayPolicy delay_policy);
+
   // Posts |task| on the current TaskRunner.  On completion, |reply| is posted
   // to the sequence that called PostTaskAndReply().  On the success case,
   // |task| is destroyed on the target sequence and |reply| is destroyed on the
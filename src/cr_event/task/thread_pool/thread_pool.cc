@@ -0,0 +1,681 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cr_event/task/thread_pool/thread_pool.h"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+#include "cr_base/containers/optional.h"
+#include "cr_base/functional/bind.h"
+#include "cr_base/logging/logging.h"
+#include "cr_base/memory/no_destructor.h"
+#include "cr_base/threading/sequence/sequence_token.h"
+#include "cr_base/threading/thread_local.h"
+
+#include "cr_event/task/sequenced_task_runner_handle.h"
+#include "cr_event/threading/simple_thread.h"
+
+namespace cr {
+
+namespace {
+
+// A worker looks at the injection queues before its own deques once every so
+// many tasks, so that tasks posted from outside the pool can't be starved by
+// workers which keep posting tasks to themselves.
+constexpr uint32_t kInjectionQueueCheckPeriod = 61;
+
+size_t PriorityIndex(TaskPriority priority) {
+  return static_cast<size_t>(priority);
+}
+
+// The worker running the current thread, whatever its pool.
+ThreadLocalPointer<SimpleThread>* GetCurrentWorkerTLS() {
+  static NoDestructor<ThreadLocalPointer<SimpleThread>> instance;
+  return instance.get();
+}
+
+}  // namespace
+
+struct ThreadPool::Task {
+  Task() = default;
+  Task(const Location& posted_from, OnceClosure task, const TaskTraits& traits)
+      : posted_from(posted_from),
+        task(std::move(task)),
+        priority(traits.priority()),
+        shutdown_behavior(traits.shutdown_behavior()),
+        may_block(traits.may_block()) {}
+  Task(Task&& other) = default;
+  Task& operator=(Task&& other) = default;
+  ~Task() = default;
+
+  Location posted_from;
+  OnceClosure task;
+  TaskPriority priority = TaskPriority::USER_BLOCKING;
+  TaskShutdownBehavior shutdown_behavior =
+      TaskShutdownBehavior::SKIP_ON_SHUTDOWN;
+  bool may_block = false;
+
+  // Set for the tasks of a PooledSequencedTaskRunner, for
+  // SequencedTaskRunnerHandle::Get() to return it while they run.
+  RefPtr<SequencedTaskRunner> sequenced_task_runner;
+};
+
+// What the deques hold: either a task to run on its own, or a sequence whose
+// next task is to run.
+struct ThreadPool::Work {
+  Work() = default;
+  Work(Work&& other) = default;
+  Work& operator=(Work&& other) = default;
+  ~Work() = default;
+
+  TaskPriority priority = TaskPriority::USER_BLOCKING;
+  Task task;
+  RefPtr<Sequence> sequence;
+};
+
+// The tasks of a PooledSequencedTaskRunner. A sequence with tasks is always
+// either in one of the deques or run by a worker, never both, so that its
+// tasks run one at a time, in posting order.
+class ThreadPool::Sequence : public RefCountedThreadSafe<Sequence> {
+ public:
+  explicit Sequence(TaskPriority priority)
+      : priority_(priority), token_(SequenceToken::Create()) {}
+
+  Sequence(const Sequence&) = delete;
+  Sequence& operator=(const Sequence&) = delete;
+
+  TaskPriority priority() const { return priority_; }
+  const SequenceToken& token() const { return token_; }
+
+  // Adds `task`. Returns true if the sequence must be enqueued as it wasn't
+  // already.
+  bool PushTask(Task task) {
+    AutoLock auto_lock(lock_);
+    queue_.push_back(std::move(task));
+    if (scheduled_)
+      return false;
+    scheduled_ = true;
+    return true;
+  }
+
+  // Takes the next task to run.
+  Task TakeTask() {
+    AutoLock auto_lock(lock_);
+    CR_DCHECK(scheduled_);
+    CR_DCHECK(!queue_.empty());
+    Task task = std::move(queue_.front());
+    queue_.pop_front();
+    return task;
+  }
+
+  // Called once the task returned by TakeTask() is done with. Returns true if
+  // the sequence has more tasks and must be enqueued again.
+  bool DidRunTask() {
+    AutoLock auto_lock(lock_);
+    CR_DCHECK(scheduled_);
+    if (!queue_.empty())
+      return true;
+    scheduled_ = false;
+    return false;
+  }
+
+  // Deletes the tasks which haven't run. They may hold references to the
+  // runner which holds this sequence.
+  void ClearTasks() {
+    CircularDeque<Task> tasks;
+    {
+      AutoLock auto_lock(lock_);
+      tasks.swap(queue_);
+      scheduled_ = false;
+    }
+  }
+
+ private:
+  friend class RefCountedThreadSafe<Sequence>;
+
+  ~Sequence() = default;
+
+  const TaskPriority priority_;
+  const SequenceToken token_;
+
+  Lock lock_;
+  CircularDeque<Task> queue_;
+  bool scheduled_ = false;
+};
+
+class ThreadPool::PooledParallelTaskRunner : public TaskRunner {
+ public:
+  PooledParallelTaskRunner(ThreadPool* pool, const TaskTraits& traits)
+      : pool_(pool), traits_(traits) {}
+
+  PooledParallelTaskRunner(const PooledParallelTaskRunner&) = delete;
+  PooledParallelTaskRunner& operator=(const PooledParallelTaskRunner&) =
+      delete;
+
+  // TaskRunner:
+  bool PostDelayedTask(const Location& from_here,
+                       OnceClosure task,
+                       TimeDelta delay) override {
+    return pool_->PostTask(Task(from_here, std::move(task), traits_), nullptr,
+                           delay);
+  }
+
+ private:
+  ~PooledParallelTaskRunner() override = default;
+
+  ThreadPool* const pool_;
+  const TaskTraits traits_;
+};
+
+class ThreadPool::PooledSequencedTaskRunner : public SequencedTaskRunner {
+ public:
+  PooledSequencedTaskRunner(ThreadPool* pool, const TaskTraits& traits)
+      : pool_(pool),
+        traits_(traits),
+        sequence_(MakeRefCounted<Sequence>(traits.priority())) {}
+
+  PooledSequencedTaskRunner(const PooledSequencedTaskRunner&) = delete;
+  PooledSequencedTaskRunner& operator=(const PooledSequencedTaskRunner&) =
+      delete;
+
+  // SequencedTaskRunner:
+  bool PostDelayedTask(const Location& from_here,
+                       OnceClosure task,
+                       TimeDelta delay) override {
+    Task pool_task(from_here, std::move(task), traits_);
+    pool_task.sequenced_task_runner = this;
+    return pool_->PostTask(std::move(pool_task), sequence_, delay);
+  }
+
+  // Tasks never run nested in the pool.
+  bool PostNonNestableDelayedTask(const Location& from_here,
+                                  OnceClosure task,
+                                  TimeDelta delay) override {
+    return PostDelayedTask(from_here, std::move(task), delay);
+  }
+
+  bool RunsTasksInCurrentSequence() const override {
+    return sequence_->token() == SequenceToken::GetForCurrentThread();
+  }
+
+ private:
+  ~PooledSequencedTaskRunner() override = default;
+
+  ThreadPool* const pool_;
+  const TaskTraits traits_;
+  const RefPtr<Sequence> sequence_;
+};
+
+class ThreadPool::Worker : public SimpleThread {
+ public:
+  Worker(ThreadPool* pool, size_t index, const std::string& name)
+      : SimpleThread(name), pool_(pool), index_(index) {}
+
+  Worker(const Worker&) = delete;
+  Worker& operator=(const Worker&) = delete;
+
+  ~Worker() override = default;
+
+  ThreadPool* pool() const { return pool_; }
+  size_t index() const { return index_; }
+
+  // Number of GetWork() calls, for the worker's own use.
+  uint32_t num_get_work = 0;
+
+  void Push(Work work) {
+    const size_t priority = PriorityIndex(work.priority);
+    AutoLock auto_lock(lock_);
+    deques_[priority].push_back(std::move(work));
+    sizes_[priority].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Takes the oldest work of `priority`, for this worker. Taking the oldest
+  // one rather than the newest keeps a task which keeps posting to itself from
+  // starving the others.
+  bool Pop(size_t priority, Work* work) {
+    if (sizes_[priority].load(std::memory_order_relaxed) == 0)
+      return false;
+    AutoLock auto_lock(lock_);
+    if (deques_[priority].empty())
+      return false;
+    *work = std::move(deques_[priority].front());
+    deques_[priority].pop_front();
+    sizes_[priority].fetch_sub(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  bool HasWork(size_t priority) const {
+    return sizes_[priority].load(std::memory_order_relaxed) > 0;
+  }
+
+  // Takes the newest work of `priority`, for another worker.
+  bool Steal(size_t priority, Work* work) {
+    if (sizes_[priority].load(std::memory_order_relaxed) == 0)
+      return false;
+    AutoLock auto_lock(lock_);
+    if (deques_[priority].empty())
+      return false;
+    *work = std::move(deques_[priority].back());
+    deques_[priority].pop_back();
+    sizes_[priority].fetch_sub(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Deletes the work which hasn't run. Called once the worker has exited.
+  void ClearWork() {
+    for (auto& deque : deques_) {
+      for (Work& work : deque) {
+        if (work.sequence)
+          work.sequence->ClearTasks();
+      }
+      deque.clear();
+    }
+  }
+
+  // SimpleThread:
+  void Run() override {
+    GetCurrentWorkerTLS()->Set(this);
+    pool_->RunWorker(this);
+    GetCurrentWorkerTLS()->Set(nullptr);
+  }
+
+ private:
+  ThreadPool* const pool_;
+  const size_t index_;
+
+  Lock lock_;
+  CircularDeque<Work> deques_[kNumPriorities];
+
+  // Sizes of `deques_`, to skip the empty ones without taking `lock_`.
+  std::atomic<size_t> sizes_[kNumPriorities] = {};
+};
+
+ThreadPool::ThreadPool(const std::string& name)
+    : name_(name),
+      wake_up_cv_(&lock_),
+      shutdown_cv_(&lock_),
+      service_thread_(name + "Service") {}
+
+ThreadPool::~ThreadPool() {
+  CR_DCHECK(!started_ || state_.load() == State::kJoined);
+}
+
+void ThreadPool::Start(const InitParams& init_params) {
+  CR_DCHECK(!started_);
+  const size_t num_cores = std::max(std::thread::hardware_concurrency(), 1u);
+  max_num_workers_ = init_params.max_num_workers ? init_params.max_num_workers
+                                                 : num_cores;
+  max_num_blocking_workers_ = init_params.max_num_blocking_workers;
+  workers_.resize(max_num_workers_ + max_num_blocking_workers_);
+
+  CR_CHECK(service_thread_.Start());
+
+  AutoLock auto_lock(lock_);
+  started_ = true;
+  for (size_t i = 0; i < max_num_workers_; ++i)
+    AddWorkerLockRequired();
+}
+
+void ThreadPool::Shutdown() {
+  CR_DCHECK(!GetCurrentWorker());
+  AutoLock auto_lock(lock_);
+  CR_DCHECK(state_.load() == State::kRunning);
+  state_.store(State::kShuttingDown);
+  while (num_pending_block_shutdown_tasks_ > 0)
+    shutdown_cv_.Wait();
+  state_.store(State::kShutdown);
+}
+
+void ThreadPool::Join() {
+  CR_DCHECK(!GetCurrentWorker());
+  {
+    AutoLock auto_lock(lock_);
+    CR_DCHECK(state_.load() == State::kShutdown);
+    state_.store(State::kJoined);
+    wake_up_cv_.Broadcast();
+  }
+
+  // No worker is added past kShutdown, so `num_workers_` is final.
+  const size_t num_workers = num_workers_.load(std::memory_order_acquire);
+  for (size_t i = 0; i < num_workers; ++i)
+    workers_[i]->Join();
+
+  service_thread_.Stop();
+  if (shared_single_thread_)
+    shared_single_thread_->Stop();
+#if defined(MINI_CHROMIUM_OS_WIN)
+  if (shared_com_sta_thread_)
+    shared_com_sta_thread_->Stop();
+#endif
+  for (auto& thread : dedicated_single_threads_)
+    thread->Stop();
+
+  for (size_t i = 0; i < num_workers; ++i)
+    workers_[i]->ClearWork();
+  AutoLock auto_lock(lock_);
+  for (auto& queue : injection_queues_) {
+    for (Work& work : queue) {
+      if (work.sequence)
+        work.sequence->ClearTasks();
+    }
+    queue.clear();
+  }
+}
+
+size_t ThreadPool::GetNumWorkers() const {
+  return num_workers_.load(std::memory_order_acquire);
+}
+
+bool ThreadPool::PostDelayedTask(const Location& from_here,
+                                 const TaskTraits& traits,
+                                 OnceClosure task,
+                                 TimeDelta delay) {
+  return PostTask(Task(from_here, std::move(task), traits), nullptr, delay);
+}
+
+RefPtr<TaskRunner> ThreadPool::CreateTaskRunner(const TaskTraits& traits) {
+  return MakeRefCounted<PooledParallelTaskRunner>(this, traits);
+}
+
+RefPtr<SequencedTaskRunner> ThreadPool::CreateSequencedTaskRunner(
+    const TaskTraits& traits) {
+  return MakeRefCounted<PooledSequencedTaskRunner>(this, traits);
+}
+
+RefPtr<SingleThreadTaskRunner> ThreadPool::CreateSingleThreadTaskRunner(
+    const TaskTraits& traits,
+    SingleThreadTaskRunnerThreadMode thread_mode) {
+  AutoLock auto_lock(lock_);
+  CR_DCHECK(state_.load() != State::kJoined);
+  if (thread_mode == SingleThreadTaskRunnerThreadMode::SHARED) {
+    if (!shared_single_thread_) {
+      shared_single_thread_ =
+          std::make_unique<Thread>(name_ + "SharedSingleThread");
+      CR_CHECK(shared_single_thread_->Start());
+    }
+    return shared_single_thread_->task_runner();
+  }
+  dedicated_single_threads_.push_back(std::make_unique<Thread>(
+      name_ + "SingleThread" +
+      std::to_string(dedicated_single_threads_.size())));
+  CR_CHECK(dedicated_single_threads_.back()->Start());
+  return dedicated_single_threads_.back()->task_runner();
+}
+
+#if defined(MINI_CHROMIUM_OS_WIN)
+RefPtr<SingleThreadTaskRunner> ThreadPool::CreateCOMSTATaskRunner(
+    const TaskTraits& traits,
+    SingleThreadTaskRunnerThreadMode thread_mode) {
+  AutoLock auto_lock(lock_);
+  CR_DCHECK(state_.load() != State::kJoined);
+  if (thread_mode == SingleThreadTaskRunnerThreadMode::SHARED) {
+    if (!shared_com_sta_thread_) {
+      shared_com_sta_thread_ =
+          std::make_unique<Thread>(name_ + "SharedCOMSTAThread");
+      shared_com_sta_thread_->init_com_with_mta(false);
+      CR_CHECK(shared_com_sta_thread_->Start());
+    }
+    return shared_com_sta_thread_->task_runner();
+  }
+  dedicated_single_threads_.push_back(std::make_unique<Thread>(
+      name_ + "COMSTAThread" +
+      std::to_string(dedicated_single_threads_.size())));
+  dedicated_single_threads_.back()->init_com_with_mta(false);
+  CR_CHECK(dedicated_single_threads_.back()->Start());
+  return dedicated_single_threads_.back()->task_runner();
+}
+#endif  // defined(MINI_CHROMIUM_OS_WIN)
+
+bool ThreadPool::ShouldYield(TaskPriority priority) {
+  if (state_.load(std::memory_order_relaxed) != State::kRunning)
+    return true;
+  if (num_queued_work_.load(std::memory_order_relaxed) == 0)
+    return false;
+  const size_t num_workers = num_workers_.load(std::memory_order_acquire);
+  for (size_t higher_priority = PriorityIndex(priority) + 1;
+       higher_priority < kNumPriorities; ++higher_priority) {
+    if (num_injected_work_[higher_priority].load(std::memory_order_relaxed))
+      return true;
+    for (size_t i = 0; i < num_workers; ++i) {
+      if (workers_[i]->HasWork(higher_priority))
+        return true;
+    }
+  }
+  return false;
+}
+
+size_t ThreadPool::GetMaxConcurrentNonBlockedTasks(
+    const TaskTraits& traits) const {
+  // Set by Start(), before any task could be posted.
+  return max_num_workers_;
+}
+
+ThreadPool::Worker* ThreadPool::GetCurrentWorker() const {
+  Worker* worker = static_cast<Worker*>(GetCurrentWorkerTLS()->Get());
+  return worker && worker->pool() == this ? worker : nullptr;
+}
+
+bool ThreadPool::PostTask(Task task,
+                          RefPtr<Sequence> sequence,
+                          TimeDelta delay) {
+  CR_DCHECK(started_);
+  const bool delayed = delay > TimeDelta();
+  // Delayed tasks never block shutdown (see the top of the header).
+  if (delayed &&
+      task.shutdown_behavior == TaskShutdownBehavior::BLOCK_SHUTDOWN) {
+    task.shutdown_behavior = TaskShutdownBehavior::SKIP_ON_SHUTDOWN;
+  }
+  if (!BeforePostTask(task.shutdown_behavior))
+    return false;
+
+  if (delayed) {
+    const Location posted_from = task.posted_from;
+    return service_thread_.task_runner()->PostDelayedTask(
+        posted_from,
+        BindOnce(&ThreadPool::PostTaskNow, Unretained(this), std::move(task),
+                 std::move(sequence)),
+        delay);
+  }
+  PostTaskNow(std::move(task), std::move(sequence));
+  return true;
+}
+
+void ThreadPool::PostTaskNow(Task task, RefPtr<Sequence> sequence) {
+  Work work;
+  work.priority = task.priority;
+  if (sequence) {
+    if (!sequence->PushTask(std::move(task)))
+      return;  // The sequence is already enqueued or running.
+    work.sequence = std::move(sequence);
+  } else {
+    work.task = std::move(task);
+  }
+  Enqueue(std::move(work));
+}
+
+void ThreadPool::Enqueue(Work work) {
+  // Counted before the work is published, so that a worker which takes it
+  // never decrements the count below zero. A worker may find the count ahead
+  // of the work for a moment, and looks for it again.
+  //
+  // Pairs with WaitForWork(), which increments `num_sleeping_workers_` before
+  // it reads `num_queued_work_`: either WakeUpOneWorker() sees the sleeping
+  // worker, or the worker sees the work.
+  num_queued_work_.fetch_add(1);
+  Worker* worker = GetCurrentWorker();
+  if (worker) {
+    worker->Push(std::move(work));
+  } else {
+    const size_t priority = PriorityIndex(work.priority);
+    AutoLock auto_lock(lock_);
+    injection_queues_[priority].push_back(std::move(work));
+    num_injected_work_[priority].fetch_add(1, std::memory_order_relaxed);
+  }
+  WakeUpOneWorker();
+}
+
+void ThreadPool::WakeUpOneWorker() {
+  if (num_sleeping_workers_.load() > 0) {
+    AutoLock auto_lock(lock_);
+    wake_up_cv_.Signal();
+    return;
+  }
+  if (num_running_may_block_tasks_.load(std::memory_order_relaxed) > 0) {
+    // All workers are busy, and some of them may be blocked.
+    AutoLock auto_lock(lock_);
+    MaybeAddWorkerLockRequired();
+  }
+}
+
+void ThreadPool::MaybeAddWorkerLockRequired() {
+  if (!started_ || state_.load() >= State::kShutdown)
+    return;
+  const size_t capacity =
+      max_num_workers_ +
+      std::min(num_running_may_block_tasks_.load(std::memory_order_relaxed),
+               max_num_blocking_workers_);
+  if (num_workers_.load(std::memory_order_relaxed) < capacity &&
+      num_sleeping_workers_.load() == 0 && num_queued_work_.load() > 0) {
+    AddWorkerLockRequired();
+  }
+}
+
+void ThreadPool::AddWorkerLockRequired() {
+  const size_t index = num_workers_.load(std::memory_order_relaxed);
+  CR_DCHECK(index < workers_.size());
+  workers_[index] = std::make_unique<Worker>(
+      this, index, name_ + "Worker" + std::to_string(index));
+  Worker* worker = workers_[index].get();
+  num_workers_.store(index + 1, std::memory_order_release);
+  worker->StartAsync();
+}
+
+bool ThreadPool::BeforePostTask(TaskShutdownBehavior shutdown_behavior) {
+  if (shutdown_behavior == TaskShutdownBehavior::BLOCK_SHUTDOWN) {
+    AutoLock auto_lock(lock_);
+    if (state_.load() >= State::kShutdown)
+      return false;
+    ++num_pending_block_shutdown_tasks_;
+    return true;
+  }
+  return state_.load(std::memory_order_relaxed) == State::kRunning;
+}
+
+bool ThreadPool::BeforeRunTask(TaskShutdownBehavior shutdown_behavior) {
+  if (shutdown_behavior == TaskShutdownBehavior::BLOCK_SHUTDOWN)
+    return true;
+  return state_.load(std::memory_order_relaxed) == State::kRunning;
+}
+
+void ThreadPool::AfterRunTask(TaskShutdownBehavior shutdown_behavior) {
+  if (shutdown_behavior != TaskShutdownBehavior::BLOCK_SHUTDOWN)
+    return;
+  AutoLock auto_lock(lock_);
+  CR_DCHECK(num_pending_block_shutdown_tasks_ > 0);
+  if (--num_pending_block_shutdown_tasks_ == 0 &&
+      state_.load() == State::kShuttingDown) {
+    shutdown_cv_.Signal();
+  }
+}
+
+void ThreadPool::RunWorker(Worker* worker) {
+  while (state_.load(std::memory_order_relaxed) != State::kJoined) {
+    Work work;
+    if (GetWork(worker, &work)) {
+      RunWork(std::move(work));
+    } else if (!WaitForWork()) {
+      break;
+    }
+  }
+}
+
+bool ThreadPool::GetWork(Worker* worker, Work* work) {
+  if (num_queued_work_.load() == 0)
+    return false;
+  const bool injection_first =
+      ++worker->num_get_work % kInjectionQueueCheckPeriod == 0;
+  for (size_t priority = kNumPriorities; priority-- > 0;) {
+    if ((injection_first && TakeInjectedWork(priority, work)) ||
+        worker->Pop(priority, work) || TakeInjectedWork(priority, work) ||
+        StealWork(worker, priority, work)) {
+      num_queued_work_.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ThreadPool::TakeInjectedWork(size_t priority, Work* work) {
+  if (num_injected_work_[priority].load(std::memory_order_relaxed) == 0)
+    return false;
+  AutoLock auto_lock(lock_);
+  CircularDeque<Work>& queue = injection_queues_[priority];
+  if (queue.empty())
+    return false;
+  *work = std::move(queue.front());
+  queue.pop_front();
+  num_injected_work_[priority].fetch_sub(1, std::memory_order_relaxed);
+  return true;
+}
+
+bool ThreadPool::StealWork(Worker* thief, size_t priority, Work* work) {
+  const size_t num_workers = num_workers_.load(std::memory_order_acquire);
+  // Start right after the thief so that thieves spread over the victims.
+  for (size_t i = 1; i < num_workers; ++i) {
+    Worker* victim = workers_[(thief->index() + i) % num_workers].get();
+    if (victim->Steal(priority, work))
+      return true;
+  }
+  return false;
+}
+
+bool ThreadPool::WaitForWork() {
+  AutoLock auto_lock(lock_);
+  num_sleeping_workers_.fetch_add(1);
+  while (num_queued_work_.load() == 0 && state_.load() != State::kJoined)
+    wake_up_cv_.Wait();
+  num_sleeping_workers_.fetch_sub(1);
+  return state_.load() != State::kJoined;
+}
+
+void ThreadPool::RunWork(Work work) {
+  {
+    Task task =
+        work.sequence ? work.sequence->TakeTask() : std::move(work.task);
+    if (BeforeRunTask(task.shutdown_behavior)) {
+      if (task.may_block) {
+        num_running_may_block_tasks_.fetch_add(1, std::memory_order_relaxed);
+        if (num_queued_work_.load() > 0) {
+          AutoLock auto_lock(lock_);
+          MaybeAddWorkerLockRequired();
+        }
+      }
+
+      {
+        ScopedSetSequenceTokenForCurrentThread scoped_sequence_token(
+            work.sequence ? work.sequence->token() : SequenceToken::Create());
+        Optional<SequencedTaskRunnerHandle> sequenced_task_runner_handle;
+        if (task.sequenced_task_runner)
+          sequenced_task_runner_handle.emplace(task.sequenced_task_runner);
+        std::move(task.task).Run();
+      }
+
+      if (task.may_block)
+        num_running_may_block_tasks_.fetch_sub(1, std::memory_order_relaxed);
+      AfterRunTask(task.shutdown_behavior);
+    }
+    // `task` is deleted here, before the next task of its sequence may run.
+  }
+
+  if (work.sequence && work.sequence->DidRunTask()) {
+    Work next_work;
+    next_work.priority = work.sequence->priority();
+    next_work.sequence = std::move(work.sequence);
+    Enqueue(std::move(next_work));
+  }
+}
+
+}  // namespace cr
@@ -0,0 +1,224 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MINI_CHROMIUM_SRC_CREVENT_TASK_THREAD_POOL_THREAD_POOL_H_
+#define MINI_CHROMIUM_SRC_CREVENT_TASK_THREAD_POOL_THREAD_POOL_H_
+
+#include <stddef.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cr_base/compiler_config.h"
+
+#include "cr_base/containers/circular_deque.h"
+#include "cr_base/synchronization/condition_variable.h"
+#include "cr_base/synchronization/lock.h"
+#include "cr_base/time/time.h"
+
+#include "cr_event/event_export.h"
+#include "cr_event/task/task_executor.h"
+#include "cr_event/task/task_traits.h"
+#include "cr_event/threading/thread.h"
+
+namespace cr {
+
+// A pool of worker threads running tasks posted with TaskTraits, for work
+// which doesn't need a particular thread, e.g. CPU-heavy work which mustn't
+// delay the events of an IO thread.
+//
+// Each worker owns one deque per TaskPriority. Tasks posted from a worker go
+// to its own deques; tasks posted from other threads go to a shared injection
+// queue. A worker out of work steals from the deques of the others. Higher
+// priority work is looked for in all of these places before lower priority
+// work is.
+//
+// A task with the MayBlock() trait may leave its worker blocked in the kernel.
+// While such tasks run and work is waiting, the pool starts extra workers (up
+// to InitParams::max_num_blocking_workers) so that other tasks keep running.
+// Extra workers stay in the pool until Join().
+//
+// Shutdown() honors TaskShutdownBehavior. Delayed tasks are held by a service
+// thread until they're ripe and, as with ThreadPool in Chrome, they're skipped
+// on shutdown whatever their shutdown behavior. ThreadPolicy is ignored: all
+// workers run at normal priority.
+//
+// Typical use:
+//
+//   ThreadPool pool("Worker");
+//   pool.Start(ThreadPool::InitParams());
+//   SetThreadPoolTaskExecutor(&pool);
+//   ...
+//   RefPtr<SequencedTaskRunner> task_runner = pool.CreateSequencedTaskRunner(
+//       {TaskPriority::BEST_EFFORT, MayBlock()});
+//   task_runner->PostTask(CR_FROM_HERE, BindOnce(&WriteFile, ...));
+//   ...
+//   SetThreadPoolTaskExecutor(nullptr);
+//   pool.Shutdown();
+//   pool.Join();
+//
+// Task runners created by the pool must not be used after Join().
+class CREVENT_EXPORT ThreadPool : public TaskExecutor {
+ public:
+  struct CREVENT_EXPORT InitParams {
+    // Number of workers started by Start(). 0 starts one per core.
+    size_t max_num_workers = 0;
+
+    // Number of extra workers which may be started while MayBlock() tasks
+    // run.
+    size_t max_num_blocking_workers = 16;
+  };
+
+  // `name` prefixes the names of the pool's threads.
+  explicit ThreadPool(const std::string& name);
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Join() must have been called if Start() was.
+  ~ThreadPool() override;
+
+  // Starts the pool's threads. Must be called before any task is posted.
+  void Start(const InitParams& init_params);
+
+  // Waits until all BLOCK_SHUTDOWN tasks posted so far have run. Meanwhile
+  // only BLOCK_SHUTDOWN tasks are accepted and run; afterwards no task is.
+  // SKIP_ON_SHUTDOWN and CONTINUE_ON_SHUTDOWN tasks which haven't started are
+  // dropped. Must not be called from a task running in the pool.
+  void Shutdown();
+
+  // Waits for the tasks still running, e.g. CONTINUE_ON_SHUTDOWN ones, and
+  // joins all threads of the pool. Tasks which haven't run are deleted.
+  void Join();
+
+  // Number of workers started so far, including the extra ones started for
+  // MayBlock() tasks.
+  size_t GetNumWorkers() const;
+
+  // TaskExecutor:
+  bool PostDelayedTask(const Location& from_here,
+                       const TaskTraits& traits,
+                       OnceClosure task,
+                       TimeDelta delay) override;
+  RefPtr<TaskRunner> CreateTaskRunner(const TaskTraits& traits) override;
+  RefPtr<SequencedTaskRunner> CreateSequencedTaskRunner(
+      const TaskTraits& traits) override;
+  // Runs the tasks on a thread of its own rather than on a worker, shared by
+  // all runners created with SingleThreadTaskRunnerThreadMode::SHARED. These
+  // threads run until Join(), whatever the shutdown behavior of their tasks.
+  RefPtr<SingleThreadTaskRunner> CreateSingleThreadTaskRunner(
+      const TaskTraits& traits,
+      SingleThreadTaskRunnerThreadMode thread_mode) override;
+#if defined(MINI_CHROMIUM_OS_WIN)
+  // Same as CreateSingleThreadTaskRunner(), on threads which initialize COM in
+  // a single-threaded apartment, hence run a UI message pump.
+  RefPtr<SingleThreadTaskRunner> CreateCOMSTATaskRunner(
+      const TaskTraits& traits,
+      SingleThreadTaskRunnerThreadMode thread_mode) override;
+#endif  // defined(MINI_CHROMIUM_OS_WIN)
+  bool ShouldYield(TaskPriority priority) override;
+  // The workers started by Start(), without the extra ones for MayBlock()
+  // tasks.
+  size_t GetMaxConcurrentNonBlockedTasks(
+      const TaskTraits& traits) const override;
+
+ private:
+  class Worker;
+  class Sequence;
+  class PooledParallelTaskRunner;
+  class PooledSequencedTaskRunner;
+  struct Task;
+  struct Work;
+
+  static constexpr size_t kNumPriorities =
+      static_cast<size_t>(TaskPriority::HIGHEST) + 1;
+
+  enum class State {
+    kRunning,
+    kShuttingDown,
+    kShutdown,
+    kJoined,
+  };
+
+  // Returns the worker of this pool running the current thread, if any.
+  Worker* GetCurrentWorker() const;
+
+  // Posts `task` to run on its own, or as the next task of `sequence` if not
+  // null.
+  bool PostTask(Task task, RefPtr<Sequence> sequence, TimeDelta delay);
+  void PostTaskNow(Task task, RefPtr<Sequence> sequence);
+
+  // Adds `work` to the deques of the current worker if it belongs to this
+  // pool, to the injection queue otherwise, and makes sure a worker picks it
+  // up.
+  void Enqueue(Work work);
+  void WakeUpOneWorker();
+
+  // Must be called with `lock_` held.
+  void MaybeAddWorkerLockRequired();
+  void AddWorkerLockRequired();
+
+  // Shutdown bookkeeping around posting and running a task.
+  bool BeforePostTask(TaskShutdownBehavior shutdown_behavior);
+  bool BeforeRunTask(TaskShutdownBehavior shutdown_behavior);
+  void AfterRunTask(TaskShutdownBehavior shutdown_behavior);
+
+  // The worker loop and its steps.
+  void RunWorker(Worker* worker);
+  bool GetWork(Worker* worker, Work* work);
+  bool TakeInjectedWork(size_t priority, Work* work);
+  bool StealWork(Worker* thief, size_t priority, Work* work);
+  bool WaitForWork();
+  void RunWork(Work work);
+
+  const std::string name_;
+
+  size_t max_num_workers_ = 0;
+  size_t max_num_blocking_workers_ = 0;
+
+  // Sized for the maximum number of workers by Start(), so that it never
+  // reallocates; the first `num_workers_` elements are set. Thieves read it
+  // without holding `lock_`.
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<size_t> num_workers_{0};
+
+  // Protects the members below it, and the creation of workers.
+  mutable Lock lock_;
+
+  // Workers out of work sleep on this.
+  ConditionVariable wake_up_cv_;
+
+  // Shutdown() waits on this for BLOCK_SHUTDOWN tasks to run.
+  ConditionVariable shutdown_cv_;
+
+  // Work posted from threads which aren't workers of this pool, by priority.
+  CircularDeque<Work> injection_queues_[kNumPriorities];
+
+  std::atomic<State> state_{State::kRunning};
+  bool started_ = false;
+  size_t num_pending_block_shutdown_tasks_ = 0;
+
+  // Work enqueued anywhere and not taken yet, to let workers sleep when
+  // there's none.
+  std::atomic<size_t> num_queued_work_{0};
+  std::atomic<size_t> num_injected_work_[kNumPriorities] = {};
+  std::atomic<size_t> num_sleeping_workers_{0};
+  std::atomic<size_t> num_running_may_block_tasks_{0};
+
+  // Holds delayed tasks until they're ripe.
+  Thread service_thread_;
+
+  // Threads running single-thread task runners.
+  std::unique_ptr<Thread> shared_single_thread_;
+#if defined(MINI_CHROMIUM_OS_WIN)
+  std::unique_ptr<Thread> shared_com_sta_thread_;
+#endif
+  std::vector<std::unique_ptr<Thread>> dedicated_single_threads_;
+};
+
+}  // namespace cr
+
+#endif  // MINI_CHROMIUM_SRC_CREVENT_TASK_THREAD_POOL_THREAD_POOL_H_
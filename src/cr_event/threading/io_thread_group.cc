@@ -0,0 +1,209 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cr_event/threading/io_thread_group.h"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+#include "cr_base/compiler_config.h"
+
+#include "cr_base/functional/bind.h"
+#include "cr_base/logging/logging.h"
+
+#if defined(MINI_CHROMIUM_OS_LINUX)
+#include <sched.h>
+#elif defined(MINI_CHROMIUM_OS_WIN)
+#include <windows.h>
+#endif
+
+namespace cr {
+
+namespace {
+
+void PinCurrentThreadToCore(size_t core) {
+#if defined(MINI_CHROMIUM_OS_LINUX)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(core, &cpu_set);
+  if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0)
+    CR_DPLOG(Error) << "sched_setaffinity";
+#elif defined(MINI_CHROMIUM_OS_WIN)
+  if (core >= sizeof(DWORD_PTR) * 8)
+    return;
+  if (!::SetThreadAffinityMask(::GetCurrentThread(), DWORD_PTR{1} << core))
+    CR_DPLOG(Error) << "SetThreadAffinityMask";
+#endif
+}
+
+void RunWithReactorIndex(const RepeatingCallback<void(size_t)>& task,
+                         size_t index) {
+  task.Run(index);
+}
+
+class HashPolicy : public IOThreadGroup::AssignmentPolicy {
+ public:
+  size_t SelectReactor(const IOThreadGroup& group, uint64_t key) override {
+    // Mix the bits of `key` first, so that keys which only differ in their
+    // high bits, or share a stride with the number of reactors, still spread.
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdull;
+    key ^= key >> 33;
+    return static_cast<size_t>(key % group.size());
+  }
+};
+
+class LeastLoadedPolicy : public IOThreadGroup::AssignmentPolicy {
+ public:
+  size_t SelectReactor(const IOThreadGroup& group, uint64_t key) override {
+    // Loads may change concurrently; an approximate answer is good enough.
+    size_t best = 0;
+    size_t best_load = group.GetLoad(0);
+    for (size_t i = 1; i < group.size() && best_load > 0; ++i) {
+      const size_t load = group.GetLoad(i);
+      if (load < best_load) {
+        best = i;
+        best_load = load;
+      }
+    }
+    return best;
+  }
+};
+
+class ReusePortPolicy : public LeastLoadedPolicy {
+ public:
+  size_t SelectReactor(const IOThreadGroup& group, uint64_t key) override {
+    const size_t current = group.GetCurrentReactorIndex();
+    if (current < group.size())
+      return current;
+    return LeastLoadedPolicy::SelectReactor(group, key);
+  }
+};
+
+}  // namespace
+
+struct IOThreadGroup::Reactor {
+  explicit Reactor(const std::string& name) : thread(name) {}
+
+  Thread thread;
+  std::atomic<size_t> load{0};
+};
+
+// static
+std::unique_ptr<IOThreadGroup::AssignmentPolicy>
+IOThreadGroup::CreateHashPolicy() {
+  return std::make_unique<HashPolicy>();
+}
+
+// static
+std::unique_ptr<IOThreadGroup::AssignmentPolicy>
+IOThreadGroup::CreateLeastLoadedPolicy() {
+  return std::make_unique<LeastLoadedPolicy>();
+}
+
+// static
+std::unique_ptr<IOThreadGroup::AssignmentPolicy>
+IOThreadGroup::CreateReusePortPolicy() {
+  return std::make_unique<ReusePortPolicy>();
+}
+
+IOThreadGroup::Options::Options() {
+  thread_options.message_pump_type = MessagePumpType::IO;
+}
+
+IOThreadGroup::Options::Options(Options&& other) = default;
+
+IOThreadGroup::Options::~Options() = default;
+
+IOThreadGroup::IOThreadGroup(const std::string& name) : name_(name) {}
+
+IOThreadGroup::~IOThreadGroup() {
+  Stop();
+}
+
+bool IOThreadGroup::Start(Options options) {
+  CR_DCHECK_CALLED_ON_VALID_SEQUENCE(owning_sequence_checker_);
+  CR_DCHECK(reactors_.empty());
+  CR_DCHECK(!options.thread_options.delegate);
+
+  const size_t num_cores = std::max(std::thread::hardware_concurrency(), 1u);
+  const size_t num_reactors =
+      options.num_reactors ? options.num_reactors : num_cores;
+
+  assignment_policy_ = options.assignment_policy
+                           ? std::move(options.assignment_policy)
+                           : CreateLeastLoadedPolicy();
+
+  reactors_.reserve(num_reactors);
+  for (size_t i = 0; i < num_reactors; ++i) {
+    reactors_.push_back(
+        std::make_unique<Reactor>(name_ + "Reactor" + std::to_string(i)));
+    Thread& thread = reactors_.back()->thread;
+    if (!thread.StartWithOptions(options.thread_options)) {
+      Stop();
+      return false;
+    }
+    if (options.pin_to_cores) {
+      // Pinning from the reactor itself, before it runs anything else, avoids
+      // needing a platform thread handle.
+      thread.task_runner()->PostTask(
+          CR_FROM_HERE, BindOnce(&PinCurrentThreadToCore,
+                                 (options.first_core + i) % num_cores));
+    }
+  }
+  return true;
+}
+
+void IOThreadGroup::Stop() {
+  CR_DCHECK_CALLED_ON_VALID_SEQUENCE(owning_sequence_checker_);
+  for (auto& reactor : reactors_)
+    reactor->thread.Stop();
+  reactors_.clear();
+  assignment_policy_.reset();
+}
+
+RefPtr<SingleThreadTaskRunner> IOThreadGroup::task_runner(size_t index) const {
+  CR_DCHECK(index < reactors_.size());
+  return reactors_[index]->thread.task_runner();
+}
+
+size_t IOThreadGroup::GetCurrentReactorIndex() const {
+  for (size_t i = 0; i < reactors_.size(); ++i) {
+    if (reactors_[i]->thread.task_runner()->BelongsToCurrentThread())
+      return i;
+  }
+  return reactors_.size();
+}
+
+size_t IOThreadGroup::AssignReactor(uint64_t key) {
+  CR_DCHECK(!reactors_.empty());
+  const size_t index = assignment_policy_->SelectReactor(*this, key);
+  CR_DCHECK(index < reactors_.size());
+  reactors_[index]->load.fetch_add(1, std::memory_order_relaxed);
+  return index;
+}
+
+void IOThreadGroup::ReleaseReactor(size_t index) {
+  CR_DCHECK(index < reactors_.size());
+  const size_t previous_load =
+      reactors_[index]->load.fetch_sub(1, std::memory_order_relaxed);
+  CR_DCHECK(previous_load > 0);
+}
+
+size_t IOThreadGroup::GetLoad(size_t index) const {
+  CR_DCHECK(index < reactors_.size());
+  return reactors_[index]->load.load(std::memory_order_relaxed);
+}
+
+void IOThreadGroup::PostTaskToEachReactor(
+    const Location& from_here,
+    RepeatingCallback<void(size_t)> task) {
+  for (size_t i = 0; i < reactors_.size(); ++i) {
+    reactors_[i]->thread.task_runner()->PostTask(
+        from_here, BindOnce(&RunWithReactorIndex, task, i));
+  }
+}
+
+}  // namespace cr
@@ -0,0 +1,157 @@
+// Copyright 2026 Ninja2ha. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MINI_CHROMIUM_SRC_CREVENT_THREADING_IO_THREAD_GROUP_H_
+#define MINI_CHROMIUM_SRC_CREVENT_THREADING_IO_THREAD_GROUP_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cr_base/functional/callback.h"
+#include "cr_base/location.h"
+#include "cr_base/memory/ref_ptr.h"
+#include "cr_base/threading/sequence/sequence_checker.h"
+
+#include "cr_event/event_export.h"
+#include "cr_event/task/single_thread_task_runner.h"
+#include "cr_event/threading/thread.h"
+
+namespace cr {
+
+// A group of IO threads ("reactors") started and stopped as a unit, among
+// which watched descriptors or connections are spread by a pluggable policy.
+// Each reactor has its own MessagePumpForIO and may be pinned to a core.
+//
+// Typical use:
+//
+//   IOThreadGroup group("NetworkIO");
+//   IOThreadGroup::Options options;
+//   options.pin_to_cores = true;
+//   group.Start(std::move(options));
+//
+//   // For each accepted connection:
+//   size_t reactor = group.AssignReactor(fd);
+//   group.task_runner(reactor)->PostTask(
+//       CR_FROM_HERE, BindOnce(&Connection::Start, ...));
+//   ...
+//   // Once the connection is closed:
+//   group.ReleaseReactor(reactor);
+//
+// With SO_REUSEPORT, each reactor can instead own a listening socket bound to
+// the same address (see PostTaskToEachReactor()), the kernel spreads incoming
+// connections among them and CreateReusePortPolicy() keeps each connection on
+// the reactor which accepted it.
+//
+// Start() and Stop() must be called on the owning sequence. The other methods
+// are thread-safe once Start() has returned and until Stop() is called.
+class CREVENT_EXPORT IOThreadGroup {
+ public:
+  // Decides which reactor gets a new descriptor or connection. Called on any
+  // thread, so implementations must be thread-safe.
+  class CREVENT_EXPORT AssignmentPolicy {
+   public:
+    virtual ~AssignmentPolicy() = default;
+
+    // Returns the index of the reactor of `group` which should own the
+    // descriptor or connection identified by `key` (typically its fd).
+    virtual size_t SelectReactor(const IOThreadGroup& group, uint64_t key) = 0;
+  };
+
+  // Spreads keys evenly by hashing them, so a given key always maps to the
+  // same reactor.
+  static std::unique_ptr<AssignmentPolicy> CreateHashPolicy();
+
+  // Picks the reactor with the fewest descriptors or connections assigned and
+  // not yet released.
+  static std::unique_ptr<AssignmentPolicy> CreateLeastLoadedPolicy();
+
+  // Picks the calling reactor when called on one of the group's threads, e.g.
+  // by the per-reactor SO_REUSEPORT listener which accepted a connection, and
+  // the least loaded reactor otherwise.
+  static std::unique_ptr<AssignmentPolicy> CreateReusePortPolicy();
+
+  struct CREVENT_EXPORT Options {
+    Options();
+    Options(Options&& other);
+    ~Options();
+
+    // Number of reactors. 0 starts one per core.
+    size_t num_reactors = 0;
+
+    // If true, reactor `i` is pinned to core `(first_core + i) % num_cores`.
+    // Only supported on Linux and Windows; ignored elsewhere.
+    bool pin_to_cores = false;
+    size_t first_core = 0;
+
+    // Defaults to CreateLeastLoadedPolicy().
+    std::unique_ptr<AssignmentPolicy> assignment_policy;
+
+    // Used to start each reactor. The message pump type defaults to
+    // MessagePumpType::IO. `delegate` must be null.
+    Thread::Options thread_options;
+  };
+
+  // `name` prefixes the names of the reactor threads.
+  explicit IOThreadGroup(const std::string& name);
+
+  IOThreadGroup(const IOThreadGroup&) = delete;
+  IOThreadGroup& operator=(const IOThreadGroup&) = delete;
+
+  // Stops the reactors if necessary.
+  ~IOThreadGroup();
+
+  // Starts all reactors. Returns false, with none of them running, if one of
+  // them failed to start.
+  bool Start(Options options);
+
+  // Stops all reactors, running their pending tasks first. The group may be
+  // started again afterwards.
+  void Stop();
+
+  // Returns the number of reactors, 0 if the group isn't running.
+  size_t size() const { return reactors_.size(); }
+
+  // Returns the task runner of reactor `index`, on which its descriptors must
+  // be watched.
+  RefPtr<SingleThreadTaskRunner> task_runner(size_t index) const;
+
+  // Returns the index of the reactor running the current thread, or size() if
+  // the current thread isn't one of the group's.
+  size_t GetCurrentReactorIndex() const;
+
+  // Picks a reactor for the descriptor or connection identified by `key`
+  // according to the assignment policy, and counts it in the reactor's load
+  // until the matching ReleaseReactor() call.
+  size_t AssignReactor(uint64_t key);
+  void ReleaseReactor(size_t index);
+
+  // Returns the number of descriptors or connections assigned to reactor
+  // `index` and not yet released.
+  size_t GetLoad(size_t index) const;
+
+  // Posts `task` to every reactor with that reactor's index, e.g. to create
+  // a SO_REUSEPORT listener on each of them.
+  void PostTaskToEachReactor(const Location& from_here,
+                             RepeatingCallback<void(size_t)> task);
+
+ private:
+  struct Reactor;
+
+  const std::string name_;
+
+  std::unique_ptr<AssignmentPolicy> assignment_policy_;
+
+  std::vector<std::unique_ptr<Reactor>> reactors_;
+
+  CR_SEQUENCE_CHECKER(owning_sequence_checker_);
+};
+
+}  // namespace cr
+
+#endif  // MINI_CHROMIUM_SRC_CREVENT_THREADING_IO_THREAD_GROUP_H_
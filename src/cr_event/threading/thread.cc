@@ -21,6 +21,7 @@
 #include "cr_base/threading/thread_local.h"
 
 #include "cr_event/message_pump/message_pump.h"
+#include "cr_event/message_pump/message_pump_default.h"
 #include "cr_event/run_loop.h"
 #include "cr_event/task/current_thread.h"
 #include "cr_event/task/sequence_manager/sequence_manager_impl.h"
@@ -33,6 +34,10 @@
 #include "cr_base/posix/file_descriptor_watcher_posix.h"
 #endif
 
+#if defined(MINI_CHROMIUM_OS_LINUX)
+#include "cr_event/message_pump/posix/message_pump_epoll.h"
+#endif
+
 #if defined(MINI_CHROMIUM_OS_WIN)
 #include "cr_base/win/com/scoped_com_initializer.h"
 #endif
@@ -50,6 +55,51 @@ cr::ThreadLocalBoolean* GetLazyTls() {
   return tls.get();
 }
 
+// Tuning of message pumps, copied out of Thread::Options so that it can be
+// bound to the message pump factory.
+struct MessagePumpSettings {
+  TimeDelta spin_budget;
+
+  // Only used by IO message pumps.
+  bool high_resolution_timers = false;
+  size_t max_event_batch_size = 0;
+  size_t native_work_budget = 0;
+  size_t poll_threshold = 0;
+};
+
+MessagePumpSettings GetMessagePumpSettings(const Thread::Options& options) {
+  MessagePumpSettings settings;
+  settings.spin_budget = options.message_pump_spin_budget;
+#if defined(MINI_CHROMIUM_OS_LINUX)
+  settings.high_resolution_timers = options.io_high_resolution_timers;
+  settings.max_event_batch_size = options.io_max_event_batch_size;
+  settings.native_work_budget = options.io_native_work_budget;
+  settings.poll_threshold = options.io_poll_threshold;
+#endif
+  return settings;
+}
+
+std::unique_ptr<MessagePump> CreateMessagePump(
+    MessagePumpType type,
+    const MessagePumpSettings& settings) {
+  std::unique_ptr<MessagePump> pump = MessagePump::Create(type);
+  if (type == MessagePumpType::DEFAULT) {
+    static_cast<MessagePumpDefault*>(pump.get())
+        ->SetSpinBudget(settings.spin_budget);
+  }
+#if defined(MINI_CHROMIUM_OS_LINUX)
+  if (type == MessagePumpType::IO || type == MessagePumpType::IO_URING) {
+    auto* io_pump = static_cast<MessagePumpEpoll*>(pump.get());
+    io_pump->SetSpinBudget(settings.spin_budget);
+    io_pump->SetHighResolutionTimers(settings.high_resolution_timers);
+    io_pump->SetEventBatchLimits(settings.max_event_batch_size,
+                                 settings.native_work_budget);
+    io_pump->SetPollThreshold(settings.poll_threshold);
+  }
+#endif
+  return pump;
+}
+
 class SequenceManagerThreadDelegate : public Thread::Delegate {
  public:
   explicit SequenceManagerThreadDelegate(
@@ -96,6 +146,10 @@ class SequenceManagerThreadDelegate : public Thread::Delegate {
     simple_task_executor_.emplace(GetDefaultTaskRunner());
   }
 
+  bool GetMessagePumpMetrics(MessagePumpMetrics* metrics) const override {
+    return sequence_manager_->GetMessagePumpMetrics(metrics);
+  }
+
  private:
   std::unique_ptr<sequence_manager::internal::SequenceManagerImpl>
       sequence_manager_;
@@ -174,8 +228,8 @@ bool Thread::StartWithOptions(const Options& options) {
   } else {
     delegate_ = std::make_unique<SequenceManagerThreadDelegate>(
         options.message_pump_type,
-        BindOnce([](MessagePumpType type) { return MessagePump::Create(type); },
-                 options.message_pump_type),
+        BindOnce(&CreateMessagePump, options.message_pump_type,
+                 GetMessagePumpSettings(options)),
         options.task_queue_time_domain);
   }
 
@@ -283,6 +337,13 @@ void Thread::DetachFromSequence() {
   owning_sequence_checker_.DetachFromSequence();
 }
 
+bool Thread::GetMessagePumpMetrics(MessagePumpMetrics* metrics) const {
+  // |delegate_| is set and reset by the owning sequence and the thread.
+  CR_DCHECK(owning_sequence_checker_.CalledOnValidSequence() ||
+            (id_event_.IsSignaled() && id_ == PlatformThread::CurrentId()));
+  return delegate_ && delegate_->GetMessagePumpMetrics(metrics);
+}
+
 PlatformThreadId Thread::GetThreadId() const {
   if (!id_event_.IsSignaled()) {
     // If the thread is created but not started yet, wait for |id_| being ready.
@@ -18,6 +18,7 @@
 #include "cr_base/synchronization/lock.h"
 #include "cr_base/synchronization/waitable_event.h"
 #include "cr_base/threading/platform_thread.h"
+#include "cr_base/time/time.h"
 
 #include "cr_event/event_export.h"
 #include "cr_event/task/single_thread_task_runner.h"
@@ -28,6 +29,7 @@ namespace cr {
 
 class MessagePump;
 class RunLoop;
+struct MessagePumpMetrics;
 
 namespace sequence_manager {
 class TimeDomain;
@@ -73,6 +75,11 @@ class CRBASE_EXPORT Thread : PlatformThread::Delegate {
     // underlying MessagePump will have its |timer_slack| set to the specified
     // amount.
     virtual void BindToCurrentThread(TimerSlack timer_slack) = 0;
+
+    // See Thread::GetMessagePumpMetrics(). Can be called on any thread.
+    virtual bool GetMessagePumpMetrics(MessagePumpMetrics* metrics) const {
+      return false;
+    }
   };
 
   struct CRBASE_EXPORT Options {
@@ -85,7 +92,9 @@ class CRBASE_EXPORT Thread : PlatformThread::Delegate {
     ~Options();
 
     // Specifies the type of message pump that will be allocated on the thread.
-    // This is ignored if message_pump_factory.is_null() is false.
+    // This is ignored if message_pump_factory.is_null() is false. On Linux,
+    // MessagePumpType::IO_URING gives an IO thread whose pump waits through
+    // io_uring, or through epoll if the kernel doesn't support it.
     MessagePumpType message_pump_type = MessagePumpType::DEFAULT;
 
     // An unbound Delegate that will be bound to the thread. Ownership
@@ -96,6 +105,12 @@ class CRBASE_EXPORT Thread : PlatformThread::Delegate {
     // Specifies timer slack for thread message loop.
     TimerSlack timer_slack = TIMER_SLACK_NONE;
 
+    // Only used by DEFAULT and, on Linux, IO message pumps. When out of work,
+    // the thread busy-polls for up to this long before sleeping, so that tasks
+    // posted from other threads meanwhile run without a kernel wake-up. Burns
+    // CPU; zero disables it. See MessagePumpWakeState.
+    TimeDelta message_pump_spin_budget;
+
     // The time domain to be used by the task queue. This is not compatible with
     // a non-null |delegate|.
     sequence_manager::TimeDomain* task_queue_time_domain = nullptr;
@@ -107,6 +122,26 @@ class CRBASE_EXPORT Thread : PlatformThread::Delegate {
     // |delegate|.
     MessagePumpFactory message_pump_factory;
 
+#if defined(MINI_CHROMIUM_OS_LINUX)
+    // Only used by IO message pumps (MessagePumpType::IO and IO_URING). Wakes
+    // up for delayed tasks with sub-millisecond precision rather than rounding
+    // waits up to whole milliseconds. See
+    // MessagePumpEpoll::SetHighResolutionTimers().
+    bool io_high_resolution_timers = false;
+
+    // Only used by IO message pumps. Upper bound of the adaptive number of
+    // events collected per epoll_wait(), and number of events dispatched in a
+    // row before yielding to application tasks. See
+    // MessagePumpEpoll::SetEventBatchLimits().
+    size_t io_max_event_batch_size = 16;
+    size_t io_native_work_budget = 16;
+
+    // Only used by IO message pumps. Largest number of watched descriptors for
+    // which waits use poll() rather than epoll_wait(); 0 always uses epoll.
+    // See MessagePumpEpoll::SetPollThreshold().
+    size_t io_poll_threshold = 32;
+#endif  // defined(MINI_CHROMIUM_OS_LINUX)
+
     // Specifies the maximum stack size that the thread is allowed to use.
     // This does not necessarily correspond to the thread's initial stack size.
     // A value of 0 indicates that the default maximum should be used.
@@ -242,6 +277,13 @@ class CRBASE_EXPORT Thread : PlatformThread::Delegate {
     return delegate_ ? delegate_->GetDefaultTaskRunner() : nullptr;
   }
 
+  // Fills |metrics| with the event loop metrics of the thread's MessagePump,
+  // see MessagePump::GetMetrics(). Returns false if the thread is not running,
+  // its pump isn't bound yet or doesn't record metrics, or its Delegate
+  // doesn't expose them. Must be called on the owning sequence, or on the
+  // thread itself.
+  bool GetMessagePumpMetrics(MessagePumpMetrics* metrics) const;
+
   // Returns the name of this thread (for display in debugger too).
   const std::string& thread_name() const { return name_; }
 